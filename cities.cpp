@@ -4,6 +4,8 @@
 #include <string>
 #include <algorithm>
 #include <vector>
+#include <iterator>
+#include <utility>
 #include <ostream>
 
 #include <esr/hashtable.hpp>
@@ -51,6 +53,13 @@ struct hkey {
       area(ct.area),
       state(ct.state)
   {}
+  explicit hkey(city && ct) :
+      name(std::move(ct.name)),
+      is_capital(ct.is_capital),
+      year(ct.year),
+      area(ct.area),
+      state(std::move(ct.state))
+  {}
   bool operator==(const hkey &other) const {
     if (name == other.name &&
         is_capital == other.is_capital &&
@@ -80,15 +89,9 @@ namespace esr {
 // Custom hash function
 template <>
 class hash_function<city::hkey> :
-      public esr::hasher<city::hkey> {
+      public esr::hasher<city::hkey, hash_function<city::hkey>> {
  public:
-  explicit hash_function(size_t cardinality = 1,
-                         size_t start = 17,
-                         size_t prime = 31) :
-      esr::hasher<city::hkey>(cardinality),
-      m_bool_hasher(cardinality),
-      m_int_hasher(cardinality),
-      m_string_hasher(cardinality),
+  explicit hash_function(size_t start = 17, size_t prime = 31) :
       m_start(start),
       m_prime(prime) {
     // std::cout << __ESR_PRETTY_FUNCTION__ << '\n';
@@ -111,21 +114,48 @@ class hash_function<city::hkey> :
   esr::hash_function<std::string> m_string_hasher;
 };
 
-}  // namespace esr
+// Composite key is long to hash and to compare, nodes cache it's code
+template <>
+struct cache_hash_code<city::hkey> : std::true_type {};
 
-int main(int argc, char *argv[]) {
-  if (argc < 2) {
-    std::cerr << "Usage " << argv[0] << " ./data/cities.data\n";
-    return -ret::invalid_args;
+// Custom serializer, fields in order of declaration
+template <>
+class serializer<city::hkey> {
+ public:
+  void write(std::ostream& os, const city::hkey& key) const {
+    m_string_serializer.write(os, key.name);
+    m_bool_serializer.write(os, key.is_capital);
+    m_year_serializer.write(os, key.year);
+    m_area_serializer.write(os, key.area);
+    m_string_serializer.write(os, key.state);
   }
 
-  std::ifstream file(argv[1]);
+  void read(std::istream& is, city::hkey* key) const {
+    m_string_serializer.read(is, &key->name);
+    m_bool_serializer.read(is, &key->is_capital);
+    m_year_serializer.read(is, &key->year);
+    m_area_serializer.read(is, &key->area);
+    m_string_serializer.read(is, &key->state);
+  }
+ private:
+  esr::serializer<std::string> m_string_serializer;
+  esr::serializer<bool> m_bool_serializer;
+  esr::serializer<uint16_t> m_year_serializer;
+  esr::serializer<uint32_t> m_area_serializer;
+};
+
+}  // namespace esr
+
+// Parses data file to population table
+int read_data(const char* path,
+              esr::Hashtable<city::hkey, uint32_t>* population_table) {
+  std::ifstream file(path);
   if (!file.is_open()) {
-    std::cerr << "error: Couldn't open file \"" << argv[1] << "\"\n";
+    std::cerr << "error: Couldn't open file \"" << path << "\"\n";
     return -ret::file_error;
   }
 
-  esr::Hashtable<city::hkey, uint32_t> population_table;
+  std::vector<std::pair<city::hkey, uint32_t>> rows;
 
   std::cout << "Data: " << std::flush;
 
@@ -143,34 +173,68 @@ int main(int argc, char *argv[]) {
                                           c == '\r');
                                 }),
                  word.end());
-      line.push_back(word);
+      line.push_back(std::move(word));
     }
     if (line.size() == kWordsInLineOfDataFile) {
       city::city city;
-      city.name = line[0];
+      city.name = std::move(line[0]);
       city.is_capital = std::stoul(line[1]);
       city.year = std::stoul(line[2]);
       city.population = std::stoul(line[3]);
       city.area = std::stoul(line[4]);
-      city.state = line[5];
-      city::hkey key(city);
-      population_table.add(key, city.population);
+      city.state = std::move(line[5]);
+      uint32_t population = city.population;
+      rows.push_back(std::make_pair(city::hkey(std::move(city)), population));
     }
   }
   file.close();
 
+  population_table->assign_bulk(std::make_move_iterator(rows.begin()),
+                                std::make_move_iterator(rows.end()));
+  return ret::success;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage " << argv[0]
+              << " ./data/cities.data [./cities.snapshot]\n";
+    return -ret::invalid_args;
+  }
+
+  // Snapshot, if any, is loaded instead of parsing data file, otherwise
+  // it's saved for the next run
+  esr::Hashtable<city::hkey, uint32_t> population_table;
+  std::ifstream snapshot;
+  if (argc > 2)
+    snapshot.open(argv[2], std::ios::binary);
+  try {
+    if (snapshot.is_open()) {
+      std::cout << "Snapshot: " << std::flush;
+      population_table.load(snapshot);
+    } else {
+      int result = read_data(argv[1], &population_table);
+      if (result != ret::success)
+        return result;
+      if (argc > 2) {
+        std::ofstream saved(argv[2], std::ios::binary);
+        population_table.save(saved);
+      }
+    }
+  } catch (const esr::exception::table_file& e) {
+    std::cerr << "error: " << e.what() << " \"" << argv[2] << "\"\n";
+    return -ret::file_error;
+  }
+
   std::cout << population_table.size() << " entries\n";
   std::cout << "\n";
 
   std::cout << "Population by years: " << std::flush;
+  auto sum = [](uint64_t total, uint64_t population) {
+    return total + population;
+  };
   esr::Hashtable<int, uint64_t> year_table;
-  for (auto& city : population_table) {
-    auto found = year_table.find(city.key().year);
-    if (found == year_table.end())
-      year_table.add(city.key().year, city.value());
-    else
-      found->value() += city.value();
-  }
+  for (auto& city : population_table)
+    year_table.upsert(city.key().year, city.value(), sum);
   std::cout << year_table.size() << " entries \n";
   for (auto& year : year_table)
     std::cout << " " << year.value()  << " inhabitants in"
@@ -184,14 +248,9 @@ int main(int argc, char *argv[]) {
   std::cout << ") : ";
 
   esr::Hashtable<bool, uint64_t> statuses_table;
-  for (auto& city : population_table) {
-    auto found = statuses_table.find(city.key().is_capital);
-    if (found == statuses_table.end())
-      statuses_table.add(city.key().is_capital,
-                         city.value() / year_table.size());
-    else
-      found->value() += city.value() / year_table.size();
-  }
+  for (auto& city : population_table)
+    statuses_table.upsert(city.key().is_capital,
+                          city.value() / year_table.size(), sum);
   std::cout << statuses_table.size() << " entries \n";
   for (auto& status : statuses_table)
     std::cout << " " << status.value()  << " inhabitants in "
@@ -204,13 +263,9 @@ int main(int argc, char *argv[]) {
   std::cout << ") : ";
 
   esr::Hashtable<std::string, uint64_t> states_table;
-  for (auto& city : population_table) {
-    auto found = states_table.find(city.key().state);
-    if (found == states_table.end())
-      states_table.add(city.key().state, city.value() / year_table.size());
-    else
-      found->value() += city.value() / year_table.size();
-  }
+  for (auto& city : population_table)
+    states_table.upsert(city.key().state,
+                        city.value() / year_table.size(), sum);
   std::cout << states_table.size() << " entries \n";
   for (auto& state : states_table)
     std::cout << " " << state.value()  << " inhabitants in "
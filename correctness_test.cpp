@@ -13,6 +13,12 @@
 
 #include <esr/hashtest.hpp>
 #include <esr/hashtable.hpp>
+#include <esr/concurrenthashtable.hpp>
+#include <esr/epochhashtable.hpp>
+#include <esr/shardedhashtable.hpp>
+#include <esr/flathashtable.hpp>
+#include <esr/swisshashtable.hpp>
+#include <esr/compacthashtable.hpp>
 
 
 using std::shared_ptr;
@@ -20,16 +26,19 @@ using std::shared_ptr;
 namespace esr_test {
 
 template <>
-bool InsertionRetrievalTest<int, int>::make_expected_hashtable() {
+bool make_expected_tables<int, int>(
+    int input_size,
+    std::unordered_map<int, int>* positive_table,
+    std::unordered_map<int, int>* negative_table) {
   int key, value;
-  int up = 2*intput_size();
+  int up = 2*input_size;
   for (key = 0, value = up; key < up; ++key, --value) {
     auto key_value = std::make_pair(key, value);
     bool success = false;
     if (key % 2 == 0)
-      success = m_positive_table.insert(key_value).second;
+      success = positive_table->insert(key_value).second;
     else
-      success = m_negative_table.insert(key_value).second;
+      success = negative_table->insert(key_value).second;
     if (!success) {
       std::cout << __ESR_PRETTY_FUNCTION__ << ' '
                 << "failed to insert key = " << key << ", "
@@ -42,7 +51,10 @@ bool InsertionRetrievalTest<int, int>::make_expected_hashtable() {
 }
 
 template <>
-bool InsertionRetrievalTest<std::string, int>::make_expected_hashtable() {
+bool make_expected_tables<std::string, int>(
+    int input_size,
+    std::unordered_map<std::string, int>* positive_table,
+    std::unordered_map<std::string, int>* negative_table) {
   // unique_strings.txt: generated by random.org at https://www.random.org/strings
   std::ifstream file("./data/unique_strings.txt");
   if (!file.is_open()) {
@@ -56,9 +68,9 @@ bool InsertionRetrievalTest<std::string, int>::make_expected_hashtable() {
     auto key_value = std::make_pair(key, value);
     bool success = false;
     if (value % 2 == 0)
-      success = m_positive_table.insert(key_value).second;
+      success = positive_table->insert(key_value).second;
     else
-      success = m_negative_table.insert(key_value).second;
+      success = negative_table->insert(key_value).second;
 
     if (!success) {
       std::cout << __ESR_PRETTY_FUNCTION__ << ' '
@@ -74,7 +86,10 @@ bool InsertionRetrievalTest<std::string, int>::make_expected_hashtable() {
 }
 
 template <>
-bool InsertionRetrievalTest<int, std::string>::make_expected_hashtable() {
+bool make_expected_tables<int, std::string>(
+    int input_size,
+    std::unordered_map<int, std::string>* positive_table,
+    std::unordered_map<int, std::string>* negative_table) {
   // unique_strings.txt: generated by random.org at https://www.random.org/strings
   std::ifstream file("./data/unique_strings.txt");
 
@@ -89,9 +104,9 @@ bool InsertionRetrievalTest<int, std::string>::make_expected_hashtable() {
     auto key_value = std::make_pair(key, value);
     bool success = false;
     if (key % 2 == 0)
-      success = m_positive_table.insert(key_value).second;
+      success = positive_table->insert(key_value).second;
     else
-      success = m_negative_table.insert(key_value).second;
+      success = negative_table->insert(key_value).second;
 
     if (!success) {
       std::cout << __ESR_PRETTY_FUNCTION__ << ' '
@@ -107,8 +122,10 @@ bool InsertionRetrievalTest<int, std::string>::make_expected_hashtable() {
 }
 
 template <>
-bool InsertionRetrievalTest<std::string,
-                            std::string>:: make_expected_hashtable() {
+bool make_expected_tables<std::string, std::string>(
+    int input_size,
+    std::unordered_map<std::string, std::string>* positive_table,
+    std::unordered_map<std::string, std::string>* negative_table) {
   // unique_strings.txt: generated by random.org at https://www.random.org/strings
 
   std::ifstream file("./data/unique_strings.txt");
@@ -125,9 +142,9 @@ bool InsertionRetrievalTest<std::string,
     auto key_value = std::make_pair(key, value);
     bool success = false;
     if (i % 2 == 0)
-      success = m_positive_table.insert(key_value).second;
+      success = positive_table->insert(key_value).second;
     else
-      success = m_negative_table.insert(key_value).second;
+      success = negative_table->insert(key_value).second;
 
     if (!success) {
       std::cout << __ESR_PRETTY_FUNCTION__ << ' '
@@ -143,7 +160,10 @@ bool InsertionRetrievalTest<std::string,
 }
 
 template <>
-bool InsertionRetrievalTest<bool, int>::make_expected_hashtable() {
+bool make_expected_tables<bool, int>(
+    int input_size,
+    std::unordered_map<bool, int>* positive_table,
+    std::unordered_map<bool, int>* negative_table) {
   bool key_positive = true;
   bool key_negative = false;
   int value_positive = 8;
@@ -152,7 +172,7 @@ bool InsertionRetrievalTest<bool, int>::make_expected_hashtable() {
   auto key_value_positive = std::make_pair(key_positive, value_positive);
   auto key_value_negative = std::make_pair(key_negative, value_negative);
 
-  bool success_positive = m_positive_table.insert(key_value_positive).second;
+  bool success_positive = positive_table->insert(key_value_positive).second;
   if (!success_positive) {
         std::cout << __ESR_PRETTY_FUNCTION__ << ' '
                   << "failed to insert key = " << key_positive << ", "
@@ -161,7 +181,7 @@ bool InsertionRetrievalTest<bool, int>::make_expected_hashtable() {
         return false;
   }
 
-  bool success_negative = m_negative_table.insert(key_value_negative).second;
+  bool success_negative = negative_table->insert(key_value_negative).second;
   if (!success_negative) {
         std::cout << __ESR_PRETTY_FUNCTION__ << ' '
                   << "failed to insert key = " << key_negative << ", "
@@ -173,17 +193,20 @@ bool InsertionRetrievalTest<bool, int>::make_expected_hashtable() {
 }
 
 template <>
-bool InsertionRetrievalTest<int, bool>::make_expected_hashtable() {
+bool make_expected_tables<int, bool>(
+    int input_size,
+    std::unordered_map<int, bool>* positive_table,
+    std::unordered_map<int, bool>* negative_table) {
   int key;
   bool value;
-  int up = 2*intput_size();
+  int up = 2*input_size;
   for (key = 0, value = false; key < up; ++key, value = !value) {
     auto key_value = std::make_pair(key, value);
     bool success = false;
     if (key % 2 == 0)
-      success = m_positive_table.insert(key_value).second;
+      success = positive_table->insert(key_value).second;
     else
-      success = m_negative_table.insert(key_value).second;
+      success = negative_table->insert(key_value).second;
     if (!success) {
       std::cout << __ESR_PRETTY_FUNCTION__ << ' '
                 << "failed to insert key = " << key << ", "
@@ -196,7 +219,10 @@ bool InsertionRetrievalTest<int, bool>::make_expected_hashtable() {
 }
 
 template <>
-bool InsertionRetrievalTest<bool, std::string>::make_expected_hashtable() {
+bool make_expected_tables<bool, std::string>(
+    int input_size,
+    std::unordered_map<bool, std::string>* positive_table,
+    std::unordered_map<bool, std::string>* negative_table) {
   bool key_positive = true;
   bool key_negative = false;
   std::string value_positive = "love";
@@ -205,7 +231,7 @@ bool InsertionRetrievalTest<bool, std::string>::make_expected_hashtable() {
   auto key_value_positive = std::make_pair(key_positive, value_positive);
   auto key_value_negative = std::make_pair(key_negative, value_negative);
 
-  bool success_positive = m_positive_table.insert(key_value_positive).second;
+  bool success_positive = positive_table->insert(key_value_positive).second;
   if (!success_positive) {
         std::cout << __ESR_PRETTY_FUNCTION__ << ' '
                   << "failed to insert key = " << key_positive << ", "
@@ -214,7 +240,7 @@ bool InsertionRetrievalTest<bool, std::string>::make_expected_hashtable() {
         return false;
   }
 
-  bool success_negative = m_negative_table.insert(key_value_negative).second;
+  bool success_negative = negative_table->insert(key_value_negative).second;
   if (!success_negative) {
         std::cout << __ESR_PRETTY_FUNCTION__ << ' '
                   << "failed to insert key = " << key_negative << ", "
@@ -226,7 +252,10 @@ bool InsertionRetrievalTest<bool, std::string>::make_expected_hashtable() {
 }
 
 template <>
-bool InsertionRetrievalTest<std::string, bool>::make_expected_hashtable() {
+bool make_expected_tables<std::string, bool>(
+    int input_size,
+    std::unordered_map<std::string, bool>* positive_table,
+    std::unordered_map<std::string, bool>* negative_table) {
   // unique_strings.txt: generated by random.org at https://www.random.org/strings
   std::ifstream file("./data/unique_strings.txt");
   if (!file.is_open()) {
@@ -241,9 +270,9 @@ bool InsertionRetrievalTest<std::string, bool>::make_expected_hashtable() {
     auto key_value = std::make_pair(key, value);
     bool success = false;
     if (value)
-      success = m_positive_table.insert(key_value).second;
+      success = positive_table->insert(key_value).second;
     else
-      success = m_negative_table.insert(key_value).second;
+      success = negative_table->insert(key_value).second;
 
     if (!success) {
       std::cout << __ESR_PRETTY_FUNCTION__ << ' '
@@ -260,7 +289,10 @@ bool InsertionRetrievalTest<std::string, bool>::make_expected_hashtable() {
 }
 
 template <>
-bool InsertionRetrievalTest<bool, bool>::make_expected_hashtable() {
+bool make_expected_tables<bool, bool>(
+    int input_size,
+    std::unordered_map<bool, bool>* positive_table,
+    std::unordered_map<bool, bool>* negative_table) {
   bool key_positive = true;
   bool key_negative = false;
   bool value_positive = false;
@@ -269,7 +301,7 @@ bool InsertionRetrievalTest<bool, bool>::make_expected_hashtable() {
   auto key_value_positive = std::make_pair(key_positive, value_positive);
   auto key_value_negative = std::make_pair(key_negative, value_negative);
 
-  bool success_positive = m_positive_table.insert(key_value_positive).second;
+  bool success_positive = positive_table->insert(key_value_positive).second;
   if (!success_positive) {
         std::cout << __ESR_PRETTY_FUNCTION__ << ' '
                   << "failed to insert key = " << key_positive << ", "
@@ -278,7 +310,7 @@ bool InsertionRetrievalTest<bool, bool>::make_expected_hashtable() {
         return false;
   }
 
-  bool success_negative = m_negative_table.insert(key_value_negative).second;
+  bool success_negative = negative_table->insert(key_value_negative).second;
   if (!success_negative) {
         std::cout << __ESR_PRETTY_FUNCTION__ << ' '
                   << "failed to insert key = " << key_negative << ", "
@@ -289,6 +321,23 @@ bool InsertionRetrievalTest<bool, bool>::make_expected_hashtable() {
   return true;
 }
 
+/// @brief Hashtable which resizes incrementally.
+/// Runs the same tests with source buckets of pending resizes.
+template <typename K, typename V>
+class IncrementalHashtable : public esr::Hashtable<K, V> {
+ public:
+  IncrementalHashtable() { this->set_incremental_resize(true); }
+};
+
+/// @brief Hashtable which resizes by a few threads.
+/// Runs the same tests with nodes relinked by parallel resizes, even
+/// of small tables and on a single core.
+template <typename K, typename V>
+class ParallelHashtable : public esr::Hashtable<K, V> {
+ public:
+  ParallelHashtable() { this->set_parallel_resize(1024, 4); }
+};
+
 }  // namespace esr_test
 
 const size_t kIntegerKeysCount = (1024*1024);
@@ -433,7 +482,763 @@ int main() {
       shared_ptr<esr_test::DeletionTest<bool, bool>>
       (new esr_test::DeletionTest<bool, bool>(2, "<bool, bool>")));
 
-  for (auto test : correctness_tests) {
+////////////////////////////////////////////////////////////////////////////////
+// Iteration over sparse table
+////////////////////////////////////////////////////////////////////////////////
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::IterationTest<int, int>
+       (kIntegerKeysCount, "<int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::IterationTest<std::string, std::string>
+       (kStringKeysCount, "<string, string>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Reserve and resize hysteresis
+////////////////////////////////////////////////////////////////////////////////
+  correctness_tests.push_back(
+      shared_ptr<esr_test::ReserveTest<int, int>>
+      (new esr_test::ReserveTest<int, int>(kIntegerKeysCount, "<int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::ReserveTest<std::string, int>>
+      (new esr_test::ReserveTest<std::string, int>
+       (kStringKeysCount, "<string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::ReserveTest<int, std::string>>
+      (new esr_test::ReserveTest<int, std::string>
+       (kIntegerKeysCount, "<int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::ReserveTest<std::string, std::string>>
+      (new esr_test::ReserveTest<std::string, std::string>
+       (kStringKeysCount, "<string, string>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Bulk load
+////////////////////////////////////////////////////////////////////////////////
+  correctness_tests.push_back(
+      shared_ptr<esr_test::BulkLoadTest<int, int>>
+      (new esr_test::BulkLoadTest<int, int>(kIntegerKeysCount, "<int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::BulkLoadTest<std::string, int>>
+      (new esr_test::BulkLoadTest<std::string, int>
+       (kStringKeysCount, "<string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::BulkLoadTest<int, std::string>>
+      (new esr_test::BulkLoadTest<int, std::string>
+       (kIntegerKeysCount, "<int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::BulkLoadTest<std::string, std::string>>
+      (new esr_test::BulkLoadTest<std::string, std::string>
+       (kStringKeysCount, "<string, string>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Snapshot
+////////////////////////////////////////////////////////////////////////////////
+  correctness_tests.push_back(
+      shared_ptr<esr_test::SnapshotTest<int, int>>
+      (new esr_test::SnapshotTest<int, int>(kIntegerKeysCount, "<int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::SnapshotTest<std::string, int>>
+      (new esr_test::SnapshotTest<std::string, int>
+       (kStringKeysCount, "<string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::SnapshotTest<int, std::string>>
+      (new esr_test::SnapshotTest<int, std::string>
+       (kIntegerKeysCount, "<int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::SnapshotTest<std::string, std::string>>
+      (new esr_test::SnapshotTest<std::string, std::string>
+       (kStringKeysCount, "<string, string>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Move semantics
+////////////////////////////////////////////////////////////////////////////////
+  correctness_tests.push_back(
+      shared_ptr<esr_test::MoveTest<int, int>>
+      (new esr_test::MoveTest<int, int>(kIntegerKeysCount, "<int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::MoveTest<std::string, int>>
+      (new esr_test::MoveTest<std::string, int>
+       (kStringKeysCount, "<string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::MoveTest<int, std::string>>
+      (new esr_test::MoveTest<int, std::string>
+       (kIntegerKeysCount, "<int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::MoveTest<std::string, std::string>>
+      (new esr_test::MoveTest<std::string, std::string>
+       (kStringKeysCount, "<string, string>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Single lookup insertion
+////////////////////////////////////////////////////////////////////////////////
+  correctness_tests.push_back(
+      shared_ptr<esr_test::UpsertTest<int, int>>
+      (new esr_test::UpsertTest<int, int>(kIntegerKeysCount, "<int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::UpsertTest<std::string, int>>
+      (new esr_test::UpsertTest<std::string, int>
+       (kStringKeysCount, "<string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::UpsertTest<int, std::string>>
+      (new esr_test::UpsertTest<int, std::string>
+       (kIntegerKeysCount, "<int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::UpsertTest<std::string, std::string>>
+      (new esr_test::UpsertTest<std::string, std::string>
+       (kStringKeysCount, "<string, string>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Batch lookup
+////////////////////////////////////////////////////////////////////////////////
+  correctness_tests.push_back(
+      shared_ptr<esr_test::BatchLookupTest<int, int>>
+      (new esr_test::BatchLookupTest<int, int>
+       (kIntegerKeysCount, "<int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::BatchLookupTest<std::string, int>>
+      (new esr_test::BatchLookupTest<std::string, int>
+       (kStringKeysCount, "<string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::BatchLookupTest<int, std::string>>
+      (new esr_test::BatchLookupTest<int, std::string>
+       (kIntegerKeysCount, "<int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::BatchLookupTest<std::string, std::string>>
+      (new esr_test::BatchLookupTest<std::string, std::string>
+       (kStringKeysCount, "<string, string>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Parallel scans
+////////////////////////////////////////////////////////////////////////////////
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::ParallelScanTest<int, int>
+       (kIntegerKeysCount, "<int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::ParallelScanTest<std::string, std::string>
+       (kStringKeysCount, "<string, string>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Lookup by view of key
+////////////////////////////////////////////////////////////////////////////////
+  correctness_tests.push_back(
+      shared_ptr<esr_test::KeyViewTest<int>>
+      (new esr_test::KeyViewTest<int>(kStringKeysCount, "<string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::KeyViewTest<std::string>>
+      (new esr_test::KeyViewTest<std::string>
+       (kStringKeysCount, "<string, string>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Mapped table file
+////////////////////////////////////////////////////////////////////////////////
+  correctness_tests.push_back(
+      shared_ptr<esr_test::MappedTableTest<int>>
+      (new esr_test::MappedTableTest<int>(kStringKeysCount, "<string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::MappedTableTest<int,
+                                     esr::CompactHashtable<std::string, int>>
+       (kStringKeysCount, "compact <string, int>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Perfect hash engine
+////////////////////////////////////////////////////////////////////////////////
+  correctness_tests.push_back(
+      shared_ptr<esr_test::StaticTableTest<int, int>>
+      (new esr_test::StaticTableTest<int, int>
+       (kIntegerKeysCount, "<int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::StaticTableTest<std::string, int>>
+      (new esr_test::StaticTableTest<std::string, int>
+       (kStringKeysCount, "<string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::StaticTableTest<int, std::string>>
+      (new esr_test::StaticTableTest<int, std::string>
+       (kIntegerKeysCount, "<int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::StaticTableTest<std::string, std::string>>
+      (new esr_test::StaticTableTest<std::string, std::string>
+       (kStringKeysCount, "<string, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::StaticTableTest<int, int, esr_test::coarse_hash<int>>
+       (1024, "coarse hash <int, int>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Compile time engine
+////////////////////////////////////////////////////////////////////////////////
+  correctness_tests.push_back(
+      shared_ptr<esr_test::LiteralTableTest<int>>
+      (new esr_test::LiteralTableTest<int>(kStringKeysCount, "<string, int>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Concurrent engine
+////////////////////////////////////////////////////////////////////////////////
+  correctness_tests.push_back(
+      shared_ptr<esr_test::ConcurrentTest<int, int>>
+      (new esr_test::ConcurrentTest<int, int>
+       (kIntegerKeysCount, "<int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::ConcurrentTest<std::string, int>>
+      (new esr_test::ConcurrentTest<std::string, int>
+       (kStringKeysCount, "<string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::ConcurrentTest<int, std::string>>
+      (new esr_test::ConcurrentTest<int, std::string>
+       (kIntegerKeysCount, "<int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::ConcurrentTest<std::string, std::string>>
+      (new esr_test::ConcurrentTest<std::string, std::string>
+       (kStringKeysCount, "<string, string>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Lock free lookups
+////////////////////////////////////////////////////////////////////////////////
+  typedef esr::EpochHashtable<int, int> epoch_int_int_t;
+  typedef esr::EpochHashtable<std::string, int> epoch_string_int_t;
+  typedef esr::EpochHashtable<int, std::string> epoch_int_string_t;
+  typedef esr::EpochHashtable<std::string, std::string> epoch_string_string_t;
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::ConcurrentTest<int, int, epoch_int_int_t>>
+      (new esr_test::ConcurrentTest<int, int, epoch_int_int_t>
+       (kIntegerKeysCount, "epoch <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::ConcurrentTest<std::string, int,
+                                          epoch_string_int_t>>
+      (new esr_test::ConcurrentTest<std::string, int, epoch_string_int_t>
+       (kStringKeysCount, "epoch <string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::ConcurrentTest<int, std::string,
+                                          epoch_int_string_t>>
+      (new esr_test::ConcurrentTest<int, std::string, epoch_int_string_t>
+       (kIntegerKeysCount, "epoch <int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::ConcurrentTest<std::string, std::string,
+                                          epoch_string_string_t>>
+      (new esr_test::ConcurrentTest<std::string, std::string,
+                                    epoch_string_string_t>
+       (kStringKeysCount, "epoch <string, string>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Sharded engine
+////////////////////////////////////////////////////////////////////////////////
+  typedef esr::ShardedHashtable<int, int> sharded_int_int_t;
+  typedef esr::ShardedHashtable<std::string, std::string>
+      sharded_string_string_t;
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::ConcurrentTest<int, int, sharded_int_int_t>>
+      (new esr_test::ConcurrentTest<int, int, sharded_int_int_t>
+       (kIntegerKeysCount, "sharded <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::ConcurrentTest<std::string, std::string,
+                                          sharded_string_string_t>>
+      (new esr_test::ConcurrentTest<std::string, std::string,
+                                    sharded_string_string_t>
+       (kStringKeysCount, "sharded <string, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::ShardedTest<int, int>>
+      (new esr_test::ShardedTest<int, int>(kIntegerKeysCount, "<int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::ShardedTest<std::string, std::string>>
+      (new esr_test::ShardedTest<std::string, std::string>
+       (kStringKeysCount, "<string, string>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Open addressing engine
+////////////////////////////////////////////////////////////////////////////////
+  typedef esr::FlatHashtable<int, int> flat_int_int_t;
+  typedef esr::FlatHashtable<std::string, int> flat_string_int_t;
+  typedef esr::FlatHashtable<int, std::string> flat_int_string_t;
+  typedef esr::FlatHashtable<std::string, std::string> flat_string_string_t;
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<int, int, flat_int_int_t>
+       (kIntegerKeysCount, "flat <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<std::string, int, flat_string_int_t>
+       (kStringKeysCount, "flat <string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<int, std::string, flat_int_string_t>
+       (kIntegerKeysCount, "flat <int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<std::string, std::string,
+                                            flat_string_string_t>
+       (kStringKeysCount, "flat <string, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<int, int, flat_int_int_t>
+       (kIntegerKeysCount, "flat <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<std::string, int, flat_string_int_t>
+       (kStringKeysCount, "flat <string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<int, std::string, flat_int_string_t>
+       (kIntegerKeysCount, "flat <int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<std::string, std::string,
+                                        flat_string_string_t>
+       (kStringKeysCount, "flat <string, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<int, int, flat_int_int_t>
+       (kIntegerKeysCount, "flat <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<std::string, int, flat_string_int_t>
+       (kStringKeysCount, "flat <string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<int, std::string, flat_int_string_t>
+       (kIntegerKeysCount, "flat <int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<std::string, std::string,
+                                  flat_string_string_t>
+       (kStringKeysCount, "flat <string, string>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Control bytes engine
+////////////////////////////////////////////////////////////////////////////////
+  typedef esr::SwissHashtable<int, int> swiss_int_int_t;
+  typedef esr::SwissHashtable<std::string, int> swiss_string_int_t;
+  typedef esr::SwissHashtable<int, std::string> swiss_int_string_t;
+  typedef esr::SwissHashtable<std::string, std::string> swiss_string_string_t;
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<int, int, swiss_int_int_t>
+       (kIntegerKeysCount, "swiss <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<std::string, int,
+                                            swiss_string_int_t>
+       (kStringKeysCount, "swiss <string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<int, std::string,
+                                            swiss_int_string_t>
+       (kIntegerKeysCount, "swiss <int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<std::string, std::string,
+                                            swiss_string_string_t>
+       (kStringKeysCount, "swiss <string, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<int, int, swiss_int_int_t>
+       (kIntegerKeysCount, "swiss <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<std::string, int, swiss_string_int_t>
+       (kStringKeysCount, "swiss <string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<int, std::string, swiss_int_string_t>
+       (kIntegerKeysCount, "swiss <int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<std::string, std::string,
+                                        swiss_string_string_t>
+       (kStringKeysCount, "swiss <string, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<int, int, swiss_int_int_t>
+       (kIntegerKeysCount, "swiss <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<std::string, int, swiss_string_int_t>
+       (kStringKeysCount, "swiss <string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<int, std::string, swiss_int_string_t>
+       (kIntegerKeysCount, "swiss <int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<std::string, std::string,
+                                  swiss_string_string_t>
+       (kStringKeysCount, "swiss <string, string>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Compact dict engine
+////////////////////////////////////////////////////////////////////////////////
+  typedef esr::CompactHashtable<int, int> compact_int_int_t;
+  typedef esr::CompactHashtable<std::string, int> compact_string_int_t;
+  typedef esr::CompactHashtable<int, std::string> compact_int_string_t;
+  typedef esr::CompactHashtable<std::string, std::string>
+      compact_string_string_t;
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<int, int, compact_int_int_t>
+       (kIntegerKeysCount, "compact <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<std::string, int,
+                                            compact_string_int_t>
+       (kStringKeysCount, "compact <string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<int, std::string,
+                                            compact_int_string_t>
+       (kIntegerKeysCount, "compact <int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<std::string, std::string,
+                                            compact_string_string_t>
+       (kStringKeysCount, "compact <string, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<int, int, compact_int_int_t>
+       (kIntegerKeysCount, "compact <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<std::string, int, compact_string_int_t>
+       (kStringKeysCount, "compact <string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<int, std::string, compact_int_string_t>
+       (kIntegerKeysCount, "compact <int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<std::string, std::string,
+                                        compact_string_string_t>
+       (kStringKeysCount, "compact <string, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<int, int, compact_int_int_t>
+       (kIntegerKeysCount, "compact <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<std::string, int, compact_string_int_t>
+       (kStringKeysCount, "compact <string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<int, std::string, compact_int_string_t>
+       (kIntegerKeysCount, "compact <int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<std::string, std::string,
+                                  compact_string_string_t>
+       (kStringKeysCount, "compact <string, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionOrderTest<int, int, compact_int_int_t>
+       (kIntegerKeysCount, "compact <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionOrderTest<std::string, int, compact_string_int_t>
+       (kStringKeysCount, "compact <string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionOrderTest<int, std::string, compact_int_string_t>
+       (kIntegerKeysCount, "compact <int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionOrderTest<std::string, std::string,
+                                        compact_string_string_t>
+       (kStringKeysCount, "compact <string, string>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Modulo bucket mapping
+////////////////////////////////////////////////////////////////////////////////
+  typedef esr::Hashtable<int, int, esr::hash_function<int>,
+                         esr::modulo_mapping> mod_int_int_t;
+  typedef esr::Hashtable<std::string, int, esr::hash_function<std::string>,
+                         esr::modulo_mapping> mod_string_int_t;
+  typedef esr::Hashtable<int, std::string, esr::hash_function<int>,
+                         esr::modulo_mapping> mod_int_string_t;
+  typedef esr::Hashtable<std::string, std::string,
+                         esr::hash_function<std::string>,
+                         esr::modulo_mapping> mod_string_string_t;
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<int, int, mod_int_int_t>
+       (kIntegerKeysCount, "modulo <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<std::string, int, mod_string_int_t>
+       (kStringKeysCount, "modulo <string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<int, std::string, mod_int_string_t>
+       (kIntegerKeysCount, "modulo <int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<std::string, std::string,
+                                            mod_string_string_t>
+       (kStringKeysCount, "modulo <string, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<int, int, mod_int_int_t>
+       (kIntegerKeysCount, "modulo <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<std::string, int, mod_string_int_t>
+       (kStringKeysCount, "modulo <string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<int, std::string, mod_int_string_t>
+       (kIntegerKeysCount, "modulo <int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<std::string, std::string,
+                                        mod_string_string_t>
+       (kStringKeysCount, "modulo <string, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<int, int, mod_int_int_t>
+       (kIntegerKeysCount, "modulo <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<std::string, int, mod_string_int_t>
+       (kStringKeysCount, "modulo <string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<int, std::string, mod_int_string_t>
+       (kIntegerKeysCount, "modulo <int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<std::string, std::string, mod_string_string_t>
+       (kStringKeysCount, "modulo <string, string>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Incremental resize
+////////////////////////////////////////////////////////////////////////////////
+  typedef esr_test::IncrementalHashtable<int, int> inc_int_int_t;
+  typedef esr_test::IncrementalHashtable<std::string, int> inc_string_int_t;
+  typedef esr_test::IncrementalHashtable<int, std::string> inc_int_string_t;
+  typedef esr_test::IncrementalHashtable<std::string, std::string>
+      inc_string_string_t;
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<int, int, inc_int_int_t>
+       (kIntegerKeysCount, "incremental <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<std::string, int, inc_string_int_t>
+       (kStringKeysCount, "incremental <string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<int, std::string, inc_int_string_t>
+       (kIntegerKeysCount, "incremental <int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<std::string, std::string,
+                                            inc_string_string_t>
+       (kStringKeysCount, "incremental <string, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<int, int, inc_int_int_t>
+       (kIntegerKeysCount, "incremental <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<std::string, int, inc_string_int_t>
+       (kStringKeysCount, "incremental <string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<int, std::string, inc_int_string_t>
+       (kIntegerKeysCount, "incremental <int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::CopyAssignmentTest<std::string, std::string,
+                                        inc_string_string_t>
+       (kStringKeysCount, "incremental <string, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<int, int, inc_int_int_t>
+       (kIntegerKeysCount, "incremental <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<std::string, int, inc_string_int_t>
+       (kStringKeysCount, "incremental <string, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<int, std::string, inc_int_string_t>
+       (kIntegerKeysCount, "incremental <int, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<std::string, std::string, inc_string_string_t>
+       (kStringKeysCount, "incremental <string, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::UpsertTest<int, int, inc_int_int_t>
+       (kIntegerKeysCount, "incremental <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::UpsertTest<std::string, std::string, inc_string_string_t>
+       (kStringKeysCount, "incremental <string, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::BatchLookupTest<int, int, inc_int_int_t>
+       (kIntegerKeysCount, "incremental <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::ParallelScanTest<int, int, inc_int_int_t>
+       (kIntegerKeysCount, "incremental <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::IterationTest<int, int, inc_int_int_t>
+       (kIntegerKeysCount, "incremental <int, int>")));
+
+////////////////////////////////////////////////////////////////////////////////
+// Parallel resize
+////////////////////////////////////////////////////////////////////////////////
+  typedef esr_test::ParallelHashtable<int, int> par_int_int_t;
+  typedef esr_test::ParallelHashtable<std::string, std::string>
+      par_string_string_t;
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<int, int, par_int_int_t>
+       (kIntegerKeysCount, "parallel <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::InsertionRetrievalTest<std::string, std::string,
+                                            par_string_string_t>
+       (kStringKeysCount, "parallel <string, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<int, int, par_int_int_t>
+       (kIntegerKeysCount, "parallel <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::DeletionTest<std::string, std::string,
+                                  par_string_string_t>
+       (kStringKeysCount, "parallel <string, string>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::ReserveTest<int, int, par_int_int_t>
+       (kIntegerKeysCount, "parallel <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::IterationTest<int, int, par_int_int_t>
+       (kIntegerKeysCount, "parallel <int, int>")));
+
+  correctness_tests.push_back(
+      shared_ptr<esr_test::CorrectnessTest>
+      (new esr_test::ParallelResizeFailureTest<int, int>
+       (kIntegerKeysCount, "<int, int>")));
+
+  for (auto& test : correctness_tests) {
     std::cout << test->name()
               << "{size=" << test->intput_size() << "} "
               << test->description() << " : "
@@ -446,6 +1251,7 @@ int main() {
       continue;
     }
     std::cout<< (test->run() ? "[PASSED]" : "[FAILED]") << '\n';
+    test.reset();  // tables of the test are done with
   }
   return 0;
 }
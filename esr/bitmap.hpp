@@ -0,0 +1,132 @@
+// Copyright 2016
+#ifndef ESR_BITMAP_FLYMAKE_HPP_
+#define ESR_BITMAP_FLYMAKE_HPP_
+////////////////////////////////////////////////////////////////////////////////
+// Bitmap.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>  // assert().
+#include <cstddef>  // size_t.
+#include <cstdint>  // uint64_t.
+#include <utility>  // std::swap().
+
+namespace esr {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class bitmap.
+///
+/// @brief Fixed size set of bits, 64 bits per word.
+/// Finds the next set bit a word at a time: a run of clear bits
+/// costs one load and compare per 64 bits.
+////////////////////////////////////////////////////////////////////////////////
+class bitmap {
+ public:
+  /// Default constructor, creates bitmap of no bits.
+  bitmap() : m_size(0), m_words(nullptr) {}
+
+  /// @brief Constructor, creates bitmap of clear bits.
+  /// @param size is a number of bits.
+  /// @return nothing.
+  explicit bitmap(size_t size) :
+      m_size(size),
+      m_words(size == 0 ? nullptr : new uint64_t[word_count(size)]()) {}
+
+  /// Move constructor, other is left without bits.
+  bitmap(bitmap&& other) : bitmap() { swap(other); }
+
+  /// Move assignment, other is left with bits of this one.
+  bitmap& operator=(bitmap&& other) {
+    swap(other);
+    return *this;
+  }
+
+  /// Destructor.
+  ~bitmap() { delete [] m_words; }
+
+  /// Swaps bits with other bitmap.
+  void swap(bitmap& other) {
+    std::swap(m_size, other.m_size);
+    std::swap(m_words, other.m_words);
+  }
+
+  /// Gets a number of bits.
+  size_t size() const { return m_size; }
+
+  /// Gets a number of bits of a word: threads may set bits of
+  /// distinct words at the same time.
+  static size_t word_bits() { return m_WordBits; }
+
+  /// Sets a bit.
+  void set(size_t idx) {
+    assert(idx < m_size);
+    m_words[idx/m_WordBits] |= uint64_t(1) << (idx % m_WordBits);
+  }
+
+  /// Clears a bit.
+  void reset(size_t idx) {
+    assert(idx < m_size);
+    m_words[idx/m_WordBits] &= ~(uint64_t(1) << (idx % m_WordBits));
+  }
+
+  /// Checks a bit.
+  bool test(size_t idx) const {
+    assert(idx < m_size);
+    return (m_words[idx/m_WordBits] >> (idx % m_WordBits)) & 1;
+  }
+
+  /// @brief Finds the first set bit at or after a bit.
+  /// @param idx is an index of the first bit to check, may be size().
+  /// @return index of the set bit or size() if there is none.
+  size_t find_next(size_t idx) const {
+    if (idx >= m_size)
+      return m_size;
+    size_t word_idx = idx/m_WordBits;
+    uint64_t word = m_words[word_idx] & (~uint64_t(0) << (idx % m_WordBits));
+    while (word == 0) {
+      if (++word_idx == word_count(m_size))
+        return m_size;
+      word = m_words[word_idx];
+    }
+    return word_idx*m_WordBits + lowest(word);
+  }
+
+ private:
+  /// Number of bits.
+  size_t m_size;
+
+  /// Words of bits, bits past size are clear.
+  uint64_t* m_words;
+
+  /// Gets a number of words of a number of bits.
+  static size_t word_count(size_t size) {
+    return (size + m_WordBits - 1)/m_WordBits;
+  }
+
+  /// @brief Gets index of the lowest set bit.
+  /// @param word is a not zero word.
+  /// @return index of the lowest set bit.
+  static size_t lowest(uint64_t word) {
+    assert(word != 0);
+#ifdef __GNUC__
+    return __builtin_ctzll(word);
+#else
+    size_t idx = 0;
+    while ((word & 1) == 0) {
+      word >>= 1;
+      ++idx;
+    }
+    return idx;
+#endif
+  }
+
+  /// Not copyable, owner copies content it needs.
+  bitmap(const bitmap&);
+  bitmap& operator=(const bitmap&);
+
+  /// Number of bits in a word.
+  static const size_t m_WordBits = 64;
+};
+
+}  // namespace esr
+
+#endif  // ESR_BITMAP_FLYMAKE_HPP_
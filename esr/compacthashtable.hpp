@@ -0,0 +1,737 @@
+// Copyright 2016
+#ifndef ESR_COMPACTHASHTABLE_FLYMAKE_HPP_
+#define ESR_COMPACTHASHTABLE_FLYMAKE_HPP_
+////////////////////////////////////////////////////////////////////////////////
+// CompactHashtable <K, V>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <ostream>    // operator<<().
+#include <iomanip>    // operator<<().
+#include <cassert>    // assert().
+#include <cstring>    // std::memcpy().
+#include <algorithm>  // std::swap().
+#include <memory>     // std::unique_ptr.
+#include <utility>    // std::move().
+
+#include <esr/hasher.hpp>      // Basic hash functions.
+#include <esr/hashexcept.hpp>  // Hashtable's specific exceptions.
+
+namespace esr {
+
+template <typename K, typename V>
+class CompactHashtable;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class compactentry.
+///
+/// @brief Entry of CompactHashtable.
+/// Entry contains key, value and whether it's removed: removed
+/// entries stay in place until the entry array is rebuilt.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V>
+class compactentry {
+  template <typename KK, typename VV>
+  friend class CompactHashtable;
+ public:
+  /// Default constructor, creates removed entry.
+  compactentry() : m_removed(true) {}
+
+  /// @brief Gets key.
+  /// Returns reference to key.
+  const K& key() const { return m_key; }
+
+  /// @brief Gets mutable value.
+  /// Returns reference to value.
+  V& value() { return m_value; }
+
+  /// @brief Gets immutable value.
+  /// Returns reference to value.
+  const V& value() const { return m_value; }
+
+  /// @brief Sets the value.
+  void set(const V& value) { m_value = value; }
+
+  /// @brief Is entry removed or not.
+  bool removed() const { return m_removed; }
+
+  /// @brief Printout entry.
+  friend std::ostream & operator<<(std::ostream & os,
+                                  const compactentry<K, V>& entry) {
+    return os << entry.m_key <<"=>"<< entry.m_value;
+  }
+
+ private:
+  K m_key;
+  V m_value;
+  bool m_removed;  //< Removed entry, a hole in the entry array.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class CompactHashtable.
+///
+/// @brief Insertion ordered compact Hashtable implementation.
+/// Elements live in a dense entry array in insertion order. A
+/// separate index array, a power of two in size, maps keys to
+/// entries by linear probing; it's slots hold entry numbers as 1, 2,
+/// 4 or 8 byte integers, the narrowest type which fits the table.
+/// Removal leaves a hole in the entry array and a dummy in the
+/// index, both are dropped when the arrays are rebuilt. Iteration
+/// scans the entry array: contiguous memory in insertion order.
+/// Has the same interface as Hashtable.
+/// @tparam K type of hash key, must be default constructible.
+/// @tparam V type of hash value, must be default constructible.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V>
+class CompactHashtable {
+ public:
+  class iterator;
+
+  /// Default constructor, creates CompactHashtable.
+  CompactHashtable();
+
+  /// Copy constructor, creates copy of CompactHashtable.
+  CompactHashtable(const CompactHashtable& other);
+
+  /// Destructor, deletes CompactHashtable.
+  virtual ~CompactHashtable();
+
+  /// Assignment operator.
+  CompactHashtable& operator=(CompactHashtable other);
+
+  /// Adds key, value to hashtable.
+  bool add(const K& key, const V& value);
+
+  /// Removes key from hashtable.
+  void remove(const K& key);
+
+  /// Sets the value by key.
+  bool set(const K& key, const V& value);
+
+  /// Gets constant pointer to value by key.
+  const V* get(const K& key) const;
+
+  /// Finds a value by key.
+  iterator find(const K& key);
+
+  /// Gets a number of elements in hashtable.
+  size_t size() const { return m_size; }
+
+  /// Gets a number of entries the entry array holds before rebuild.
+  size_t capacity() const { return m_capacity; }
+
+  /// Gets a number of bytes of an index slot.
+  size_t index_width() const { return m_width; }
+
+  /// Gets a number of used entries in percents of index size.
+  size_t load_factor() const {
+    return (
+        (m_index_size == 0) ?
+        0 : (m_LoadFactor100Percents*m_used)/m_index_size);
+  }
+
+  /// Hashtable's printer.
+  template <typename KK, typename VV>
+  friend std::ostream & operator<<(std::ostream & os,
+                                   const CompactHashtable<KK, VV> & ht);
+
+  /// Forward iterator, follows insertion order.
+  class iterator {
+   public:
+    /// @brief Creates CompactHashtable's iterator.
+    /// @param owner is a CompactHashtable object, owner of the iterator.
+    /// @param current_entry_idx is a number of the current entry
+    /// in entry array.
+    explicit iterator(CompactHashtable* owner, size_t current_entry_idx) :
+        m_owner(owner),
+        m_current_entry_idx(current_entry_idx) {}
+
+    /// Advances the iterator to the next element.
+    iterator& operator++();
+
+    /// Dereferenses an iterator.
+    compactentry<K, V>& operator*();
+
+    /// Dereferenses an iterator.
+    compactentry<K, V>* operator->();
+
+    /// Inequality comparison of iterators.
+    bool operator!=(const iterator& rhs) {
+      return m_current_entry_idx != rhs.m_current_entry_idx;
+    }
+
+    /// Equality comparison of iterators.
+    bool operator==(const iterator& rhs) {
+      return m_current_entry_idx == rhs.m_current_entry_idx;
+    }
+
+   private:
+    /// Owner of the iterator.
+    CompactHashtable* m_owner;
+
+    /// Number of the current entry in the entry array,
+    /// number of used entries for the end iterator.
+    size_t m_current_entry_idx;
+  };
+
+  /// Gets the beginning of CompactHashtable.
+  iterator begin();
+
+  /// Gets the end of CompactHashtable.
+  iterator end() { return iterator(this, m_used); }
+
+ private:
+  /// Number of elements in CompactHashtable.
+  uint64_t m_size;
+
+  /// Hash function to get hash code of key.
+  hash_function<K> hash;
+
+  /// Number of used entries, removed ones included.
+  size_t m_used;
+
+  /// Number of entries of entry array, two thirds of index size.
+  size_t m_capacity;
+
+  /// Entry array.
+  compactentry<K, V>* m_entries;
+
+  /// Number of slots of index array.
+  size_t m_index_size;
+
+  /// Shift of mixed hash code, 64 - log2(index size).
+  size_t m_shift;
+
+  /// Number of bytes of an index slot.
+  size_t m_width;
+
+  /// Index array, m_width bytes per slot.
+  unsigned char* m_index;
+
+  /// Gets home index slot of the key. Mixes hash code and takes the
+  /// high bits, so keys with regular codes spread over the index.
+  size_t home(const K& key) const {
+    return mix(hash.code(key)) >> m_shift;
+  }
+
+  /// Gets index slot following the given one.
+  size_t next(size_t slot_idx) const {
+    return (slot_idx + 1 == m_index_size) ? 0 : slot_idx + 1;
+  }
+
+  /// Gets content of index slot: m_Empty, m_Dummy or entry number
+  /// plus m_Dummy + 1.
+  size_t index_at(size_t slot_idx) const;
+
+  /// Sets content of index slot.
+  void set_index(size_t slot_idx, size_t content);
+
+  /// Gets index slot of the key or index size if none.
+  size_t lookup(const K& key) const;
+
+  /// Gets entry number by index slot of lookup().
+  size_t entry_of(size_t slot_idx) const {
+    return index_at(slot_idx) - m_Dummy - 1;
+  }
+
+  /// Rebuilds index and entry arrays, drops removed entries.
+  /// @param size is a number of elements to fit.
+  void rebuild(size_t size);
+
+  /// Releases index and entry arrays of empty table.
+  void release();
+
+  /// Gets a number of entries of an index size.
+  static size_t usable(size_t index_size) { return index_size*2/3; }
+
+  /// Load factor 100%.
+  static const size_t m_LoadFactor100Percents = 100;  // used == slots, 100%.
+
+  /// Content of empty index slot.
+  static const size_t m_Empty = 0;
+
+  /// Content of index slot of removed entry.
+  static const size_t m_Dummy = 1;
+
+  /// Size of the first index array.
+  static const size_t m_MinIndexSize = 8;
+
+  /// Entry array shrinks when one of this number of entries is used.
+  static const size_t m_ShrinkRatio = 8;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V>
+const size_t CompactHashtable<K, V>::m_LoadFactor100Percents;
+template <typename K, typename V>
+const size_t CompactHashtable<K, V>::m_Empty;
+template <typename K, typename V>
+const size_t CompactHashtable<K, V>::m_Dummy;
+template <typename K, typename V>
+const size_t CompactHashtable<K, V>::m_MinIndexSize;
+template <typename K, typename V>
+const size_t CompactHashtable<K, V>::m_ShrinkRatio;
+
+////////////////////////////////////////////////////////////////////////////////
+// Constructors, Destructor and Assignment.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Default constructor for CompactHashtable.
+/// No array is allocated until the first element is added.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @return nothing.
+template <typename K, typename V>
+CompactHashtable<K, V>::CompactHashtable() :
+    m_size(0),
+    hash(),
+    m_used(0),
+    m_capacity(0),
+    m_entries(nullptr),
+    m_index_size(0),
+    m_shift(64),
+    m_width(1),
+    m_index(nullptr) {}
+
+/// @brief Copy constructor for CompactHashtable.
+/// Creates copy of existing CompactHashtable instance, removed
+/// entries included.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param other is an existing source CompactHashtable
+/// instance to be copied to target.
+/// @return nothing.
+template <typename K, typename V>
+CompactHashtable<K, V>::CompactHashtable(const CompactHashtable& other) :
+    m_size(other.m_size),
+    hash(other.hash),
+    m_used(other.m_used),
+    m_capacity(other.m_capacity),
+    m_entries(nullptr),
+    m_index_size(other.m_index_size),
+    m_shift(other.m_shift),
+    m_width(other.m_width),
+    m_index(nullptr) {
+  if (m_index_size == 0)
+    return;
+  std::unique_ptr<compactentry<K, V>[]> entries(
+      new compactentry<K, V>[m_capacity]);
+  for (size_t i = 0; i < m_used; ++i)
+    entries[i] = other.m_entries[i];
+  m_index = new unsigned char[m_index_size*m_width];
+  std::memcpy(m_index, other.m_index, m_index_size*m_width);
+  m_entries = entries.release();
+}
+
+/// @brief Assignment operator for CompactHashtable.
+/// Creates copy of existing CompactHashtable instance,
+/// cleaning up left-hand target.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param other is an existing source CompactHashtable
+/// instance to be copied to target.
+/// @return nothing.
+template <typename K, typename V>
+CompactHashtable<K, V>&
+CompactHashtable<K, V>::operator=(CompactHashtable other) {
+  std::swap(m_size, other.m_size);
+  std::swap(hash, other.hash);
+  std::swap(m_used, other.m_used);
+  std::swap(m_capacity, other.m_capacity);
+  std::swap(m_entries, other.m_entries);
+  std::swap(m_index_size, other.m_index_size);
+  std::swap(m_shift, other.m_shift);
+  std::swap(m_width, other.m_width);
+  std::swap(m_index, other.m_index);
+  return *this;
+}
+
+/// @brief Destructor for CompactHashtable.
+/// Removes content of CompactHashtable instance,
+/// deleting the index and entry arrays.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @return nothing.
+template <typename K, typename V>
+CompactHashtable<K, V>::~CompactHashtable() {
+  delete [] m_entries;
+  delete [] m_index;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Iterator.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Advances the iterator to the next element.
+/// Skips removed entries of the entry array. Sets current entry
+/// index to the number of used entries if CompactHashtable
+/// don't have elements any more.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @return reference to iterator.
+template <typename K, typename V>
+typename CompactHashtable<K, V>::iterator&
+CompactHashtable<K, V>::iterator::operator++() {
+  size_t used = m_owner->m_used;
+  do {
+    ++m_current_entry_idx;
+  } while (m_current_entry_idx < used &&
+           m_owner->m_entries[m_current_entry_idx].removed());
+  return *this;
+}
+
+/// @brief Dereferenses an iterator.
+/// Provides access to CompactHashtable's element by it's reference.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @return reference to CompactHashtable's element.
+/// @throw end_iterator exception in attempt to dereferencing an
+/// end iterator.
+template <typename K, typename V>
+compactentry<K, V>& CompactHashtable<K, V>::iterator::operator*() {
+  if (m_current_entry_idx >= m_owner->m_used)
+    throw exception::end_iterator(m_current_entry_idx,
+                                  __ESR_PRETTY_FUNCTION__);
+  return m_owner->m_entries[m_current_entry_idx];
+}
+
+/// @brief Dereferenses an iterator.
+/// Provides access to CompactHashtable's element by it's pointer.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @return pointer to CompactHashtable's element.
+/// @throw end_iterator exception in attempt to dereferencing an
+/// end iterator.
+template <typename K, typename V>
+compactentry<K, V>* CompactHashtable<K, V>::iterator::operator->() {
+  if (m_current_entry_idx >= m_owner->m_used)
+    throw exception::end_iterator(m_current_entry_idx,
+                                  __ESR_PRETTY_FUNCTION__);
+  return &m_owner->m_entries[m_current_entry_idx];
+}
+
+/// @brief Gets the beginning of CompactHashtable.
+/// Searches for the first not removed entry.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @return iterator standing at the first element or end() iterator
+/// if CompactHashtable is empty.
+template <typename K, typename V>
+typename CompactHashtable<K, V>::iterator CompactHashtable<K, V>::begin() {
+  size_t first_entry_idx = 0;
+  while (first_entry_idx < m_used && m_entries[first_entry_idx].removed())
+    ++first_entry_idx;
+  return iterator(this, first_entry_idx);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Accessors and Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Gets content of index slot.
+/// Reads a slot of the width of the table: one switch per probe
+/// against an index a half, a quarter or an eighth the size.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param slot_idx is a number of index slot.
+/// @return content of index slot.
+template <typename K, typename V>
+size_t CompactHashtable<K, V>::index_at(size_t slot_idx) const {
+  const unsigned char* slot = m_index + slot_idx*m_width;
+  switch (m_width) {
+    case 1:
+      return *slot;
+    case 2: {
+      uint16_t content;
+      std::memcpy(&content, slot, sizeof(content));
+      return content;
+    }
+    case 4: {
+      uint32_t content;
+      std::memcpy(&content, slot, sizeof(content));
+      return content;
+    }
+    default: {
+      uint64_t content;
+      std::memcpy(&content, slot, sizeof(content));
+      return content;
+    }
+  }
+}
+
+/// @brief Sets content of index slot.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param slot_idx is a number of index slot.
+/// @param content is m_Empty, m_Dummy or entry number plus
+/// m_Dummy + 1, it fits the width of the table.
+/// @return nothing.
+template <typename K, typename V>
+void CompactHashtable<K, V>::set_index(size_t slot_idx, size_t content) {
+  unsigned char* slot = m_index + slot_idx*m_width;
+  switch (m_width) {
+    case 1:
+      *slot = static_cast<unsigned char>(content);
+      break;
+    case 2: {
+      uint16_t narrow = static_cast<uint16_t>(content);
+      std::memcpy(slot, &narrow, sizeof(narrow));
+      break;
+    }
+    case 4: {
+      uint32_t narrow = static_cast<uint32_t>(content);
+      std::memcpy(slot, &narrow, sizeof(narrow));
+      break;
+    }
+    default: {
+      uint64_t wide = content;
+      std::memcpy(slot, &wide, sizeof(wide));
+      break;
+    }
+  }
+}
+
+/// @brief Looks up an index slot.
+/// Walks the probe sequence starting from the home slot of the key
+/// until an empty slot, skipping dummies of removed entries.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param key is a key of element.
+/// @return index slot of the key or index size if no such key.
+template <typename K, typename V>
+size_t CompactHashtable<K, V>::lookup(const K& key) const {
+  if (m_size == 0)
+    return m_index_size;
+
+  for (size_t slot_idx = home(key); ; slot_idx = next(slot_idx)) {
+    size_t content = index_at(slot_idx);
+    if (content == m_Empty)
+      return m_index_size;
+    if (content != m_Dummy && m_entries[content - m_Dummy - 1].m_key == key)
+      return slot_idx;
+  }
+}
+
+/// @brief Set value.
+/// Provides write access to CompactHashtable's element by it's key.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param key is a key of element.
+/// @param value is a value of element.
+/// @return result of setting a value.
+/// @retval true on success.
+/// @retval false if no element with such key found in CompactHashtable.
+template <typename K, typename V>
+bool CompactHashtable<K, V>::set(const K& key, const V& value) {
+  size_t slot_idx = lookup(key);
+  if (slot_idx == m_index_size)
+    return false;
+
+  m_entries[entry_of(slot_idx)].set(value);
+  return true;
+}
+
+/// @brief Gets value by it's key.
+/// Provides read access to CompactHashtable's element by it's key
+/// using pointer.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param key is a key of element in CompactHashtable.
+/// @return valid constant pointer to element in CompactHashtable or
+/// nullptr if no element with such key found in CompactHashtable.
+/// Pointer is invalidated by insertion or deletion which rebuilds
+/// the arrays.
+template <typename K, typename V>
+const V* CompactHashtable<K, V>::get(const K& key) const {
+  size_t slot_idx = lookup(key);
+  if (slot_idx == m_index_size)
+    return nullptr;
+
+  return &m_entries[entry_of(slot_idx)].value();
+}
+
+/// @brief Gets value by it's key.
+/// Provides read access to CompactHashtable's element by it's key
+/// using iterator.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param key is a key to CompactHashtable's element.
+/// @return iterator to element if found, otherwise it returns
+/// an iterator to CompactHashtable::end.
+template <typename K, typename V>
+typename CompactHashtable<K, V>::iterator
+CompactHashtable<K, V>::find(const K& key) {
+  size_t slot_idx = lookup(key);
+  if (slot_idx == m_index_size)
+    return end();
+  return iterator(this, entry_of(slot_idx));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Isertion, Deletion; private: Rebuild.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Adds an element.
+/// Appends an element to the entry array and points the first
+/// empty or dummy slot of it's probe sequence to it. Rebuilds the
+/// arrays when the entry array is full: twice the size of table,
+/// which drops removed entries and doubles the arrays only if
+/// there are few of them.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param key is a key to CompactHashtable's element.
+/// @param value is a value of CompactHashtable's element.
+/// @return result of insertion.
+/// @retval true if an element has been successfully inserted.
+/// @retval false if an element with such key is already in a
+/// CompactHashtable.
+template <typename K, typename V>
+bool CompactHashtable<K, V>::add(const K& key, const V& value) {
+  if (lookup(key) != m_index_size)
+    return false;  // dublicate keys
+
+  if (m_used == m_capacity)  // unlikely
+    rebuild(2*(m_size + 1));
+
+  size_t slot_idx = home(key);
+  while (index_at(slot_idx) > m_Dummy)
+    slot_idx = next(slot_idx);
+
+  compactentry<K, V>& entry = m_entries[m_used];
+  entry.m_key = key;
+  entry.m_value = value;
+  entry.m_removed = false;
+  set_index(slot_idx, m_used + m_Dummy + 1);
+  ++m_used;
+  ++m_size;
+  return true;
+}
+
+/// @brief Removes an element.
+/// Marks it's entry removed and it's index slot dummy, so probe
+/// sequences passing the slot go on. Entries of the rest of
+/// elements keep their places and their order. Shrinks the arrays
+/// when one of m_ShrinkRatio entries holds an element.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param key is a key to CompactHashtable's element.
+/// @return nothing.
+template <typename K, typename V>
+void CompactHashtable<K, V>::remove(const K& key) {
+  size_t slot_idx = lookup(key);
+  if (slot_idx == m_index_size) return;  // no such key
+
+  m_entries[entry_of(slot_idx)] = compactentry<K, V>();
+  set_index(slot_idx, m_Dummy);
+  --m_size;
+
+  // shrink
+  if (m_size == 0) {
+    release();
+    return;
+  }
+  if (m_ShrinkRatio*m_size < m_capacity &&
+      m_index_size > m_MinIndexSize)  // unlikely
+    rebuild(2*m_size);
+}
+
+/// @brief Rebuilds index and entry arrays.
+/// Creates arrays of the least index size holding size entries and
+/// of the index width it needs. Moves elements in their order to
+/// the new entry array, dropping removed entries and dummies, and
+/// points index slots to them. Deletes source arrays.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param size is a number of entries to hold, not less than
+/// number of elements.
+/// @return nothing.
+template <typename K, typename V>
+void CompactHashtable<K, V>::rebuild(size_t size) {
+  assert(size >= m_size);
+  size_t index_size = m_MinIndexSize;
+  while (usable(index_size) < size)
+    index_size += index_size;
+  size_t capacity = usable(index_size);
+  // entry number plus m_Dummy + 1 fits in the width
+  size_t width = 1;
+  while (width < sizeof(uint64_t) &&
+         capacity + m_Dummy >= (uint64_t(1) << (8*width)))
+    width += width;
+
+  std::unique_ptr<compactentry<K, V>[]> entries(
+      new compactentry<K, V>[capacity]);
+  std::unique_ptr<unsigned char[]> index(
+      new unsigned char[index_size*width]());
+  compactentry<K, V>* old_entries = m_entries;
+  size_t old_used = m_used;
+  m_entries = entries.release();
+  delete [] m_index;
+  m_index = index.release();
+  m_capacity = capacity;
+  m_index_size = index_size;
+  m_width = width;
+  m_shift = 64;
+  for (size_t c = index_size; c > 1; c >>= 1)
+    --m_shift;
+
+  m_used = 0;
+  for (size_t i = 0; i < old_used; ++i) {
+    if (old_entries[i].removed())
+      continue;
+    size_t slot_idx = home(old_entries[i].m_key);
+    while (index_at(slot_idx) != m_Empty)
+      slot_idx = next(slot_idx);
+    m_entries[m_used] = std::move(old_entries[i]);
+    set_index(slot_idx, m_used + m_Dummy + 1);
+    ++m_used;
+  }
+  delete [] old_entries;
+}
+
+/// @brief Releases arrays of empty CompactHashtable.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @return nothing.
+template <typename K, typename V>
+void CompactHashtable<K, V>::release() {
+  assert(m_size == 0);
+  delete [] m_entries;
+  delete [] m_index;
+  m_entries = nullptr;
+  m_index = nullptr;
+  m_used = 0;
+  m_capacity = 0;
+  m_index_size = 0;
+  m_shift = 64;
+  m_width = 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Printout.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Prints to output stream.
+/// Outputs the CompactHashtable's elements in insertion order.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param os is an output stream.
+/// @param htable is an CompactHashtable instance.
+/// @return reference to output stream.
+template <typename K, typename V>
+std::ostream & operator<<(std::ostream & os,
+                          const CompactHashtable<K, V> & htable) {
+  for (size_t i = 0; i < htable.m_used; ++i) {
+    os << std::setw(3) << i << ": {";
+    if (!htable.m_entries[i].removed())
+      os << '(' << htable.m_entries[i] << ')';
+    os << "}\n";
+  }
+  return os;
+}
+
+}  // namespace esr
+
+#endif  // ESR_COMPACTHASHTABLE_FLYMAKE_HPP_
@@ -0,0 +1,584 @@
+// Copyright 2016
+#ifndef ESR_CONCURRENTHASHTABLE_FLYMAKE_HPP_
+#define ESR_CONCURRENTHASHTABLE_FLYMAKE_HPP_
+////////////////////////////////////////////////////////////////////////////////
+// ConcurrentHashtable <K, V>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>        // std::atomic.
+#include <cassert>       // assert().
+#include <mutex>         // std::unique_lock.
+#include <new>           // operator new(), placement new, std::bad_alloc.
+#include <shared_mutex>  // std::shared_mutex, std::shared_lock.
+#include <type_traits>   // std::is_trivially_destructible.
+#include <utility>       // std::pair.
+
+#include <esr/hasher.hpp>      // Basic hash functions, mix().
+#include <esr/linkedlist.hpp>  // List for buckets.
+#include <esr/nodepool.hpp>    // Storage for nodes.
+
+namespace esr {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class ConcurrentHashtable.
+///
+/// @brief Thread safe Hashtable implementation.
+/// Hashing with chaining as Hashtable, buckets are guarded by
+/// reader/writer locks of stripes: a stripe owns a range of buckets
+/// next to each other, lookups share it's lock, modifications take
+/// it exclusively. Bucket number is taken from the high bits of
+/// mixed hash code and stripe number from the highest of them, so
+/// a key stays in it's stripe whatever the bucket count is: doubling
+/// splits every bucket of a stripe into two buckets of the same
+/// stripe. Every stripe has a node pool of it's own.
+/// Resize builds new bucket array without locks and takes all
+/// stripes only to swap it in. Nodes of a stripe are relinked to
+/// new buckets by the next modification of the stripe, lookups read
+/// source buckets until then. Bucket array never shrinks.
+/// Elements aren't handed out by pointer or iterator, they may be
+/// removed by another thread: get() copies the value.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H hash function: functor returning hash code of key,
+/// resolved at compile time.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V, typename H = hash_function<K>>
+class ConcurrentHashtable {
+ public:
+  /// Constructor, creates ConcurrentHashtable.
+  explicit ConcurrentHashtable(size_t stripe_count = m_StripeCountDefault);
+
+  /// Destructor, deletes ConcurrentHashtable.
+  ~ConcurrentHashtable();
+
+  /// Adds key, value to hashtable.
+  bool add(const K& key, const V& value);
+
+  /// Removes key from hashtable.
+  void remove(const K& key);
+
+  /// Sets the value by key.
+  bool set(const K& key, const V& value);
+
+  /// Gets copy of value by key.
+  bool get(const K& key, V* value) const;
+
+  /// Checks if key is in hashtable.
+  bool contains(const K& key) const;
+
+  /// Gets copy of value of key, adds key, value if key is absent.
+  std::pair<V, bool> find_or_insert(const K& key, const V& value = V());
+
+  /// Adds key, value or combines value with value of key.
+  template <typename F>
+  bool upsert(const K& key, const V& value, F combine);
+
+  /// Gets a number of elements in hashtable.
+  size_t size() const { return m_size.load(std::memory_order_relaxed); }
+
+  /// Gets a number of buckets.
+  size_t bucket_count() const {
+    return m_bucket_count.load(std::memory_order_relaxed);
+  }
+
+  /// Gets a number of stripes.
+  size_t stripe_count() const { return size_t(1) << m_stripe_bits; }
+
+ private:
+  /// Lock and node pool of a range of buckets, on a cache line of it's own.
+  struct alignas(64) stripe {
+    stripe() : m_migrated(true) {}
+    std::shared_mutex m_mutex;           ///< Lock of buckets.
+    nodepool<listnode<K, V>> m_pool;     ///< Storage of nodes.
+    bool m_migrated;                     ///< Nodes are in bucket array.
+  };
+
+  /// Locks all stripes in order of their numbers while it exists.
+  class all_stripes_lock {
+   public:
+    all_stripes_lock(stripe* stripes, size_t count) :
+        m_stripes(stripes), m_count(count) {
+      for (size_t i = 0; i < m_count; ++i)
+        m_stripes[i].m_mutex.lock();
+    }
+    ~all_stripes_lock() {
+      for (size_t i = m_count; i > 0; --i)
+        m_stripes[i - 1].m_mutex.unlock();
+    }
+   private:
+    stripe* m_stripes;
+    size_t m_count;
+  };
+
+  /// Hash function.
+  H hash;
+
+  /// Number of bits of stripe number.
+  unsigned m_stripe_bits;
+
+  /// Stripes.
+  stripe* m_stripes;
+
+  /// Number of bits of bucket number.
+  unsigned m_bits;
+
+  /// Bucket array.
+  linkedlist<K, V>* m_buckets;
+
+  /// Number of bits of bucket number of source bucket array.
+  unsigned m_old_bits;
+
+  /// Source bucket array of pending resize, nullptr if there is none.
+  linkedlist<K, V>* m_old_buckets;
+
+  /// Number of stripes whose nodes are still in source bucket array.
+  std::atomic<size_t> m_unmigrated;
+
+  /// Size of bucket array.
+  std::atomic<size_t> m_bucket_count;
+
+  /// Number of elements.
+  std::atomic<size_t> m_size;
+
+  /// Some thread is building new bucket array.
+  std::atomic<bool> m_expanding;
+
+  /// Gets number of bucket or stripe of mixed hash code.
+  static size_t index(uint64_t spread, unsigned bits) {
+    return bits == 0 ? 0 : spread >> (64 - bits);
+  }
+
+  /// Gets hash code of node's key: cached one or computed again.
+  uint64_t code_of(const listnode<K, V>& node) const {
+    return cache_hash_code<K>::value ? node.hash_code() : hash(node.key());
+  }
+
+  /// Creates bucket array, buckets take nodes from their stripes.
+  linkedlist<K, V>* make_buckets(unsigned bits);
+
+  /// Destroys buckets and releases storage of bucket array.
+  static void delete_buckets(linkedlist<K, V>* buckets, size_t count);
+
+  /// Gets the bucket of key to look up, under lock of stripe.
+  linkedlist<K, V>& read_bucket(size_t stripe_idx, uint64_t spread) const;
+
+  /// Gets the bucket of key to modify, under exclusive lock of stripe.
+  linkedlist<K, V>& write_bucket(size_t stripe_idx, uint64_t spread);
+
+  /// Adds key, value or passes value of key to found.
+  template <typename F>
+  bool insert(const K& key, const V& value, F found);
+
+  /// Relinks nodes of a stripe from source bucket array.
+  void migrate(size_t stripe_idx);
+
+  /// Doubles bucket array of bucket_count buckets.
+  void expand(size_t bucket_count);
+
+  /// Not copyable: threads share one table.
+  ConcurrentHashtable(const ConcurrentHashtable&);
+  ConcurrentHashtable& operator=(const ConcurrentHashtable&);
+
+  /// Default number of stripes.
+  static const size_t m_StripeCountDefault = 64;
+
+  /// Load factor 100%.
+  static const size_t m_LoadFactor100Percents = 100;
+
+  /// Load factor's upper theshold (%).
+  static const size_t m_LoadFactorBoundUp = 99;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V, typename H>
+const size_t ConcurrentHashtable<K, V, H>::m_StripeCountDefault;
+template <typename K, typename V, typename H>
+const size_t ConcurrentHashtable<K, V, H>::m_LoadFactor100Percents;
+template <typename K, typename V, typename H>
+const size_t ConcurrentHashtable<K, V, H>::m_LoadFactorBoundUp;
+
+////////////////////////////////////////////////////////////////////////////////
+// Constructor, Destructor.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Constructor for ConcurrentHashtable.
+/// Creates a bucket per stripe.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param stripe_count is a number of stripes, rounded up to a power
+/// of two. More stripes let more writers work at once.
+/// @return nothing.
+template <typename K, typename V, typename H>
+ConcurrentHashtable<K, V, H>::ConcurrentHashtable(size_t stripe_count) :
+    hash(),
+    m_stripe_bits(0),
+    m_stripes(nullptr),
+    m_bits(0),
+    m_buckets(nullptr),
+    m_old_bits(0),
+    m_old_buckets(nullptr),
+    m_unmigrated(0),
+    m_bucket_count(0),
+    m_size(0),
+    m_expanding(false) {
+  while ((size_t(1) << m_stripe_bits) < stripe_count)
+    ++m_stripe_bits;
+  m_stripes = new stripe[this->stripe_count()];
+  m_bits = m_stripe_bits;
+  m_buckets = make_buckets(m_bits);
+  m_bucket_count = size_t(1) << m_bits;
+}
+
+/// @brief Destructor for ConcurrentHashtable.
+/// Deletes all elements, no thread may use the table any more.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @return nothing.
+template <typename K, typename V, typename H>
+ConcurrentHashtable<K, V, H>::~ConcurrentHashtable() {
+  size_t old_bucket_count = m_old_buckets ? size_t(1) << m_old_bits : 0;
+  if (std::is_trivially_destructible<listnode<K, V>>::value) {
+    for (size_t i = 0; i < bucket_count(); ++i)
+      m_buckets[i].detach();
+    for (size_t i = 0; i < old_bucket_count; ++i)
+      m_old_buckets[i].detach();
+  }
+  delete_buckets(m_old_buckets, old_bucket_count);
+  delete_buckets(m_buckets, bucket_count());
+  delete [] m_stripes;  // pools of stripes last
+}
+
+/// @brief Creates bucket array.
+/// Every bucket takes nodes from the pool of it's stripe.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param bits is a number of bits of bucket number.
+/// @return bucket array.
+template <typename K, typename V, typename H>
+linkedlist<K, V>* ConcurrentHashtable<K, V, H>::make_buckets(unsigned bits) {
+  assert(bits >= m_stripe_bits);
+  size_t bucket_count = size_t(1) << bits;
+  linkedlist<K, V>* buckets = static_cast<linkedlist<K, V>*>(
+      ::operator new(bucket_count*sizeof(linkedlist<K, V>)));
+  for (size_t i = 0; i < bucket_count; ++i)
+    new(&buckets[i]) linkedlist<K, V>(
+        &m_stripes[i >> (bits - m_stripe_bits)].m_pool);
+  return buckets;
+}
+
+/// @brief Destroys buckets and releases storage of bucket array.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param buckets is a bucket array, may be nullptr.
+/// @param count is a number of buckets.
+/// @return nothing.
+template <typename K, typename V, typename H>
+void ConcurrentHashtable<K, V, H>::delete_buckets(linkedlist<K, V>* buckets,
+                                                  size_t count) {
+  for (size_t i = 0; i < count; ++i)
+    buckets[i].~linkedlist<K, V>();
+  ::operator delete(buckets);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Accessors and Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Adds an element.
+/// Inserts an element under exclusive lock of key's stripe. Doubles
+/// bucket array after that if load factor is greater than it's
+/// upper threshold.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param key is a key to hashtable's element.
+/// @param value is a value of hashtable's element.
+/// @return result of insertion.
+/// @retval true if an element has been successfully inserted.
+/// @retval false if an element with such key is already in a
+/// hashtable.
+template <typename K, typename V, typename H>
+bool ConcurrentHashtable<K, V, H>::add(const K& key, const V& value) {
+  return insert(key, value, [](V&) {});
+}
+
+/// @brief Removes an element.
+/// Removes an element under exclusive lock of key's stripe.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param key is a key to hashtable's element.
+/// @return nothing.
+template <typename K, typename V, typename H>
+void ConcurrentHashtable<K, V, H>::remove(const K& key) {
+  uint64_t code = hash(key);
+  uint64_t spread = mix(code);
+  size_t stripe_idx = index(spread, m_stripe_bits);
+  std::unique_lock<std::shared_mutex> lock(m_stripes[stripe_idx].m_mutex);
+  if (write_bucket(stripe_idx, spread).erase(key, code))
+    m_size.fetch_sub(1, std::memory_order_relaxed);
+}
+
+/// @brief Sets value by it's key.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param key is a key of element.
+/// @param value is a value of element.
+/// @return result of setting a value.
+/// @retval true on success.
+/// @retval false if no element with such key found in hashtable.
+template <typename K, typename V, typename H>
+bool ConcurrentHashtable<K, V, H>::set(const K& key, const V& value) {
+  uint64_t code = hash(key);
+  uint64_t spread = mix(code);
+  size_t stripe_idx = index(spread, m_stripe_bits);
+  std::unique_lock<std::shared_mutex> lock(m_stripes[stripe_idx].m_mutex);
+  listnode<K, V>* node = write_bucket(stripe_idx, spread).find(key, code);
+  if (node == nullptr)
+    return false;
+
+  node->set(value);
+  return true;
+}
+
+/// @brief Gets value by it's key.
+/// Copies value under shared lock of key's stripe.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param key is a key of element.
+/// @param value is set to a copy of value if key is found.
+/// @return true if key is found, false otherwise.
+template <typename K, typename V, typename H>
+bool ConcurrentHashtable<K, V, H>::get(const K& key, V* value) const {
+  uint64_t code = hash(key);
+  uint64_t spread = mix(code);
+  size_t stripe_idx = index(spread, m_stripe_bits);
+  std::shared_lock<std::shared_mutex> lock(m_stripes[stripe_idx].m_mutex);
+  const linkedlist<K, V>& bucket = read_bucket(stripe_idx, spread);
+  const listnode<K, V>* node = bucket.find(key, code);
+  if (node == nullptr)
+    return false;
+
+  *value = node->value();
+  return true;
+}
+
+/// @brief Checks if key is in hashtable.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param key is a key of element.
+/// @return true if key is found, false otherwise.
+template <typename K, typename V, typename H>
+bool ConcurrentHashtable<K, V, H>::contains(const K& key) const {
+  uint64_t code = hash(key);
+  uint64_t spread = mix(code);
+  size_t stripe_idx = index(spread, m_stripe_bits);
+  std::shared_lock<std::shared_mutex> lock(m_stripes[stripe_idx].m_mutex);
+  const linkedlist<K, V>& bucket = read_bucket(stripe_idx, spread);
+  return bucket.find(key, code) != nullptr;
+}
+
+/// @brief Finds an element, adds it if key is absent.
+/// Looks key up and adds it under one exclusive lock of key's
+/// stripe, hashes key once and walks it's chain once.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param key is a key to hashtable's element.
+/// @param value is a value of added element.
+/// @return copy of value of key and true if element has been added,
+/// false if it's found.
+template <typename K, typename V, typename H>
+std::pair<V, bool> ConcurrentHashtable<K, V, H>::find_or_insert(
+    const K& key, const V& value) {
+  std::pair<V, bool> result(value, false);
+  result.second = insert(key, value,
+                         [&result](V& found) { result.first = found; });
+  return result;
+}
+
+/// @brief Adds an element or combines it's value.
+/// Adds key, value if key is absent, otherwise sets value of key
+/// to combine(value of key, value), under one exclusive lock of
+/// key's stripe.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam F type of function V(const V&, const V&).
+/// @param key is a key to hashtable's element.
+/// @param value is a value to add or to combine with.
+/// @param combine is a function of value of key and value.
+/// @return true if element has been added, false if combined.
+template <typename K, typename V, typename H>
+template <typename F>
+bool ConcurrentHashtable<K, V, H>::upsert(const K& key, const V& value,
+                                          F combine) {
+  return insert(key, value,
+                [&value, &combine](V& found) {
+                  found = combine(found, value);
+                });
+}
+
+/// @brief Adds an element or passes value of key to found.
+/// Common part of add(), find_or_insert() and upsert().
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam F type of function void(V&).
+/// @param key is a key to hashtable's element.
+/// @param value is a value of added element.
+/// @param found is called under the lock with value of key if
+/// key is in hashtable.
+/// @return true if element has been added, false if it's found.
+template <typename K, typename V, typename H>
+template <typename F>
+bool ConcurrentHashtable<K, V, H>::insert(const K& key, const V& value,
+                                          F found) {
+  uint64_t code = hash(key);
+  uint64_t spread = mix(code);
+  size_t stripe_idx = index(spread, m_stripe_bits);
+  size_t bucket_count;
+  {
+    std::unique_lock<std::shared_mutex> lock(m_stripes[stripe_idx].m_mutex);
+    linkedlist<K, V>& bucket = write_bucket(stripe_idx, spread);
+    listnode<K, V>* node = bucket.find(key, code);
+    if (node != nullptr) {
+      found(node->value());
+      return false;
+    }
+    bucket.emplace_back_unique(code, key, value);
+    bucket_count = m_bucket_count.load(std::memory_order_relaxed);
+  }
+
+  size_t size = m_size.fetch_add(1, std::memory_order_relaxed) + 1;
+  if ((m_LoadFactor100Percents*size)/bucket_count >
+      m_LoadFactorBoundUp)  // unlikely
+    expand(bucket_count);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private: Buckets, Resize.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Gets the bucket of key to look up.
+/// Bucket of not yet migrated stripe is in source bucket array.
+/// Caller holds lock of the stripe.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param stripe_idx is a number of key's stripe.
+/// @param spread is a mixed hash code of key.
+/// @return reference to bucket.
+template <typename K, typename V, typename H>
+linkedlist<K, V>& ConcurrentHashtable<K, V, H>::read_bucket(
+    size_t stripe_idx, uint64_t spread) const {
+  if (!m_stripes[stripe_idx].m_migrated)  // unlikely
+    return m_old_buckets[index(spread, m_old_bits)];
+  return m_buckets[index(spread, m_bits)];
+}
+
+/// @brief Gets the bucket of key to modify.
+/// Migrates the stripe first if it's nodes are still in source
+/// bucket array. Caller holds exclusive lock of the stripe.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param stripe_idx is a number of key's stripe.
+/// @param spread is a mixed hash code of key.
+/// @return reference to bucket.
+template <typename K, typename V, typename H>
+linkedlist<K, V>& ConcurrentHashtable<K, V, H>::write_bucket(
+    size_t stripe_idx, uint64_t spread) {
+  if (!m_stripes[stripe_idx].m_migrated)  // unlikely
+    migrate(stripe_idx);
+  return m_buckets[index(spread, m_bits)];
+}
+
+/// @brief Relinks nodes of a stripe from source bucket array.
+/// Nodes are neither copied nor reallocated, they stay in buckets of
+/// the same stripe. The last migrated stripe deletes source bucket
+/// array: no lookup reads it any more. Caller holds exclusive lock
+/// of the stripe.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param stripe_idx is a number of stripe.
+/// @return nothing.
+template <typename K, typename V, typename H>
+void ConcurrentHashtable<K, V, H>::migrate(size_t stripe_idx) {
+  assert(!m_stripes[stripe_idx].m_migrated);
+  unsigned range_bits = m_old_bits - m_stripe_bits;
+  size_t first = stripe_idx << range_bits;
+  size_t last = first + (size_t(1) << range_bits);
+  for (size_t i = first; i < last; ++i)
+    while (listnode<K, V>* node = m_old_buckets[i].unlink_front())
+      m_buckets[index(mix(code_of(*node)), m_bits)].link_front(node);
+  m_stripes[stripe_idx].m_migrated = true;
+
+  if (m_unmigrated.fetch_sub(1) == 1) {  // the last one
+    delete_buckets(m_old_buckets, size_t(1) << m_old_bits);
+    m_old_buckets = nullptr;
+  }
+}
+
+/// @brief Doubles bucket array.
+/// Builds new bucket array without locks, then takes all stripes to
+/// finish pending resize and swap new array in. Does nothing if
+/// another thread expands or has expanded the array, or if there
+/// is no memory for new array: the table stays valid.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param bucket_count is a size of bucket array to double.
+/// @return nothing.
+template <typename K, typename V, typename H>
+void ConcurrentHashtable<K, V, H>::expand(size_t bucket_count) {
+  bool expanding = false;
+  if (!m_expanding.compare_exchange_strong(expanding, true))
+    return;  // another thread expands
+
+  unsigned bits = 0;
+  while ((size_t(1) << bits) < 2*bucket_count)
+    ++bits;
+  linkedlist<K, V>* table = nullptr;
+  try {
+    table = make_buckets(bits);
+  } catch (const std::bad_alloc&) {
+    m_expanding = false;
+    return;
+  }
+
+  {
+    all_stripes_lock lock(m_stripes, stripe_count());
+    if (m_bucket_count.load(std::memory_order_relaxed) != bucket_count) {
+      delete_buckets(table, size_t(1) << bits);  // expanded already
+    } else {
+      for (size_t i = 0; i < stripe_count(); ++i)
+        if (!m_stripes[i].m_migrated)  // unlikely
+          migrate(i);
+      m_old_buckets = m_buckets;
+      m_old_bits = m_bits;
+      m_buckets = table;
+      m_bits = bits;
+      for (size_t i = 0; i < stripe_count(); ++i)
+        m_stripes[i].m_migrated = false;
+      m_unmigrated = stripe_count();
+      m_bucket_count = size_t(1) << bits;
+    }
+  }
+  m_expanding = false;
+}
+
+}  // namespace esr
+
+#endif  // ESR_CONCURRENTHASHTABLE_FLYMAKE_HPP_
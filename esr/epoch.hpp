@@ -0,0 +1,132 @@
+// Copyright 2016
+#ifndef ESR_EPOCH_FLYMAKE_HPP_
+#define ESR_EPOCH_FLYMAKE_HPP_
+////////////////////////////////////////////////////////////////////////////////
+// Epoch based reclamation.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>   // std::atomic.
+#include <cstddef>  // size_t.
+#include <cstdint>  // uint64_t.
+
+namespace esr {
+
+/// @brief Gets a number of calling thread.
+/// Threads are numbered in order of their first call, the number
+/// spreads threads over reader slots of epoch domains.
+/// @return number of calling thread.
+inline size_t thread_number() {
+  static std::atomic<size_t> next(0);
+  thread_local size_t number = next.fetch_add(1, std::memory_order_relaxed);
+  return number;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class epoch_domain.
+///
+/// @brief Tells when memory unlinked by writers is no longer read.
+/// Readers announce themselves in a slot of their thread for the
+/// current epoch, which costs no lock and no cache line shared by
+/// all readers. Writers are serialized by their owner: they unlink
+/// memory, retire it in the current epoch and advance the epoch
+/// when no reader of the previous one is left. Memory retired in
+/// epoch e is not reachable by any reader once epoch is e + 2.
+/// Epoch parity is enough to count readers: readers of epochs e - 1
+/// and e + 1 share a counter, and there is none of the latter while
+/// epoch is e.
+////////////////////////////////////////////////////////////////////////////////
+class epoch_domain {
+ public:
+  /// Read side critical section, memory read by it isn't reclaimed.
+  class reader {
+   public:
+    explicit reader(const epoch_domain& domain) :
+        m_counter(domain.enter()) {}
+    ~reader() { m_counter->fetch_sub(1, std::memory_order_release); }
+   private:
+    std::atomic<size_t>* m_counter;
+    reader(const reader&);
+    reader& operator=(const reader&);
+  };
+
+  /// @brief Constructor, creates epoch domain.
+  /// @param slot_count is a number of reader slots, rounded up to a
+  /// power of two: threads beyond it share slots.
+  /// @return nothing.
+  explicit epoch_domain(size_t slot_count = m_SlotCountDefault) :
+      m_epoch(0), m_slots(nullptr), m_mask(0) {
+    size_t count = 1;
+    while (count < slot_count)
+      count += count;
+    m_slots = new slot[count];
+    m_mask = count - 1;
+  }
+
+  /// Destructor, no reader may be left.
+  ~epoch_domain() { delete [] m_slots; }
+
+  /// Gets current epoch, memory unlinked now is retired in it.
+  uint64_t epoch() const { return m_epoch.load(); }
+
+  /// @brief Advances epoch if no reader of previous epoch is left.
+  /// Called by one writer at a time.
+  /// @return true if epoch has been advanced.
+  bool try_advance() {
+    uint64_t epoch = m_epoch.load();
+    for (size_t i = 0; i <= m_mask; ++i)
+      if (m_slots[i].m_readers[(epoch + 1) & 1].load() != 0)
+        return false;
+    m_epoch.store(epoch + 1);
+    return true;
+  }
+
+  /// @brief Checks if memory retired in an epoch may be reclaimed.
+  /// @param retired is an epoch memory was retired in.
+  /// @return true if no reader can reach it.
+  bool safe(uint64_t retired) const { return retired + 2 <= epoch(); }
+
+ private:
+  /// Reader counters of a slot by epoch parity, on a cache line of
+  /// it's own.
+  struct alignas(64) slot {
+    slot() { m_readers[0] = 0; m_readers[1] = 0; }
+    std::atomic<size_t> m_readers[2];
+  };
+
+  /// Current epoch.
+  std::atomic<uint64_t> m_epoch;
+
+  /// Reader slots.
+  slot* m_slots;
+
+  /// Number of slots minus one.
+  size_t m_mask;
+
+  /// @brief Enters read side critical section.
+  /// Counts the reader in current epoch. Epoch is checked again
+  /// after that: a writer might have advanced it without seeing the
+  /// reader.
+  /// @return reader counter to decrement on leave.
+  std::atomic<size_t>* enter() const {
+    slot& own = m_slots[thread_number() & m_mask];
+    for (;;) {
+      uint64_t epoch = m_epoch.load();
+      std::atomic<size_t>* counter = &own.m_readers[epoch & 1];
+      counter->fetch_add(1);
+      if (m_epoch.load() == epoch)
+        return counter;
+      counter->fetch_sub(1);  // unlikely
+    }
+  }
+
+  /// Not copyable: readers and writers share one domain.
+  epoch_domain(const epoch_domain&);
+  epoch_domain& operator=(const epoch_domain&);
+
+  /// Default number of reader slots.
+  static const size_t m_SlotCountDefault = 64;
+};
+
+}  // namespace esr
+
+#endif  // ESR_EPOCH_FLYMAKE_HPP_
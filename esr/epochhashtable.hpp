@@ -0,0 +1,622 @@
+// Copyright 2016
+#ifndef ESR_EPOCHHASHTABLE_FLYMAKE_HPP_
+#define ESR_EPOCHHASHTABLE_FLYMAKE_HPP_
+////////////////////////////////////////////////////////////////////////////////
+// EpochHashtable <K, V>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>   // std::atomic.
+#include <mutex>    // std::mutex, std::lock_guard.
+#include <new>      // std::bad_alloc.
+#include <utility>  // std::pair, std::forward.
+
+#include <esr/epoch.hpp>     // epoch_domain.
+#include <esr/hasher.hpp>    // Basic hash functions, mix().
+#include <esr/nodepool.hpp>  // Storage for nodes.
+
+namespace esr {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class EpochHashtable.
+///
+/// @brief Thread safe Hashtable with lock free lookups.
+/// Hashing with chaining as Hashtable, for tables read much more often
+/// than they are modified. Lookups take no lock: they announce
+/// themselves in an epoch_domain and walk buckets by atomic
+/// pointers. Writers are serialized by a mutex and never change a
+/// node readers may see, except for it's link: a new node is
+/// published by a release store of the link to it, set() and upsert()
+/// publish a new node in place of the old one. Unlinked nodes are
+/// retired and returned to the node pool two epochs later, when no
+/// lookup can reach them. Resize copies elements into a new bucket
+/// array, publishes it and retires the old array with it's nodes as
+/// a whole: lookups in flight finish on the old array. Retired
+/// memory is reclaimed by later modifications. Bucket array never
+/// shrinks.
+/// Interface is the one of ConcurrentHashtable.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H hash function: functor returning hash code of key,
+/// resolved at compile time.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V, typename H = hash_function<K>>
+class EpochHashtable {
+ public:
+  /// Constructor, creates EpochHashtable.
+  explicit EpochHashtable(size_t slot_count = m_SlotCountDefault);
+
+  /// Destructor, deletes EpochHashtable.
+  ~EpochHashtable();
+
+  /// Adds key, value to hashtable.
+  bool add(const K& key, const V& value);
+
+  /// Removes key from hashtable.
+  void remove(const K& key);
+
+  /// Sets the value by key.
+  bool set(const K& key, const V& value);
+
+  /// Gets copy of value by key.
+  bool get(const K& key, V* value) const;
+
+  /// Checks if key is in hashtable.
+  bool contains(const K& key) const;
+
+  /// Gets copy of value of key, adds key, value if key is absent.
+  std::pair<V, bool> find_or_insert(const K& key, const V& value = V());
+
+  /// Adds key, value or combines value with value of key.
+  template <typename F>
+  bool upsert(const K& key, const V& value, F combine);
+
+  /// Gets a number of elements in hashtable.
+  size_t size() const { return m_size.load(std::memory_order_relaxed); }
+
+  /// Gets a number of buckets. Kept apart from bucket array, which a
+  /// writer may retire meanwhile: reads it without entering epoch.
+  size_t bucket_count() const {
+    return m_bucket_count.load(std::memory_order_relaxed);
+  }
+
+ private:
+  /// Element, immutable once published but for the link.
+  struct node {
+    node(uint64_t code, const K& key, const V& value) :
+        m_next(nullptr), m_retired(nullptr), m_code(code), m_key(key),
+        m_value(value) {}
+    std::atomic<node*> m_next;  ///< Next node of bucket.
+    node* m_retired;            ///< Next retired node.
+    const uint64_t m_code;      ///< Hash code of key.
+    const K m_key;              ///< Key.
+    const V m_value;            ///< Value.
+  };
+
+  /// Bucket array.
+  struct table {
+    explicit table(unsigned bits) :
+        m_bits(bits),
+        m_buckets(new std::atomic<node*>[size_t(1) << bits]()),
+        m_retired(nullptr) {}
+    ~table() { delete [] m_buckets; }
+    /// Gets bucket of hash code.
+    std::atomic<node*>& bucket(uint64_t code) const {
+      return m_buckets[m_bits == 0 ? 0 : mix(code) >> (64 - m_bits)];
+    }
+    unsigned m_bits;                ///< Number of bits of bucket number.
+    std::atomic<node*>* m_buckets;  ///< First nodes of buckets.
+    table* m_retired;               ///< Next retired bucket array.
+  };
+
+  /// Memory retired in one epoch.
+  struct bag {
+    bag() : m_epoch(0), m_nodes(nullptr), m_tables(nullptr) {}
+    uint64_t m_epoch;  ///< Epoch memory was retired in.
+    node* m_nodes;     ///< Retired nodes.
+    table* m_tables;   ///< Retired bucket arrays with their nodes.
+  };
+
+  /// Hash function.
+  H hash;
+
+  /// Readers of nodes and bucket arrays.
+  epoch_domain m_domain;
+
+  /// Bucket array.
+  std::atomic<table*> m_table;
+
+  /// Number of buckets of published bucket array.
+  std::atomic<size_t> m_bucket_count;
+
+  /// Number of elements.
+  std::atomic<size_t> m_size;
+
+  /// Serializes writers.
+  std::mutex m_writer;
+
+  /// Storage of nodes, used by writers only.
+  nodepool<node> m_pool;
+
+  /// Retired memory of last epochs: e goes to bag e % 3, a bag is
+  /// reused when it's memory is safe to reclaim.
+  bag m_bags[3];
+
+  /// Walks bucket of key with lock free loads, found gets the node.
+  template <typename F>
+  bool lookup(const K& key, F found) const;
+
+  /// Finds key and link to it's node, under writer lock.
+  node* locate(const K& key, uint64_t code, std::atomic<node*>** link) const;
+
+  /// Adds key, value or passes link and node of key to found.
+  template <typename F>
+  bool insert(const K& key, const V& value, F found);
+
+  /// Publishes new node of value in place of node.
+  void replace(std::atomic<node*>* link, node* old, const V& value);
+
+  /// Gets bag of current epoch.
+  bag* current_bag();
+
+  /// Retires unlinked node.
+  void retire(node* unlinked);
+
+  /// Advances epoch and reclaims memory no lookup can reach.
+  void collect();
+
+  /// Returns nodes and bucket arrays of bag to the pool.
+  void reclaim(bag* garbage);
+
+  /// Destroys nodes of bucket array and the array.
+  void destroy(table* buckets);
+
+  /// Doubles bucket array.
+  void expand();
+
+  /// Not copyable: threads share one table.
+  EpochHashtable(const EpochHashtable&);
+  EpochHashtable& operator=(const EpochHashtable&);
+
+  /// Default number of reader slots.
+  static const size_t m_SlotCountDefault = 64;
+
+  /// Default number of bits of bucket number.
+  static const unsigned m_BitsDefault = 4;
+
+  /// Load factor 100%.
+  static const size_t m_LoadFactor100Percents = 100;
+
+  /// Load factor's upper theshold (%).
+  static const size_t m_LoadFactorBoundUp = 99;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V, typename H>
+const size_t EpochHashtable<K, V, H>::m_SlotCountDefault;
+template <typename K, typename V, typename H>
+const unsigned EpochHashtable<K, V, H>::m_BitsDefault;
+template <typename K, typename V, typename H>
+const size_t EpochHashtable<K, V, H>::m_LoadFactor100Percents;
+template <typename K, typename V, typename H>
+const size_t EpochHashtable<K, V, H>::m_LoadFactorBoundUp;
+
+////////////////////////////////////////////////////////////////////////////////
+// Constructor, Destructor.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Constructor for EpochHashtable.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param slot_count is a number of reader slots of epoch domain,
+/// rounded up to a power of two. Reader threads beyond it share
+/// slots.
+/// @return nothing.
+template <typename K, typename V, typename H>
+EpochHashtable<K, V, H>::EpochHashtable(size_t slot_count) :
+    hash(),
+    m_domain(slot_count),
+    m_table(new table(m_BitsDefault)),
+    m_bucket_count(size_t(1) << m_BitsDefault),
+    m_size(0),
+    m_writer(),
+    m_pool() {}
+
+/// @brief Destructor for EpochHashtable.
+/// Deletes all elements and retired memory, no thread may use the
+/// table any more.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @return nothing.
+template <typename K, typename V, typename H>
+EpochHashtable<K, V, H>::~EpochHashtable() {
+  for (bag& garbage : m_bags)
+    reclaim(&garbage);
+  destroy(m_table.load(std::memory_order_relaxed));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Accessors and Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Adds an element.
+/// Publishes new node at the front of key's bucket. Doubles bucket
+/// array after that if load factor is greater than it's upper
+/// threshold.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param key is a key to hashtable's element.
+/// @param value is a value of hashtable's element.
+/// @return result of insertion.
+/// @retval true if an element has been successfully inserted.
+/// @retval false if an element with such key is already in a
+/// hashtable.
+template <typename K, typename V, typename H>
+bool EpochHashtable<K, V, H>::add(const K& key, const V& value) {
+  return insert(key, value, [](std::atomic<node*>*, node*) {});
+}
+
+/// @brief Removes an element.
+/// Unlinks key's node and retires it: lookups in flight may still
+/// read it.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param key is a key to hashtable's element.
+/// @return nothing.
+template <typename K, typename V, typename H>
+void EpochHashtable<K, V, H>::remove(const K& key) {
+  std::lock_guard<std::mutex> lock(m_writer);
+  std::atomic<node*>* link;
+  node* found = locate(key, hash(key), &link);
+  if (found != nullptr) {
+    link->store(found->m_next.load(std::memory_order_relaxed),
+                std::memory_order_release);
+    retire(found);
+    m_size.fetch_sub(1, std::memory_order_relaxed);
+  }
+  collect();
+}
+
+/// @brief Sets value by it's key.
+/// Publishes new node of key and value in place of the old one.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param key is a key of element.
+/// @param value is a value of element.
+/// @return result of setting a value.
+/// @retval true on success.
+/// @retval false if no element with such key found in hashtable.
+template <typename K, typename V, typename H>
+bool EpochHashtable<K, V, H>::set(const K& key, const V& value) {
+  std::lock_guard<std::mutex> lock(m_writer);
+  std::atomic<node*>* link;
+  node* found = locate(key, hash(key), &link);
+  if (found != nullptr)
+    replace(link, found, value);
+  collect();
+  return found != nullptr;
+}
+
+/// @brief Gets value by it's key.
+/// Takes no lock.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param key is a key of element.
+/// @param value is set to a copy of value if key is found.
+/// @return true if key is found, false otherwise.
+template <typename K, typename V, typename H>
+bool EpochHashtable<K, V, H>::get(const K& key, V* value) const {
+  return lookup(key, [value](const node& found) { *value = found.m_value; });
+}
+
+/// @brief Checks if key is in hashtable.
+/// Takes no lock.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param key is a key of element.
+/// @return true if key is found, false otherwise.
+template <typename K, typename V, typename H>
+bool EpochHashtable<K, V, H>::contains(const K& key) const {
+  return lookup(key, [](const node&) {});
+}
+
+/// @brief Finds an element, adds it if key is absent.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param key is a key to hashtable's element.
+/// @param value is a value of added element.
+/// @return copy of value of key and true if element has been added,
+/// false if it's found.
+template <typename K, typename V, typename H>
+std::pair<V, bool> EpochHashtable<K, V, H>::find_or_insert(const K& key,
+                                                           const V& value) {
+  std::pair<V, bool> result(value, false);
+  result.second = insert(key, value,
+                         [&result](std::atomic<node*>*, node* found) {
+                           result.first = found->m_value;
+                         });
+  return result;
+}
+
+/// @brief Adds an element or combines it's value.
+/// Adds key, value if key is absent, otherwise publishes new node of
+/// key and combine(value of key, value) in place of the old one.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam F type of function V(const V&, const V&).
+/// @param key is a key to hashtable's element.
+/// @param value is a value to add or to combine with.
+/// @param combine is a function of value of key and value.
+/// @return true if element has been added, false if combined.
+template <typename K, typename V, typename H>
+template <typename F>
+bool EpochHashtable<K, V, H>::upsert(const K& key, const V& value,
+                                     F combine) {
+  return insert(key, value,
+                [this, &value, &combine](std::atomic<node*>* link,
+                                         node* found) {
+                  replace(link, found, combine(found->m_value, value));
+                });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private: Lookups, Insertion.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Walks bucket of key with lock free loads.
+/// Bucket array and nodes read are not reclaimed until the lookup
+/// leaves epoch domain.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam F type of function void(const node&).
+/// @param key is a key of element.
+/// @param found is called with node of key if key is found.
+/// @return true if key is found, false otherwise.
+template <typename K, typename V, typename H>
+template <typename F>
+bool EpochHashtable<K, V, H>::lookup(const K& key, F found) const {
+  uint64_t code = hash(key);
+  epoch_domain::reader reader(m_domain);
+  const table* buckets = m_table.load(std::memory_order_acquire);
+  const node* current = buckets->bucket(code).load(std::memory_order_acquire);
+  for (; current != nullptr;
+       current = current->m_next.load(std::memory_order_acquire)) {
+    if (current->m_code == code && current->m_key == key) {
+      found(*current);
+      return true;
+    }
+  }
+  return false;
+}
+
+/// @brief Finds key and link to it's node.
+/// Caller holds writer lock: links don't change under it.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param key is a key of element.
+/// @param code is hash code of key.
+/// @param link is set to the link to key's node if key is found, to
+/// the last link of key's bucket otherwise.
+/// @return node of key, nullptr if key is absent.
+template <typename K, typename V, typename H>
+typename EpochHashtable<K, V, H>::node* EpochHashtable<K, V, H>::locate(
+    const K& key, uint64_t code, std::atomic<node*>** link) const {
+  *link = &m_table.load(std::memory_order_relaxed)->bucket(code);
+  for (node* current = (*link)->load(std::memory_order_relaxed);
+       current != nullptr;
+       current = (*link)->load(std::memory_order_relaxed)) {
+    if (current->m_code == code && current->m_key == key)
+      return current;
+    *link = &current->m_next;
+  }
+  return nullptr;
+}
+
+/// @brief Adds an element or passes it's node to found.
+/// Common part of add(), find_or_insert() and upsert(): new node is
+/// initialized first and then published by one release store.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam F type of function void(std::atomic<node*>*, node*).
+/// @param key is a key to hashtable's element.
+/// @param value is a value of added element.
+/// @param found is called under writer lock with link to node of
+/// key and the node if key is in hashtable.
+/// @return true if element has been added, false if it's found.
+template <typename K, typename V, typename H>
+template <typename F>
+bool EpochHashtable<K, V, H>::insert(const K& key, const V& value,
+                                     F found) {
+  uint64_t code = hash(key);
+  std::lock_guard<std::mutex> lock(m_writer);
+  std::atomic<node*>* link;
+  node* current = locate(key, code, &link);
+  if (current != nullptr) {
+    found(link, current);
+    collect();
+    return false;
+  }
+
+  link->store(m_pool.create(code, key, value), std::memory_order_release);
+  size_t size = m_size.fetch_add(1, std::memory_order_relaxed) + 1;
+  if ((m_LoadFactor100Percents*size)/bucket_count() >
+      m_LoadFactorBoundUp)  // unlikely
+    expand();
+  collect();
+  return true;
+}
+
+/// @brief Publishes new node in place of a node.
+/// The new node takes the link of the old one, which is retired.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param link is the link to node.
+/// @param old is a node to replace.
+/// @param value is a value of new node.
+/// @return nothing.
+template <typename K, typename V, typename H>
+void EpochHashtable<K, V, H>::replace(std::atomic<node*>* link, node* old,
+                                      const V& value) {
+  node* replacement = m_pool.create(old->m_code, old->m_key, value);
+  replacement->m_next.store(old->m_next.load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+  link->store(replacement, std::memory_order_release);
+  retire(old);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private: Reclamation, Resize.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Gets bag of current epoch.
+/// Memory left in the bag since three or more epochs ago is
+/// reclaimed before reuse.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @return bag to retire memory to.
+template <typename K, typename V, typename H>
+typename EpochHashtable<K, V, H>::bag* EpochHashtable<K, V, H>::current_bag() {
+  uint64_t epoch = m_domain.epoch();
+  bag* garbage = &m_bags[epoch % 3];
+  if (garbage->m_epoch != epoch) {
+    reclaim(garbage);
+    garbage->m_epoch = epoch;
+  }
+  return garbage;
+}
+
+/// @brief Retires unlinked node in current epoch.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param unlinked is a node no longer reachable from buckets.
+/// @return nothing.
+template <typename K, typename V, typename H>
+void EpochHashtable<K, V, H>::retire(node* unlinked) {
+  bag* garbage = current_bag();
+  unlinked->m_retired = garbage->m_nodes;
+  garbage->m_nodes = unlinked;
+}
+
+/// @brief Advances epoch and reclaims memory no lookup can reach.
+/// Does nothing without retired memory: epoch stays still and
+/// lookups don't miss it in cache.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @return nothing.
+template <typename K, typename V, typename H>
+void EpochHashtable<K, V, H>::collect() {
+  bool retired = false;
+  for (bag& garbage : m_bags)
+    retired |= garbage.m_nodes != nullptr || garbage.m_tables != nullptr;
+  if (!retired)
+    return;
+
+  m_domain.try_advance();
+  for (bag& garbage : m_bags)
+    if (m_domain.safe(garbage.m_epoch))
+      reclaim(&garbage);
+}
+
+/// @brief Returns retired nodes and bucket arrays to the pool.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param garbage is a bag of memory no lookup can reach.
+/// @return nothing.
+template <typename K, typename V, typename H>
+void EpochHashtable<K, V, H>::reclaim(bag* garbage) {
+  while (node* retired = garbage->m_nodes) {
+    garbage->m_nodes = retired->m_retired;
+    m_pool.destroy(retired);
+  }
+  while (table* retired = garbage->m_tables) {
+    garbage->m_tables = retired->m_retired;
+    destroy(retired);
+  }
+}
+
+/// @brief Destroys nodes of bucket array and the array.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param buckets is a bucket array no lookup can reach.
+/// @return nothing.
+template <typename K, typename V, typename H>
+void EpochHashtable<K, V, H>::destroy(table* buckets) {
+  for (size_t i = 0; i < (size_t(1) << buckets->m_bits); ++i) {
+    node* current = buckets->m_buckets[i].load(std::memory_order_relaxed);
+    while (current != nullptr) {
+      node* next = current->m_next.load(std::memory_order_relaxed);
+      m_pool.destroy(current);
+      current = next;
+    }
+  }
+  delete buckets;
+}
+
+/// @brief Doubles bucket array.
+/// Copies elements into new bucket array and publishes it: nodes of
+/// the old array are still read by lookups and can't be relinked.
+/// The old array is retired with it's nodes. Does nothing if there
+/// is no memory for new array: the table stays valid. Exception of
+/// copy constructor of K or V is passed on, the table stays valid.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @return nothing.
+template <typename K, typename V, typename H>
+void EpochHashtable<K, V, H>::expand() {
+  table* old = m_table.load(std::memory_order_relaxed);
+  table* buckets = nullptr;
+  try {
+    buckets = new table(old->m_bits + 1);
+    for (size_t i = 0; i < (size_t(1) << old->m_bits); ++i) {
+      for (node* current = old->m_buckets[i].load(std::memory_order_relaxed);
+           current != nullptr;
+           current = current->m_next.load(std::memory_order_relaxed)) {
+        std::atomic<node*>& bucket = buckets->bucket(current->m_code);
+        node* copy = m_pool.create(current->m_code, current->m_key,
+                                   current->m_value);
+        copy->m_next.store(bucket.load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+        bucket.store(copy, std::memory_order_relaxed);
+      }
+    }
+  } catch (const std::bad_alloc&) {
+    if (buckets != nullptr)
+      destroy(buckets);
+    return;  // the old array stays, overloaded
+  } catch (...) {
+    if (buckets != nullptr)
+      destroy(buckets);
+    throw;
+  }
+
+  m_table.store(buckets, std::memory_order_release);
+  m_bucket_count.store(size_t(1) << buckets->m_bits,
+                       std::memory_order_relaxed);
+  bag* garbage = current_bag();
+  old->m_retired = garbage->m_tables;
+  garbage->m_tables = old;
+}
+
+}  // namespace esr
+
+#endif  // ESR_EPOCHHASHTABLE_FLYMAKE_HPP_
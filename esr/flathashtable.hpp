@@ -0,0 +1,675 @@
+// Copyright 2016
+#ifndef ESR_FLATHASHTABLE_FLYMAKE_HPP_
+#define ESR_FLATHASHTABLE_FLYMAKE_HPP_
+////////////////////////////////////////////////////////////////////////////////
+// FlatHashtable <K, V>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <ostream>    // operator<<().
+#include <iomanip>    // operator<<().
+#include <cassert>    // assert().
+#include <algorithm>  // std::swap().
+#include <memory>     // std::unique_ptr.
+#include <utility>    // std::move().
+
+#include <esr/hasher.hpp>      // Basic hash functions.
+#include <esr/hashexcept.hpp>  // Hashtable's specific exceptions.
+
+namespace esr {
+
+template <typename K, typename V>
+class FlatHashtable;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class flatentry.
+///
+/// @brief Slot of FlatHashtable.
+/// Slot contains key, value and a distance from the slot
+/// the key is hashed to (probe sequence length).
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V>
+class flatentry {
+  template <typename KK, typename VV>
+  friend class FlatHashtable;
+ public:
+  /// Default constructor, creates empty slot.
+  flatentry() : m_distance(0) {}
+
+  /// @brief Gets key.
+  /// Returns reference to key.
+  const K& key() const { return m_key; }
+
+  /// @brief Gets mutable value.
+  /// Returns reference to value.
+  V& value() { return m_value; }
+
+  /// @brief Gets immutable value.
+  /// Returns reference to value.
+  const V& value() const { return m_value; }
+
+  /// @brief Sets the value.
+  void set(const V& value) { m_value = value; }
+
+  /// @brief Is slot empty or not.
+  bool empty() const { return m_distance == 0; }
+
+  /// @brief Printout slot.
+  friend std::ostream & operator<<(std::ostream & os,
+                                  const flatentry<K, V>& entry) {
+    return os << entry.m_key <<"=>"<< entry.m_value;
+  }
+
+ private:
+  K m_key;
+  V m_value;
+  uint32_t m_distance;  //< Probe sequence length plus one, 0 if slot is empty.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class FlatHashtable.
+///
+/// @brief Open addressing Hashtable implementation.
+/// Data structure uses Robin Hood linear probing over one
+/// contiguous array of slots, a power of two in size. An element
+/// which is farther from it's home slot takes the place of an
+/// element which is closer to it's home slot. Removal shifts following
+/// elements backward, so no tombstones are needed.
+/// Has the same interface as Hashtable.
+/// @tparam K type of hash key, must be default constructible.
+/// @tparam V type of hash value, must be default constructible.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V>
+class FlatHashtable {
+ public:
+  class iterator;
+
+  /// Default constructor, creates FlatHashtable.
+  explicit FlatHashtable(
+      size_t load_factor_bound_low = m_LoadFactorBoundLowDefault,
+      size_t load_factor_bound_up = m_LoadFactorBoundUpDefault);
+
+  /// Copy constructor, creates copy of FlatHashtable.
+  FlatHashtable(const FlatHashtable& other);
+
+  /// Destructor, deletes FlatHashtable.
+  virtual ~FlatHashtable();
+
+  /// Assignment operator.
+  FlatHashtable& operator=(FlatHashtable other);
+
+  /// Adds key, value to hashtable.
+  bool add(const K& key, const V& value);
+
+  /// Removes key from hashtable.
+  void remove(const K& key);
+
+  /// Sets the value by key.
+  bool set(const K& key, const V& value);
+
+  /// Gets constant pointer to value by key.
+  const V* get(const K& key) const;
+
+  /// Finds a value by key.
+  iterator find(const K& key);
+
+  /// Gets a number of elements in hashtable.
+  size_t size() const { return m_size; }
+
+  /// Gets a number of occupied slots in percents.
+  size_t load_factor() const {
+    return (
+        (m_capacity == 0) ?
+        0 : (m_LoadFactor100Percents*m_size)/m_capacity);
+  }
+
+  /// Hashtable's printer.
+  template <typename KK, typename VV>
+  friend std::ostream & operator<<(std::ostream & os,
+                                   const FlatHashtable<KK, VV> & ht);
+
+  /// Forward iterator.
+  class iterator {
+   public:
+    /// @brief Creates FlatHashtable's iterator.
+    /// @param owner is a FlatHashtable object, owner of the iterator.
+    /// @param current_slot_idx is a number of the current slot
+    /// in slot array.
+    explicit iterator(FlatHashtable* owner, size_t current_slot_idx) :
+        m_owner(owner),
+        m_current_slot_idx(current_slot_idx) {}
+
+    /// Advances the iterator to the next element.
+    iterator& operator++();
+
+    /// Dereferenses an iterator.
+    flatentry<K, V>& operator*();
+
+    /// Dereferenses an iterator.
+    flatentry<K, V>* operator->();
+
+    /// Inequality comparison of iterators.
+    bool operator!=(const iterator& rhs) {
+      return m_current_slot_idx != rhs.m_current_slot_idx;
+    }
+
+    /// Equality comparison of iterators.
+    bool operator==(const iterator& rhs) {
+      return m_current_slot_idx == rhs.m_current_slot_idx;
+    }
+
+   private:
+    /// Owner of the iterator.
+    FlatHashtable* m_owner;
+
+    /// Number of the current slot in the slot array,
+    /// capacity for the end iterator.
+    size_t m_current_slot_idx;
+  };
+
+  /// Gets the beginning of FlatHashtable.
+  iterator begin();
+
+  /// Gets the end of FlatHashtable.
+  iterator end() { return iterator(this, m_capacity); }
+
+ private:
+  /// Number of elements in FlatHashtable.
+  uint64_t m_size;
+
+  /// Hash function to get hash code of key.
+  hash_function<K> hash;
+
+  /// Seed of the slot array, changed by every resize.
+  uint64_t m_seed;
+
+  /// Shift of mixed hash code, 64 - log2(capacity).
+  size_t m_shift;
+
+  /// Load factor low threshold.
+  size_t m_load_factor_bound_low;
+
+  /// Load factor upper threshold.
+  size_t m_load_factor_bound_up;
+
+  /// Number of slots in FlatHashtable, size of slot array.
+  size_t m_capacity;
+
+  /// Slot array.
+  flatentry<K, V>* m_slots;
+
+  /// Gets home slot of the key. Mixes hash code with the seed and
+  /// takes the high bits, so keys with regular codes, like even
+  /// integers, spread over the whole slot array. A new seed for
+  /// every slot array keeps elements taken in slot order of one
+  /// table from piling up in one region of another.
+  size_t home(const K& key) const { return home_of(hash.code(key)); }
+
+  /// Gets home slot of the hash code of a key.
+  size_t home_of(uint64_t code) const {
+    return mix(code ^ m_seed) >> m_shift;
+  }
+
+  /// Gets index of the slot holding the key or capacity if none.
+  size_t lookup(const K& key) const;
+
+  /// Gets index of the slot following the given one.
+  size_t next(size_t slot_idx) const {
+    return (slot_idx + 1 == m_capacity) ? 0 : slot_idx + 1;
+  }
+
+  /// Places an element known to be absent, moving it from the given slot.
+  void place(flatentry<K, V>* entry);
+
+  /// Resizes slot array, to new size.
+  /// @param capacity is a size of resized slot array.
+  void resize(size_t capacity);
+
+  /// Load factor 100%.
+  static const size_t m_LoadFactor100Percents = 100;  // size == slots, 100%.
+
+  /// Default value of load factor's low theshold (%).
+  static const size_t m_LoadFactorBoundLowDefault = 30;
+
+  /// Default value of load factor's upper theshold (%).
+  static const size_t m_LoadFactorBoundUpDefault = 90;
+
+  /// Capacity of the first slot array.
+  static const size_t m_MinCapacity = 8;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V>
+const size_t FlatHashtable<K, V>::m_LoadFactor100Percents;
+template <typename K, typename V>
+const size_t FlatHashtable<K, V>::m_LoadFactorBoundUpDefault;
+template <typename K, typename V>
+const size_t FlatHashtable<K, V>::m_LoadFactorBoundLowDefault;
+template <typename K, typename V>
+const size_t FlatHashtable<K, V>::m_MinCapacity;
+
+////////////////////////////////////////////////////////////////////////////////
+// Constructors, Destructor and Assignment.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Default constructor for FlatHashtable.
+/// Creates FlatHashtable with load factor's low
+/// and upper thresholds. No slot array is allocated
+/// until the first element is added.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param load_factor_bound_low is a load factor's low threshold.
+/// @param load_factor_bound_up is a load factor's upper threshold.
+/// @return nothing.
+template <typename K, typename V>
+FlatHashtable<K, V>::FlatHashtable(size_t load_factor_bound_low,
+                                   size_t load_factor_bound_up) :
+    m_size(0),
+    hash(),
+    m_seed(0),
+    m_shift(64),
+    m_load_factor_bound_low(load_factor_bound_low),
+    m_load_factor_bound_up(load_factor_bound_up),
+    m_capacity(0),
+    m_slots(nullptr) {
+  assert(m_load_factor_bound_up < m_LoadFactor100Percents);
+}
+
+/// @brief Copy constructor for FlatHashtable.
+/// Creates copy of existing FlatHashtable instance.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param other is an existing source FlatHashtable
+/// instance to be copied to target.
+/// @return nothing.
+template <typename K, typename V>
+FlatHashtable<K, V>::FlatHashtable(const FlatHashtable& other) :
+    m_size(other.m_size),
+    hash(other.hash),
+    m_seed(other.m_seed),
+    m_shift(other.m_shift),
+    m_load_factor_bound_low(other.m_load_factor_bound_low),
+    m_load_factor_bound_up(other.m_load_factor_bound_up),
+    m_capacity(other.m_capacity),
+    m_slots(
+        (other.m_capacity > 0) ?
+        (new flatentry<K, V>[other.m_capacity]) : (nullptr)) {
+  for (size_t i = 0; i < m_capacity; ++i)
+    m_slots[i] = other.m_slots[i];
+}
+
+/// @brief Assignment operator for FlatHashtable.
+/// Creates copy of existing FlatHashtable instance,
+/// cleaning up left-hand target.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param other is an existing source FlatHashtable
+/// instance to be copied to target.
+/// @return nothing.
+template <typename K, typename V>
+FlatHashtable<K, V>& FlatHashtable<K, V>::operator=(FlatHashtable other) {
+  std::swap(m_size, other.m_size);
+  std::swap(hash, other.hash);
+  std::swap(m_seed, other.m_seed);
+  std::swap(m_shift, other.m_shift);
+  std::swap(m_load_factor_bound_low, other.m_load_factor_bound_low);
+  std::swap(m_load_factor_bound_up, other.m_load_factor_bound_up);
+  std::swap(m_capacity, other.m_capacity);
+  std::swap(m_slots, other.m_slots);
+  return *this;
+}
+
+/// @brief Destructor for FlatHashtable.
+/// Removes content of FlatHashtable instance,
+/// deleting the slot array.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @return nothing.
+template <typename K, typename V>
+FlatHashtable<K, V>::~FlatHashtable() {
+  delete [] m_slots;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Iterator.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Advances the iterator to the next element.
+/// Searches for the next occupied slot in the slot array.
+/// Sets current slot index to capacity if FlatHashtable
+/// don't have occupied slots any more.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @return reference to iterator.
+template <typename K, typename V>
+typename FlatHashtable<K, V>::iterator&
+FlatHashtable<K, V>::iterator::operator++() {
+  size_t capacity = m_owner->m_capacity;
+  do {
+    ++m_current_slot_idx;
+  } while (m_current_slot_idx < capacity &&
+           m_owner->m_slots[m_current_slot_idx].empty());
+  return *this;
+}
+
+/// @brief Dereferenses an iterator.
+/// Provides access to FlatHashtable's element by it's reference.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @return reference to FlatHashtable's element.
+/// @throw end_iterator exception in attempt to dereferencing an
+/// end iterator.
+template <typename K, typename V>
+flatentry<K, V>& FlatHashtable<K, V>::iterator::operator*() {
+  if (m_current_slot_idx >= m_owner->m_capacity)
+    throw exception::end_iterator(m_current_slot_idx,
+                                  __ESR_PRETTY_FUNCTION__);
+  return m_owner->m_slots[m_current_slot_idx];
+}
+
+/// @brief Dereferenses an iterator.
+/// Provides access to FlatHashtable's element by it's pointer.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @return pointer to FlatHashtable's element.
+/// @throw end_iterator exception in attempt to dereferencing an
+/// end iterator.
+template <typename K, typename V>
+flatentry<K, V>* FlatHashtable<K, V>::iterator::operator->() {
+  if (m_current_slot_idx >= m_owner->m_capacity)
+    throw exception::end_iterator(m_current_slot_idx,
+                                  __ESR_PRETTY_FUNCTION__);
+  return &m_owner->m_slots[m_current_slot_idx];
+}
+
+/// @brief Gets the beginning of FlatHashtable.
+/// Searches for the first occupied slot in the slot array.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @return iterator standing at the first element or end() iterator
+/// if FlatHashtable is empty.
+template <typename K, typename V>
+typename FlatHashtable<K, V>::iterator FlatHashtable<K, V>::begin() {
+  size_t first_occupied_slot_idx = 0;
+  while (first_occupied_slot_idx < m_capacity &&
+         m_slots[first_occupied_slot_idx].empty())
+    ++first_occupied_slot_idx;
+  return iterator(this, first_occupied_slot_idx);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Accessors and Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Looks up a slot.
+/// Walks the probe sequence starting from the home slot of the key.
+/// Stops at the first slot which element is closer to it's home
+/// slot than the key would be: by Robin Hood invariant the key
+/// can't be placed farther.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param key is a key of element.
+/// @return index of slot holding the key or capacity if no such key.
+template <typename K, typename V>
+size_t FlatHashtable<K, V>::lookup(const K& key) const {
+  if (m_size == 0)
+    return m_capacity;
+
+  size_t slot_idx = home(key);
+
+  for (uint32_t distance = 1; ; ++distance) {
+    const flatentry<K, V>& slot = m_slots[slot_idx];
+    if (slot.m_distance < distance)  // empty slot or richer element
+      return m_capacity;
+    if (slot.m_distance == distance && slot.m_key == key)
+      return slot_idx;
+    slot_idx = next(slot_idx);
+  }
+}
+
+/// @brief Set value.
+/// Provides write access to FlatHashtable's element by it's key.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param key is a key of element.
+/// @param value is a value of element.
+/// @return result of setting a value.
+/// @retval true on success.
+/// @retval false if no element with such key found in FlatHashtable.
+template <typename K, typename V>
+bool FlatHashtable<K, V>::set(const K& key, const V& value) {
+  size_t slot_idx = lookup(key);
+  if (slot_idx == m_capacity)
+    return false;
+
+  m_slots[slot_idx].set(value);
+  return true;
+}
+
+/// @brief Gets value by it's key.
+/// Provides read access to FlatHashtable's element by it's key
+/// using pointer.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param key is a key of element in FlatHashtable.
+/// @return valid constant pointer to element in FlatHashtable or
+/// nullptr if no element with such key found in FlatHashtable.
+/// Pointer is invalidated by any insertion or deletion.
+template <typename K, typename V>
+const V* FlatHashtable<K, V>::get(const K& key) const {
+  size_t slot_idx = lookup(key);
+  if (slot_idx == m_capacity)
+    return nullptr;
+
+  return &m_slots[slot_idx].value();
+}
+
+/// @brief Gets value by it's key.
+/// Provides read access to FlatHashtable's element by it's key
+/// using iterator.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param key is a key to FlatHashtable's element.
+/// @return iterator to element if found, otherwise it returns
+/// an iterator to FlatHashtable::end.
+template <typename K, typename V>
+typename FlatHashtable<K, V>::iterator
+FlatHashtable<K, V>::find(const K& key) {
+  return iterator(this, lookup(key));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Isertion, Deletion; private: Resize.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Adds an element.
+/// Inserts an element to FlatHashtable. Walks the probe sequence
+/// from the home slot looking for the key. If there is none,
+/// expands the slot array to it's double size if load factor would
+/// exceed load factor's upper threshold, then swaps the element
+/// being inserted with any element closer to it's home slot and
+/// continues to place the evicted one.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param key is a key to FlatHashtable's element.
+/// @param value is a value of FlatHashtable's element.
+/// @return result of insertion.
+/// @retval true if an element has been successfully inserted.
+/// @retval false if an element with such key is already in a
+/// FlatHashtable.
+template <typename K, typename V>
+bool FlatHashtable<K, V>::add(const K& key, const V& value) {
+  // first element
+  if (m_capacity == 0)
+    resize(m_MinCapacity);
+
+  uint64_t code = hash.code(key);
+  size_t slot_idx = home_of(code);
+
+  // Look for a duplicate until the first richer element.
+  uint32_t distance = 1;
+  for (; ; ++distance) {
+    const flatentry<K, V>& slot = m_slots[slot_idx];
+    if (slot.m_distance < distance)
+      break;
+    if (slot.m_distance == distance && slot.m_key == key)
+      return false;  // dublicate keys
+    slot_idx = next(slot_idx);
+  }
+
+  // expand, the key is absent: walk again in the new slot array
+  if (m_LoadFactor100Percents*(m_size + 1) >
+      m_load_factor_bound_up*m_capacity) {  // unlikely
+    resize(2*m_capacity);
+    slot_idx = home_of(code);
+    for (distance = 1; m_slots[slot_idx].m_distance >= distance; ++distance)
+      slot_idx = next(slot_idx);
+  }
+
+  flatentry<K, V> entry;
+  entry.m_key = key;
+  entry.m_value = value;
+  entry.m_distance = distance;
+  // Robin Hood: take the place, carry an evicted element further.
+  for (;;) {
+    flatentry<K, V>& slot = m_slots[slot_idx];
+    if (slot.empty()) {
+      slot = std::move(entry);
+      break;
+    }
+    if (slot.m_distance < entry.m_distance)
+      std::swap(slot, entry);
+    slot_idx = next(slot_idx);
+    ++entry.m_distance;
+  }
+  ++m_size;
+  return true;
+}
+
+/// @brief Removes an element.
+/// Removes an element from FlatHashtable. Shifts backward every
+/// following element until an empty slot or an element at it's
+/// home slot. Shrinks the slot array to it's half size if load
+/// factor is less than load factor's low threshold.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param key is a key to FlatHashtable's element.
+/// @return nothing.
+template <typename K, typename V>
+void FlatHashtable<K, V>::remove(const K& key) {
+  size_t slot_idx = lookup(key);
+  if (slot_idx == m_capacity) return;  // no such key
+
+  // backward shift
+  for (size_t next_idx = next(slot_idx);
+       m_slots[next_idx].m_distance > 1;
+       next_idx = next(next_idx)) {
+    m_slots[slot_idx] = std::move(m_slots[next_idx]);
+    --m_slots[slot_idx].m_distance;
+    slot_idx = next_idx;
+  }
+  m_slots[slot_idx] = flatentry<K, V>();
+
+  --m_size;
+
+  // shrink
+  if (m_size == 0) {
+    resize(0);
+    return;
+  }
+  if (load_factor() < m_load_factor_bound_low &&
+      m_capacity > m_MinCapacity)  // unlikely
+    resize(m_capacity/2);
+}
+
+/// @brief Places an element.
+/// Inserts an element known to be absent from FlatHashtable
+/// without duplicate checks and without resizing.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param entry is an element to move into slot array.
+/// @return nothing.
+template <typename K, typename V>
+void FlatHashtable<K, V>::place(flatentry<K, V>* entry) {
+  size_t slot_idx = home(entry->m_key);
+  entry->m_distance = 1;
+  for (;;) {
+    flatentry<K, V>& slot = m_slots[slot_idx];
+    if (slot.empty()) {
+      slot = std::move(*entry);
+      return;
+    }
+    if (slot.m_distance < entry->m_distance)
+      std::swap(slot, *entry);
+    slot_idx = next(slot_idx);
+    ++entry->m_distance;
+  }
+}
+
+/// @brief Resizes slot array.
+/// Creates new slot array with a new seed. Moves every element
+/// from source slot array to new slot array. Deletes source
+/// slot array.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param capacity is a slot array size, a power of two.
+/// @return nothing.
+template <typename K, typename V>
+void FlatHashtable<K, V>::resize(size_t capacity) {
+  assert(capacity != m_capacity);
+  assert((capacity & (capacity - 1)) == 0);
+  assert(capacity == 0 || m_size < capacity);
+  flatentry<K, V>* slots = nullptr;
+  if (capacity != 0) {
+    std::unique_ptr<flatentry<K, V>[]> ptr(new flatentry<K, V>[capacity]);
+    flatentry<K, V>* old_slots = m_slots;
+    size_t old_capacity = m_capacity;
+
+    m_seed = mix(m_seed ^ capacity);
+    m_shift = 64;
+    for (size_t c = capacity; c > 1; c >>= 1)
+      --m_shift;
+    m_slots = ptr.get();
+    m_capacity = capacity;
+    for (size_t i = 0; i < old_capacity; ++i)
+      if (!old_slots[i].empty())
+        place(&old_slots[i]);
+
+    slots = ptr.release();
+    delete [] old_slots;
+  } else {
+    delete [] m_slots;
+  }
+  m_capacity = capacity;
+  m_slots = slots;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Printout.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Prints to output stream.
+/// Outputs the FlatHashtable's contents to output stream.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param os is an output stream.
+/// @param htable is an FlatHashtable instance.
+/// @return reference to output stream.
+template <typename K, typename V>
+std::ostream & operator<<(std::ostream & os,
+                          const FlatHashtable<K, V> & htable) {
+  for (size_t i = 0; i < htable.m_capacity; ++i) {
+    os << std::setw(3) << i << ": {";
+    if (!htable.m_slots[i].empty())
+      os << '(' << htable.m_slots[i] << ')';
+    os << "}\n";
+  }
+  return os;
+}
+
+}  // namespace esr
+
+#endif  // ESR_FLATHASHTABLE_FLYMAKE_HPP_
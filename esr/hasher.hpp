@@ -6,41 +6,161 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 
-#include <cassert>  // assert().
-#include <string>   // std::string.
+#include <cassert>      // assert().
+#include <cstdint>      // uint64_t.
+#include <cstdlib>      // std::srand(), std::rand().
+#include <ctime>        // std::time().
+#include <string>       // std::string.
+#include <string_view>  // std::string_view.
+#include <type_traits>  // std::true_type, std::false_type.
 
 namespace esr {
 
+/// @brief Mixes hash code.
+/// Finalizer of MurmurHash3: every bit of result depends on every
+/// bit of hash code. Used by open addressing tables which take
+/// bucket number from a part of hash code.
+/// @param code is a hash code.
+/// @return mixed hash code.
+constexpr uint64_t mix(uint64_t code) {
+  code ^= code >> 33;
+  code *= 0xff51afd7ed558ccdULL;
+  code ^= code >> 33;
+  code *= 0xc4ceb9fe1a85ec53ULL;
+  code ^= code >> 33;
+  return code;
+}
+
+/// @brief Hashes characters by 64 bit FNV-1a.
+/// Byte at a time xor and multiplication by FNV prime, constexpr: hash
+/// codes of literals are computed at compile time.
+/// @param key is a sequence of characters.
+/// @return hash code.
+constexpr uint64_t fnv1a(std::string_view key) {
+  uint64_t code = 0xcbf29ce484222325ULL;
+  for (char c : key) {
+    code ^= static_cast<unsigned char>(c);
+    code *= 0x100000001b3ULL;
+  }
+  return code;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class modulo_mapping.
+///
+/// @brief Bucket Mapping by division.
+/// Maps hash code to index of bucket array of any size by modulo.
+/// Costs an integer division per mapping.
+////////////////////////////////////////////////////////////////////////////////
+class modulo_mapping {
+ public:
+  /// @brief Constructor, creates mapping for bucket array.
+  /// @param bucket_count is a size of bucket array.
+  /// @return nothing.
+  explicit modulo_mapping(size_t bucket_count = 1) :
+      m_bucket_count(bucket_count) {}
+
+  /// @brief Gets supported size of bucket array.
+  /// @param bucket_count is a requested size of bucket array.
+  /// @return bucket_count, any size is supported.
+  static size_t bucket_count(size_t bucket_count) { return bucket_count; }
+
+  /// @brief Maps hash code to index of bucket array.
+  /// @param code is a hash code.
+  /// @return index in a range from 0 to bucket count.
+  size_t operator()(uint64_t code) const {
+    assert(m_bucket_count != 0);
+    return code % m_bucket_count;
+  }
+
+ private:
+  size_t m_bucket_count;  ///< Size of bucket array.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class fibonacci_mapping.
+///
+/// @brief Bucket Mapping by multiplication.
+/// Maps hash code to index of power of two bucket array by
+/// Fibonacci hashing: hash code is multiplied by 2^64/phi and the
+/// high bits of product are taken. High bits of code are folded
+/// to low ones first, so every bit of code takes part. Mapping mixes
+/// weak codes, e.g. sequential or strided integers of identity
+/// hash function, over all buckets without a division.
+////////////////////////////////////////////////////////////////////////////////
+class fibonacci_mapping {
+ public:
+  /// @brief Constructor, creates mapping for bucket array.
+  /// @param bucket_count is a size of bucket array, power of two.
+  /// @return nothing.
+  explicit fibonacci_mapping(size_t bucket_count = 1) :
+      m_shift(0), m_mask(bucket_count - 1) {
+    assert(bucket_count != 0 && (bucket_count & (bucket_count - 1)) == 0);
+    size_t bits = 0;
+    while ((size_t(1) << bits) < bucket_count)
+      ++bits;
+    m_shift = (64 - bits) & 63;  // no bits: shift 0, mask 0
+  }
+
+  /// @brief Gets supported size of bucket array.
+  /// @param bucket_count is a requested size of bucket array.
+  /// @return the least power of two not less than bucket_count.
+  static size_t bucket_count(size_t bucket_count) {
+    size_t power = 1;
+    while (power < bucket_count)
+      power *= 2;
+    return power;
+  }
+
+  /// @brief Maps hash code to index of bucket array.
+  /// @param code is a hash code.
+  /// @return index in a range from 0 to bucket count.
+  size_t operator()(uint64_t code) const {
+    code ^= code >> m_shift;
+    return ((code * m_Golden) >> m_shift) & m_mask;
+  }
+
+ private:
+  unsigned m_shift;  ///< 64 minus number of index bits.
+  size_t m_mask;     ///< Size of bucket array minus one.
+
+  /// 2^64 divided by golden ratio.
+  static const uint64_t m_Golden = 11400714819323198485ULL;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @class hasher.
 ///
 /// @brief Hash Function Interface.
-/// Maps key to index in bucket array.
+/// Base of hash functions, resolved at compile time: derived class H
+/// provides code(), hasher calls it without virtual dispatch, so
+/// the call inlines. Hash function is stateless with respect to
+/// bucket array, bucket number is taken from hash code by the table.
 /// @tparam K type of hash key.
+/// @tparam H type of derived hash function.
 ////////////////////////////////////////////////////////////////////////////////
-template<typename K>
+template<typename K, typename H>
 class hasher {
  public:
-  /// @brief Default constructor, creates Hasher.
-  /// @param cardinality is size a of bucket array.
-  /// @return nothing.
-  explicit hasher(size_t cardinality) : m_cardinality(cardinality) {}
-
-  /// Returns hash code for a key.
-  virtual uint64_t code(const K& key) const = 0;
-
-  /// @brief Maps key to index of bucket array
-  /// Obtains hash code using code() and maps it
-  /// to index of bucket array.
+  /// @brief Gets hash code of key.
+  /// Obtains hash code using code() of derived hash function.
   /// @param key is a hash key.
-  /// @return Index of bucket array in a range
-  /// from 1 to cardinality.
-  size_t operator()(const K& key) const {
-    assert(m_cardinality != 0);
-    return code(key) % m_cardinality;
+  /// @return hash code.
+  uint64_t operator()(const K& key) const {
+    return static_cast<const H&>(*this).code(key);
+  }
+
+  /// @brief Gets hash code of view of key.
+  /// Obtains hash code of a view of key, see key_view, using code()
+  /// of derived hash function, which must hash the view to the same
+  /// code as the key.
+  /// @tparam Q type of view of key.
+  /// @param key is a view of hash key.
+  /// @return hash code.
+  template <typename Q>
+  uint64_t operator()(const Q& key) const {
+    return static_cast<const H&>(*this).code(key);
   }
- private:
-  size_t m_cardinality;  ///< Size of bucket array.
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -51,7 +171,60 @@ class hasher {
 /// @tparam K type of hash key.
 ////////////////////////////////////////////////////////////////////////////////
 template<typename K>
-class hash_function : public hasher<K> {};
+class hash_function;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class cache_hash_code.
+///
+/// @brief Hash Code Caching Opt-in.
+/// Nodes of keys which opt in keep full hash code next to the key:
+/// resize doesn't hash them again and lookups compare codes before
+/// keys. Worth for keys which are long to hash or to compare,
+/// small keys don't pay extra 8 bytes per node.
+/// Specialize as std::true_type for such key type.
+/// @tparam K type of hash key.
+////////////////////////////////////////////////////////////////////////////////
+template<typename K>
+struct cache_hash_code : std::false_type {};
+
+/// @brief Strings cache hash codes.
+template<>
+struct cache_hash_code<std::string> : std::true_type {};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class key_view.
+///
+/// @brief Heterogeneous Lookup Opt-in.
+/// Tables of keys which opt in find, get and remove elements by
+/// a view of key, e.g. string literal, without constructing a key of
+/// it. Hash function hashes the view to the same code as the key,
+/// key compares equal to the view.
+/// Specialize with member type of view for such key type.
+/// @tparam K type of hash key.
+////////////////////////////////////////////////////////////////////////////////
+template<typename K>
+struct key_view {};
+
+/// @brief Strings are looked up by std::string_view.
+template<>
+struct key_view<std::string> { typedef std::string_view type; };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class is_key_view.
+///
+/// @brief Checks if type Q is looked up as a view of key type K:
+/// K opts in by key_view and Q converts to the view.
+/// @tparam K type of hash key.
+/// @tparam Q type of lookup argument.
+////////////////////////////////////////////////////////////////////////////////
+template<typename K, typename Q, typename = void>
+struct is_key_view : std::false_type {};
+
+template<typename K, typename Q>
+struct is_key_view<K, Q, std::void_t<typename key_view<K>::type>> :
+      std::integral_constant<bool,
+          !std::is_same<K, Q>::value &&
+          std::is_convertible<const Q&, typename key_view<K>::type>::value> {};
 
 ////////////////////////////////////////////////////////////////////////////////
 // Hash functions for a few basic types int, char, bool and std::string.
@@ -62,11 +235,11 @@ class hash_function : public hasher<K> {};
 /// @brief Simple hash function for integer type.
 /// Simple integer hash function, it has higher performance
 /// then hash function from family of hashfunctions with primes.
+/// Bucket mapping of the table mixes the code.
 /// @return hash code of integer key.
 template <>
-class hash_function<int> : public hasher<int> {
+class hash_function<int> : public hasher<int, hash_function<int>> {
  public:
-  explicit hash_function(int cardinality = 1) : hasher<int>(cardinality) {}
   uint64_t code(const int& key) const { return key; }
 };
 #else  // not used
@@ -75,14 +248,12 @@ class hash_function<int> : public hasher<int> {
 /// then simple integer hash function.
 /// @return hash code of integer key.
 template <>
-class hash_function<int> : public hasher<int> {
+class hash_function<int> : public hasher<int, hash_function<int>> {
  public:
   uint32_t m_prime;
   uint32_t m_a;
   uint32_t m_b;
-  explicit hash_function(int cardinality = 1, uint32_t prime = 10000019) :
-      hasher<int>(cardinality),
-      m_prime(prime) {
+  explicit hash_function(uint32_t prime = 10000019) : m_prime(prime) {
     std::srand(std::time(0));
     m_a = std::rand() %  (m_prime - 1) + 1;  // 1 <= a <= p - 1
     m_b = std::rand() %  (m_prime - 1);      // 1 <= b <= p - 1
@@ -97,9 +268,8 @@ class hash_function<int> : public hasher<int> {
 /// @brief Hash function for boolean type.
 /// @return hash code of boolean key.
 template <>
-class hash_function<bool> : public hasher<bool> {
+class hash_function<bool> : public hasher<bool, hash_function<bool>> {
  public:
-  explicit hash_function(size_t cardinality = 1) : hasher<bool>(cardinality) {}
   uint64_t code(const bool& key) const {
     return (key ? 1231 : 1237);
   }
@@ -111,14 +281,12 @@ class hash_function<bool> : public hasher<bool> {
 /// @note Not tested for performance,
 /// may be should be replaced with a simple one.
 template <>
-class hash_function<char> : public hasher<char> {
+class hash_function<char> : public hasher<char, hash_function<char>> {
  public:
   uint32_t m_prime;
   uint32_t m_a;
   uint32_t m_b;
-  explicit hash_function(int cardinality = 1, uint32_t prime = 389) :
-      hasher<char>(cardinality),
-      m_prime(prime) {
+  explicit hash_function(uint32_t prime = 389) : m_prime(prime) {
     std::srand(std::time(0));
     m_a = std::rand() %  (m_prime - 1) + 1;  // 1 <= a <= p - 1
     m_b = std::rand() %  (m_prime - 1);      // 1 <= b <= p - 1
@@ -134,22 +302,21 @@ class hash_function<char> : public hasher<char> {
 /// It is more effective then hash function with big prime.
 /// @return hash code of integer key.
 template <>
-class hash_function<std::string> : public hasher<std::string> {
+class hash_function<std::string> :
+      public hasher<std::string, hash_function<std::string>> {
  public:
   uint32_t m_prime;
   uint32_t m_devider;
-  explicit hash_function(size_t cardinality = 1,
-                   size_t devider = 8,
-                   size_t prime = 37) :
-      hasher<std::string>(cardinality),
+  explicit hash_function(size_t devider = 8, size_t prime = 37) :
       m_devider(devider),
       m_prime(prime) {}
 
-  uint64_t code(const std::string& key) const {
+  /// @brief Hash code of std::string or it's view, the same for both.
+  uint64_t code(std::string_view key) const {
     uint64_t h = 0;
     int skip = 1 > (key.size() / m_devider) ? 1 : (key.size() / m_devider);
     for (int i = 0; i < key.size(); ++i)
-      h = key.c_str()[i] + m_prime * h;
+      h = key[i] + m_prime * h;
     return h;
   }
 };
@@ -158,14 +325,12 @@ class hash_function<std::string> : public hasher<std::string> {
 /// It is less effective then "Java style" hash function.
 /// @return hash code of integer key.
 template <>
-class hash_function<std::string> : public hasher<std::string> {
+class hash_function<std::string> :
+      public hasher<std::string, hash_function<std::string>> {
  public:
   uint32_t m_prime;
   uint32_t m_multiplier;
-  explicit hash_function(size_t cardinality = 1,
-                   size_t multiplier = 263,
-                   size_t prime = 1000000007) :
-      hasher<std::string>(cardinality),
+  explicit hash_function(size_t multiplier = 263, size_t prime = 1000000007) :
       m_multiplier(multiplier),
       m_prime(prime) {}
 
@@ -85,6 +85,31 @@ class end_iterator: public hashtable {
   size_t m_index;  //< bucket index.
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @class table_file.
+///
+/// @brief Table file exception.
+/// File of table can't be written, read or mapped, or it's content
+/// is not a table of the expected type.
+////////////////////////////////////////////////////////////////////////////////
+class table_file: public hashtable {
+ public:
+  /// @brief Default constructor, creates a table file exception.
+  /// @param path is a path of table file.
+  /// @param who_arg is a data to identify function which throws an exception.
+  /// @param what_arg is a data describing the exception.
+  /// @return nothing.
+  explicit table_file(const string& path, const string& who_arg = "",
+                      const string& what_arg = "bad table file") :
+      hashtable(who_arg, what_arg), m_path(path) {}
+
+  /// @brief Gets path of table file.
+  /// @return path of table file.
+  const string& path() const { return m_path; }
+ private:
+  string m_path;  //< table file path.
+};
+
 }  // namespace exception
 }  // namespace esr
 
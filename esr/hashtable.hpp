@@ -6,16 +6,59 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <ostream>    // operator<<().
+#include <istream>    // load().
 #include <iomanip>    // operator<<().
 #include <cassert>    // assert().
-#include <algorithm>  // std::swap().
-
+#include <cstdint>    // SIZE_MAX.
+#include <algorithm>  // std::swap(), std::min().
+#include <iterator>   // std::distance().
+#include <memory>     // std::unique_ptr.
+#include <new>        // operator new(), placement new.
+#include <tuple>      // std::apply(), std::make_from_tuple().
+#include <type_traits>  // std::is_trivially_destructible.
+#include <utility>    // std::forward(), std::move(), std::piecewise_construct.
+
+#include <esr/bitmap.hpp>      // Occupied buckets.
 #include <esr/hasher.hpp>      // Basic hash functions.
 #include <esr/linkedlist.hpp>  // List for buckets.
+#include <esr/nodepool.hpp>    // Storage for nodes.
 #include <esr/hashexcept.hpp>  // Hashtable's specific exceptions.
+#include <esr/parallel.hpp>    // parallel_run().
+#include <esr/serializer.hpp>  // Snapshot of elements.
 
 namespace esr {
 
+/// @brief Prefetches memory to cache.
+/// Hint only: does nothing if compiler doesn't support it, address
+/// may be invalid, e.g. nullptr.
+/// @param address is an address of memory to be read.
+inline void prefetch(const void* address) {
+#ifdef __GNUC__
+  __builtin_prefetch(address);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class capacity_hint.
+///
+/// @brief Expected number of elements of Hashtable.
+/// Distinguishes capacity of Hashtable constructor from it's load
+/// factor thresholds.
+////////////////////////////////////////////////////////////////////////////////
+class capacity_hint {
+ public:
+  /// @brief Constructor, creates capacity hint.
+  /// @param size is an expected number of elements.
+  /// @return nothing.
+  explicit capacity_hint(size_t size) : m_size(size) {}
+
+  /// Gets expected number of elements.
+  size_t size() const { return m_size; }
+
+ private:
+  size_t m_size;  ///< Expected number of elements.
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @class Hashtable.
 ///
@@ -24,8 +67,14 @@ namespace esr {
 /// an array of liked lists.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H hash function: functor returning hash code of key,
+/// resolved at compile time.
+/// @tparam M bucket mapping: fibonacci_mapping keeps power of two
+/// bucket counts and maps by multiplication, modulo_mapping maps
+/// by division.
 ////////////////////////////////////////////////////////////////////////////////
-template <typename K, typename V>
+template <typename K, typename V, typename H = hash_function<K>,
+          typename M = fibonacci_mapping>
 class Hashtable {
  public:
   class iterator;
@@ -34,33 +83,154 @@ class Hashtable {
   explicit Hashtable(size_t load_factor_bound_low = m_LoadFactorBoundLowDefault,
                      size_t load_factor_bound_up = m_LoadFactorBoundUpDefault);
 
+  /// Constructor, creates Hashtable with buckets for capacity elements.
+  explicit Hashtable(capacity_hint capacity,
+                     size_t load_factor_bound_low = m_LoadFactorBoundLowDefault,
+                     size_t load_factor_bound_up = m_LoadFactorBoundUpDefault);
+
+  /// Constructor, creates Hashtable of a range of key, value pairs.
+  template <typename ForwardIt, typename = typename std::enable_if<
+              !std::is_integral<ForwardIt>::value>::type>
+  Hashtable(ForwardIt first, ForwardIt last, bool unique_keys = false);
+
   /// Copy constructor, creates copy of Hashtable.
   Hashtable(const Hashtable& other);
 
+  /// Move constructor, takes elements of other Hashtable.
+  Hashtable(Hashtable&& other) noexcept;
+
   /// Destructor, deletes Hashtable.
   virtual ~Hashtable();
 
   /// Assignment operator.
   Hashtable& operator=(Hashtable other);
 
+  /// Swaps content with other Hashtable.
+  void swap(Hashtable& other) noexcept;
+
+  /// Replaces elements by a range of key, value pairs.
+  template <typename ForwardIt>
+  void assign_bulk(ForwardIt first, ForwardIt last, bool unique_keys = false);
+
   /// Adds key, value to hashtable.
   bool add(const K& key, const V& value);
 
+  /// Adds key, value to hashtable, moving them.
+  bool add(K&& key, V&& value);
+
+  /// Adds key, value constructed in place of arguments.
+  template <typename KK, typename VV>
+  bool emplace(KK&& key, VV&& value);
+
+  /// Adds key, value constructed in place of argument tuples.
+  template <typename... KArgs, typename... VArgs>
+  bool emplace(std::piecewise_construct_t,
+               std::tuple<KArgs...> key_args,
+               std::tuple<VArgs...> value_args);
+
+  /// Adds key, constructs value of arguments if key is absent.
+  template <typename... Args>
+  bool try_emplace(const K& key, Args&&... args);
+
+  /// Adds key, constructs value of arguments if key is absent.
+  template <typename... Args>
+  bool try_emplace(K&& key, Args&&... args);
+
+  /// Finds element of key, adds key, value if key is absent.
+  std::pair<iterator, bool> find_or_insert(const K& key,
+                                           const V& value = V());
+
+  /// Adds key, value or combines value with value of key.
+  template <typename F>
+  bool upsert(const K& key, const V& value, F combine);
+
   /// Removes key from hashtable.
-  void remove(const K& key);
+  void remove(const K& key) { erase(key); }
+
+  /// Removes key from hashtable by view of key, see key_view.
+  template <typename Q>
+  std::enable_if_t<is_key_view<K, Q>::value> remove(const Q& key) {
+    erase(typename key_view<K>::type(key));
+  }
 
   /// Sets the value by key.
   bool set(const K& key, const V& value);
 
+  /// Sets the value by key, moving it.
+  bool set(const K& key, V&& value);
+
   /// Gets constant pointer to value by key.
   const V* get(const K& key) const;
 
+  /// Gets constant pointer to value by view of key, see key_view.
+  template <typename Q>
+  std::enable_if_t<is_key_view<K, Q>::value, const V*> get(
+      const Q& key) const {
+    listnode<K, V>* node = lookup(typename key_view<K>::type(key));
+    return node != nullptr ? &node->value() : nullptr;
+  }
+
   /// Finds a value by key.
-  iterator find(const K& key);
+  iterator find(const K& key) { return locate(key); }
+
+  /// Finds a value by view of key, see key_view.
+  template <typename Q>
+  std::enable_if_t<is_key_view<K, Q>::value, iterator> find(const Q& key) {
+    return locate(typename key_view<K>::type(key));
+  }
+
+  /// Checks if key is in hashtable.
+  bool contains(const K& key) const { return lookup(key) != nullptr; }
+
+  /// Checks if view of key is in hashtable, see key_view.
+  template <typename Q>
+  std::enable_if_t<is_key_view<K, Q>::value, bool> contains(
+      const Q& key) const {
+    return lookup(typename key_view<K>::type(key)) != nullptr;
+  }
+
+  /// Finds values of a number of keys at once.
+  void find_batch(const K* keys, size_t count, iterator* found);
+
+  /// Gets constant pointers to values of a number of keys at once.
+  void get_batch(const K* keys, size_t count, const V** values) const;
+
+  /// Visits all elements by a number of threads.
+  template <typename F>
+  void parallel_for_each(F visit, size_t workers = 0);
+
+  /// Reduces all elements to a value by a number of threads.
+  template <typename T, typename Map, typename Combine>
+  T parallel_reduce(T init, Map map, Combine combine,
+                    size_t workers = 0) const;
+
+  /// Writes elements to binary snapshot.
+  void save(std::ostream& os) const;
+
+  /// Replaces elements by elements of binary snapshot.
+  void load(std::istream& is);
 
   /// Gets a number of elements in hashtable.
   size_t size() const { return m_size; }
 
+  /// Gets a number of buckets.
+  size_t bucket_count() const { return m_bucket_count; }
+
+  /// Keeps buckets for a number of elements.
+  void reserve(size_t size);
+
+  /// Turns incremental resizing on or off.
+  void set_incremental_resize(bool incremental);
+
+  /// Is resizing incremental or not.
+  bool incremental_resize() const { return m_incremental; }
+
+  /// Resizes tables of a number of elements and more by threads.
+  void set_parallel_resize(size_t threshold, size_t workers = 0);
+
+  /// Gets the least number of elements resized by threads.
+  size_t parallel_resize_threshold() const { return m_parallel_threshold; }
+
   /// Gets average number of elements in bucket.
   size_t load_factor() const {
     return (
@@ -69,8 +239,9 @@ class Hashtable {
   }
 
   /// Hashtable's printer.
-  template <typename KK, typename VV>
-  friend ostream & operator<<(ostream & os, const Hashtable<KK, VV> & ht);
+  template <typename KK, typename VV, typename HH, typename MM>
+  friend ostream & operator<<(ostream & os,
+                              const Hashtable<KK, VV, HH, MM> & ht);
 
   /// Forward iterator.
   class iterator {
@@ -124,8 +295,11 @@ class Hashtable {
   /// Number of elements in Hashtable.
   uint64_t m_size;
 
-  /// Hash function to get a bucket number in bucket array by key.
-  hash_function<K> hash;
+  /// Hash function to get a hash code of key.
+  H hash;
+
+  /// Maps hash code to a bucket number in bucket array.
+  M m_mapping;
 
   /// Load factor low threshold.
   size_t m_load_factor_bound_low;
@@ -139,10 +313,169 @@ class Hashtable {
   /// Bucket array, an array of linked lists.
   linkedlist<K, V>* m_buckets;
 
+  /// Bit per bucket of bucket array, set if it's not empty.
+  bitmap m_occupied;
+
+  /// Storage of nodes of all buckets, nullptr until the first bucket
+  /// array is made.
+  nodepool<listnode<K, V>>* m_pool;
+
+  /// Resize moves nodes by a few buckets per operation or all at once.
+  bool m_incremental;
+
+  /// Resize of this number of elements and more runs on threads.
+  size_t m_parallel_threshold;
+
+  /// Number of threads of parallel resize, 0 for hardware threads.
+  size_t m_resize_workers;
+
+  /// Source bucket array of pending incremental resize, or nullptr.
+  linkedlist<K, V>* m_old_buckets;
+
+  /// Bit per source bucket, set if it's not empty; bits of moved
+  /// source buckets don't matter.
+  bitmap m_old_occupied;
+
+  /// Size of source bucket array.
+  size_t m_old_bucket_count;
+
+  /// Bucket mapping of source bucket array.
+  M m_old_mapping;
+
+  /// Number of source buckets already moved to the bucket array.
+  size_t m_migrated;
+
+  /// Number of constructed buckets of the bucket array.
+  size_t m_constructed;
+
+  /// Bucket array never shrinks below this size.
+  size_t m_min_bucket_count;
+
+  /// Number of add() and remove() since the last resize.
+  size_t m_resize_age;
+
+  /// Gets a number of operations the next expansion waits for.
+  size_t expansion_window() const {
+    return m_bucket_count/m_ResizeWindowRatio;
+  }
+
+  /// Gets a number of operations the next shrink waits for.
+  size_t shrink_window() const {
+    return std::max(expansion_window(), m_ShrinkWindowMin);
+  }
+
+  /// Creates bucket array taking nodes from the pool.
+  linkedlist<K, V>* make_buckets(size_t bucket_count);
+
+  /// Allocates storage of bucket array without constructing buckets.
+  static linkedlist<K, V>* allocate_buckets(size_t bucket_count);
+
+  /// Destroys a range of buckets and releases storage of bucket array.
+  static void delete_buckets(linkedlist<K, V>* buckets,
+                             size_t first, size_t last);
+
+  /// Gets the bucket which holds key, or would hold it.
+  linkedlist<K, V>& bucket_of(uint64_t code, size_t* bucket_idx) const;
+
+  /// Gets node of key or nullptr.
+  template <typename Q>
+  listnode<K, V>* lookup(const Q& key) const;
+
+  /// Finds element of key.
+  template <typename Q>
+  iterator locate(const Q& key);
+
+  /// Finds nodes of a group of keys, prefetching their chains.
+  void lookup_group(const K* keys, size_t count, listnode<K, V>** nodes,
+                    size_t* bucket_idx) const;
+
+  /// Removes element of key.
+  template <typename Q>
+  void erase(const Q& key);
+
+  /// Gets the bucket to add key to, resizes bucket array if due.
+  linkedlist<K, V>& insertion_bucket(uint64_t code, size_t* bucket_idx);
+
+  /// Adds key and value constructed of arguments if key is absent.
+  template <typename KK, typename... Args>
+  std::pair<iterator, bool> insert(KK&& key, Args&&... args);
+
+  /// Adds key known to be absent and value constructed of arguments.
+  template <typename KK, typename... Args>
+  iterator insert_absent(uint64_t code, KK&& key, Args&&... args);
+
+  /// Gets hash code of node's key: cached one or computed again.
+  uint64_t code_of(const listnode<K, V>& node) const {
+    return cache_hash_code<K>::value ? node.hash_code() : hash(node.key());
+  }
+
+  /// Gets bucket by it's iteration index, nullptr if it isn't there.
+  linkedlist<K, V>* bucket_at(size_t bucket_idx) const;
+
+  /// Gets iteration index of the first not empty bucket from an index.
+  size_t next_occupied(size_t bucket_idx) const;
+
+  /// Marks bucket of an iteration index as not empty.
+  void occupy(size_t bucket_idx);
+
+  /// Marks bucket of an iteration index as empty.
+  void vacate(size_t bucket_idx);
+
+  /// Gets a number of buckets to iterate, source buckets included.
+  size_t iteration_bucket_count() const {
+    return m_bucket_count + m_old_bucket_count;
+  }
+
+  /// Gets a number of threads of a parallel scan, at least one.
+  size_t scan_workers(size_t workers) const;
+
+  /// Moves nodes of a few source buckets to the bucket array.
+  void migrate(size_t bucket_count);
+
+  /// Gets a number of buckets holding size elements within thresholds.
+  size_t bucket_count_for(size_t size) const;
+
+  /// Loads a range of key, value pairs to Hashtable without buckets.
+  template <typename ForwardIt>
+  void bulk_load(ForwardIt first, ForwardIt last, bool unique_keys);
+
   /// Resizes bucket array, to new size.
   /// @param bucket_count is a size of resized bucket array.
   void resize(size_t bucket_count);
 
+  /// Relinks nodes to new bucket array by a number of threads.
+  void rehash_parallel(linkedlist<K, V>* table, bitmap* occupied,
+                       const M& mapping, size_t bucket_count,
+                       size_t workers);
+
+  /// Number of source buckets moved by one operation.
+  static const size_t m_MigrationStep = 8;
+
+  /// Number of keys of batch lookup hashed and prefetched together.
+  static const size_t m_BatchGroupSize = 32;
+
+  /// Number of buckets constructed per moved source bucket.
+  static const size_t m_ConstructionRatio = 4;
+
+  /// Bucket count to resize window ratio.
+  static const size_t m_ResizeWindowRatio = 4;
+
+  /// Minimal number of operations between a resize and a shrink.
+  static const size_t m_ShrinkWindowMin = 16;
+
+  /// Default least number of elements resized by threads: none, every
+  /// parallel resize starts threads of it's own.
+  static const size_t m_ParallelResizeThresholdDefault = SIZE_MAX;
+
+  /// Least number of buckets scanned by one thread of parallel scan.
+  static const size_t m_ScanGrain = 4096;
+
+  /// Signature of snapshot.
+  static const char m_SnapshotMagic[8];
+
+  /// Number of elements of snapshot read before trusting it's count.
+  static const size_t m_LoadChunk = 4096;
+
   /// Load factor 100%.
   static const size_t m_LoadFactor100Percents = 100;  // size == buckets, 100%.
 
@@ -156,12 +489,31 @@ class Hashtable {
 ////////////////////////////////////////////////////////////////////////////////
 // Constants.
 ////////////////////////////////////////////////////////////////////////////////
-template <typename K, typename V>
-const size_t Hashtable<K, V>::m_LoadFactor100Percents;
-template <typename K, typename V>
-const size_t Hashtable<K, V>::m_LoadFactorBoundUpDefault;
-template <typename K, typename V>
-const size_t Hashtable<K, V>::m_LoadFactorBoundLowDefault;
+template <typename K, typename V, typename H, typename M>
+const size_t Hashtable<K, V, H, M>::m_LoadFactor100Percents;
+template <typename K, typename V, typename H, typename M>
+const size_t Hashtable<K, V, H, M>::m_LoadFactorBoundUpDefault;
+template <typename K, typename V, typename H, typename M>
+const size_t Hashtable<K, V, H, M>::m_LoadFactorBoundLowDefault;
+template <typename K, typename V, typename H, typename M>
+const size_t Hashtable<K, V, H, M>::m_MigrationStep;
+template <typename K, typename V, typename H, typename M>
+const size_t Hashtable<K, V, H, M>::m_BatchGroupSize;
+template <typename K, typename V, typename H, typename M>
+const size_t Hashtable<K, V, H, M>::m_ConstructionRatio;
+template <typename K, typename V, typename H, typename M>
+const size_t Hashtable<K, V, H, M>::m_ResizeWindowRatio;
+template <typename K, typename V, typename H, typename M>
+const size_t Hashtable<K, V, H, M>::m_ShrinkWindowMin;
+template <typename K, typename V, typename H, typename M>
+const size_t Hashtable<K, V, H, M>::m_ParallelResizeThresholdDefault;
+template <typename K, typename V, typename H, typename M>
+const size_t Hashtable<K, V, H, M>::m_ScanGrain;
+template <typename K, typename V, typename H, typename M>
+const char Hashtable<K, V, H, M>::m_SnapshotMagic[8] = {
+  'E', 'S', 'R', 'S', 'N', 'A', 'P', '1'};
+template <typename K, typename V, typename H, typename M>
+const size_t Hashtable<K, V, H, M>::m_LoadChunk;
 
 ////////////////////////////////////////////////////////////////////////////////
 // Constructors, Destructor and Assignment.
@@ -172,68 +524,274 @@ const size_t Hashtable<K, V>::m_LoadFactorBoundLowDefault;
 /// and upper thresholds.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
 /// @param load_factor_bound_low is a load factor's low threshold.
 /// @param load_factor_bound_up is a load factor's upper threshold.
 /// @return nothing.
-template <typename K, typename V>
-Hashtable<K, V>::Hashtable(size_t load_factor_bound_low,
+template <typename K, typename V, typename H, typename M>
+Hashtable<K, V, H, M>::Hashtable(size_t load_factor_bound_low,
                            size_t load_factor_bound_up) :
-    hash(0),
     m_size(0),
+    hash(),
+    m_load_factor_bound_low(load_factor_bound_low),
+    m_load_factor_bound_up(load_factor_bound_up),
     m_bucket_count(0),
     m_buckets(nullptr),
-    m_load_factor_bound_low(load_factor_bound_low),
-    m_load_factor_bound_up(load_factor_bound_up) {}
+    m_pool(nullptr),
+    m_incremental(false),
+    m_parallel_threshold(m_ParallelResizeThresholdDefault),
+    m_resize_workers(0),
+    m_old_buckets(nullptr),
+    m_old_bucket_count(0),
+    m_old_mapping(),
+    m_migrated(0),
+    m_constructed(0),
+    m_min_bucket_count(0),
+    m_resize_age(0) {}
+
+/// @brief Constructor for Hashtable with capacity.
+/// Creates Hashtable with buckets for expected number of elements,
+/// see reserve(): loading it doesn't resize the bucket array.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param capacity is an expected number of elements.
+/// @param load_factor_bound_low is a load factor's low threshold.
+/// @param load_factor_bound_up is a load factor's upper threshold.
+/// @return nothing.
+template <typename K, typename V, typename H, typename M>
+Hashtable<K, V, H, M>::Hashtable(capacity_hint capacity,
+                                 size_t load_factor_bound_low,
+                                 size_t load_factor_bound_up) :
+    Hashtable(load_factor_bound_low, load_factor_bound_up) {
+  reserve(capacity.size());
+}
+
+/// @brief Constructor for Hashtable of a range.
+/// Creates Hashtable of key, value pairs, see assign_bulk().
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @tparam ForwardIt type of forward iterator to std::pair of key,
+/// value or alike.
+/// @param first is the beginning of the range.
+/// @param last is the end of the range.
+/// @param unique_keys is true if the range has no duplicate keys.
+/// @return nothing.
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+template <typename ForwardIt, typename>
+Hashtable<K, V, H, M>::Hashtable(ForwardIt first, ForwardIt last,
+                                 bool unique_keys) :
+    Hashtable() {
+  bulk_load(first, last, unique_keys);
+}
 
 /// @brief Copy constructor for Hashtable.
 /// Creates copy of existing Hashtable instance.
+/// Copy has it's own pool of nodes. Nodes of a pending
+/// incremental resize are copied right to their new buckets.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
 /// @param other is an existing source Hashtable
 /// instance to be copied to target.
 /// @return nothing.
-template <typename K, typename V>
-Hashtable<K, V>::Hashtable(const Hashtable& other) :
+template <typename K, typename V, typename H, typename M>
+Hashtable<K, V, H, M>::Hashtable(const Hashtable& other) :
     m_size(other.m_size),
     hash(other.hash),
+    m_mapping(other.m_mapping),
     m_load_factor_bound_low(other.m_load_factor_bound_low),
     m_load_factor_bound_up(other.m_load_factor_bound_up),
     m_bucket_count(other.m_bucket_count),
-    m_buckets(
-        (other.m_bucket_count > 0) ?
-        (new linkedlist<K, V>[other.m_bucket_count]) : (nullptr)) {
-  for (int i = 0; i < m_bucket_count; ++i)
-    m_buckets[i] = other.m_buckets[i];
+    m_buckets(nullptr),
+    m_occupied(other.m_bucket_count),
+    m_pool(new nodepool<listnode<K, V>>()),
+    m_incremental(other.m_incremental),
+    m_parallel_threshold(other.m_parallel_threshold),
+    m_resize_workers(other.m_resize_workers),
+    m_old_buckets(nullptr),
+    m_old_bucket_count(0),
+    m_old_mapping(),
+    m_migrated(0),
+    m_constructed(0),
+    m_min_bucket_count(other.m_min_bucket_count),
+    m_resize_age(other.m_resize_age) {
+  std::unique_ptr<nodepool<listnode<K, V>>> pool(m_pool);
+  m_buckets = make_buckets(m_bucket_count);
+  m_constructed = m_bucket_count;
+  try {
+    for (int i = 0; i < other.m_constructed; ++i)
+      for (listnode<K, V>* node = other.m_buckets[i].front();
+           node; node = node->next()) {
+        m_buckets[i].push_back(node->key(), node->value(),
+                               node->hash_code());
+        m_occupied.set(i);
+      }
+    for (size_t i = other.m_migrated; i < other.m_old_bucket_count; ++i)
+      for (listnode<K, V>* node = other.m_old_buckets[i].front();
+           node; node = node->next()) {
+        uint64_t code = code_of(*node);
+        size_t bucket_idx = m_mapping(code);
+        if (bucket_idx >= m_bucket_count)
+          throw exception::bucket_index(bucket_idx, __ESR_PRETTY_FUNCTION__);
+        m_buckets[bucket_idx].push_back(node->key(), node->value(), code);
+        m_occupied.set(bucket_idx);
+      }
+  } catch (...) {
+    delete_buckets(m_buckets, 0, m_bucket_count);
+    throw;
+  }
+  pool.release();
+}
+
+/// @brief Move constructor for Hashtable.
+/// Takes bucket arrays and pool of other Hashtable, nodes are
+/// neither copied nor moved. Other is left empty without a pool,
+/// it makes one on the first insertion: nothing is allocated.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param other is an existing source Hashtable.
+/// @return nothing.
+template <typename K, typename V, typename H, typename M>
+Hashtable<K, V, H, M>::Hashtable(Hashtable&& other) noexcept :
+    Hashtable(other.m_load_factor_bound_low, other.m_load_factor_bound_up) {
+  swap(other);
 }
 
 /// @brief Assignment operator for Hashtable.
 /// Creates copy of existing Hashtable instance,
-/// cleaning up left-hand target.
+/// cleaning up left-hand target. Rvalue Hashtable is moved
+/// by move constructor, not copied.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
 /// @param other is an existing source Hashtable
 /// instance to be copied to target.
 /// @return nothing.
-template <typename K, typename V>
-Hashtable<K, V>& Hashtable<K, V>::operator=(Hashtable other) {
+template <typename K, typename V, typename H, typename M>
+Hashtable<K, V, H, M>& Hashtable<K, V, H, M>::operator=(Hashtable other) {
+  swap(other);
+  return *this;
+}
+
+/// @brief Swaps content with other Hashtable.
+/// Swaps bucket arrays and pools, no element is copied.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param other is a Hashtable to swap with.
+/// @return nothing.
+template <typename K, typename V, typename H, typename M>
+void Hashtable<K, V, H, M>::swap(Hashtable& other) noexcept {
   std::swap(m_size, other.m_size);
   std::swap(hash, other.hash);  // check function
+  std::swap(m_mapping, other.m_mapping);
   std::swap(m_load_factor_bound_low, other.m_load_factor_bound_low);
   std::swap(m_load_factor_bound_up, other.m_load_factor_bound_up);
   std::swap(m_bucket_count, other.m_bucket_count);
   std::swap(m_buckets, other.m_buckets);
-  return *this;
+  m_occupied.swap(other.m_occupied);
+  std::swap(m_pool, other.m_pool);
+  std::swap(m_incremental, other.m_incremental);
+  std::swap(m_parallel_threshold, other.m_parallel_threshold);
+  std::swap(m_resize_workers, other.m_resize_workers);
+  std::swap(m_old_buckets, other.m_old_buckets);
+  m_old_occupied.swap(other.m_old_occupied);
+  std::swap(m_old_bucket_count, other.m_old_bucket_count);
+  std::swap(m_old_mapping, other.m_old_mapping);
+  std::swap(m_migrated, other.m_migrated);
+  std::swap(m_constructed, other.m_constructed);
+  std::swap(m_min_bucket_count, other.m_min_bucket_count);
+  std::swap(m_resize_age, other.m_resize_age);
 }
 
 /// @brief Destructor for Hashtable.
 /// Removes content of Hashtable instance,
-/// deleting the bucket array.
+/// deleting the bucket array and the pool of nodes.
+/// Nodes which don't need destructors aren't visited at all,
+/// their memory is released block by block with the pool.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
 /// @return nothing.
-template <typename K, typename V>
-Hashtable<K, V>::~Hashtable() {
-  delete [] m_buckets;
+template <typename K, typename V, typename H, typename M>
+Hashtable<K, V, H, M>::~Hashtable() {
+  if (std::is_trivially_destructible<listnode<K, V>>::value) {
+    for (size_t i = 0; i < m_constructed; ++i)
+      m_buckets[i].detach();
+    for (size_t i = m_migrated; i < m_old_bucket_count; ++i)
+      m_old_buckets[i].detach();
+  }
+  delete_buckets(m_old_buckets, m_migrated, m_old_bucket_count);
+  delete_buckets(m_buckets, 0, m_constructed);
+  delete m_pool;
+}
+
+/// @brief Creates bucket array.
+/// Every bucket takes nodes from the pool of Hashtable, the pool is
+/// made along with the first bucket array.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param bucket_count is a bucket array size.
+/// @return bucket array or nullptr if bucket_count is 0.
+template <typename K, typename V, typename H, typename M>
+linkedlist<K, V>* Hashtable<K, V, H, M>::make_buckets(size_t bucket_count) {
+  if (m_pool == nullptr && bucket_count != 0)
+    m_pool = new nodepool<listnode<K, V>>();
+  linkedlist<K, V>* buckets = allocate_buckets(bucket_count);
+  for (size_t i = 0; i < bucket_count; ++i)
+    new(&buckets[i]) linkedlist<K, V>(m_pool);
+  return buckets;
+}
+
+/// @brief Allocates storage of bucket array.
+/// Buckets are constructed by the caller: all at once or, during
+/// incremental resize, a few per operation.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param bucket_count is a bucket array size.
+/// @return storage of bucket array or nullptr if bucket_count is 0.
+template <typename K, typename V, typename H, typename M>
+linkedlist<K, V>* Hashtable<K, V, H, M>::allocate_buckets(size_t bucket_count) {
+  if (bucket_count == 0)
+    return nullptr;
+  return static_cast<linkedlist<K, V>*>(
+      ::operator new(bucket_count*sizeof(linkedlist<K, V>)));
+}
+
+/// @brief Destroys buckets and releases storage of bucket array.
+/// Buckets out of the range are either not constructed or
+/// already destroyed.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param buckets is a storage of bucket array, may be nullptr.
+/// @param first is an index of the first bucket to destroy.
+/// @param last is an index past the last bucket to destroy.
+/// @return nothing.
+template <typename K, typename V, typename H, typename M>
+void Hashtable<K, V, H, M>::delete_buckets(linkedlist<K, V>* buckets,
+                                     size_t first, size_t last) {
+  for (size_t i = first; i < last; ++i)
+    buckets[i].~linkedlist<K, V>();
+  ::operator delete(buckets);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -243,37 +801,35 @@ Hashtable<K, V>::~Hashtable() {
 /// @brief Advances the iterator to the next element.
 /// Sets the current pointer to the next element of
 /// the current bucket if next element exists.
-/// Otherwise searches for the next not empty bucket in
-/// the bucket array. Sets the current bucket index to found
-/// bucket and current pointer to the beginning of found bucket.
+/// Otherwise finds the next not empty bucket by bits of
+/// occupied buckets, see next_occupied(). Sets the current bucket
+/// index to found bucket and current pointer to the beginning of
+/// found bucket.
 /// Sets current bucket index to the last bucket and current ponter
 /// to nullptr if Hashtable don't have empty buckets any more.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
 /// @return reference to iterator.
-template <typename K, typename V>
-typename Hashtable<K, V>::iterator& Hashtable<K, V>::iterator::operator++() {
+template <typename K, typename V, typename H, typename M>
+typename Hashtable<K, V, H, M>::iterator&
+Hashtable<K, V, H, M>::iterator::operator++() {
   m_current_bucket_node_ptr = m_current_bucket_node_ptr->next();
   if (m_current_bucket_node_ptr == nullptr) {  //  end of current bucket
-    // find not empty bucket starting from next one
-    size_t next_bucket_idx = m_current_bucket_idx + 1;
-    for (int i = next_bucket_idx; i < m_owner->m_bucket_count; ++i) {
-      linkedlist<K, V>& next_bucket = m_owner->m_buckets[next_bucket_idx];
-      if (next_bucket.empty()) {
-        ++next_bucket_idx;
-      } else {
-        break;
-      }
-    }
-    size_t next_not_empty_bucket_idx = next_bucket_idx;
+    // find not empty bucket starting from next one,
+    // source buckets of pending incremental resize follow the others
+    size_t bucket_count = m_owner->iteration_bucket_count();
+    size_t next_not_empty_bucket_idx =
+        m_owner->next_occupied(m_current_bucket_idx + 1);
 
-    if (next_not_empty_bucket_idx < m_owner->m_bucket_count) {
+    if (next_not_empty_bucket_idx < bucket_count) {
       // Next bucket less then bucket count:
       //               set index to the found bucket,
       //               set pointer to the begining of bucket.
       m_current_bucket_idx = next_not_empty_bucket_idx;
-      linkedlist<K, V>& bucket = m_owner->m_buckets[m_current_bucket_idx];
-      m_current_bucket_node_ptr = bucket.front();
+      linkedlist<K, V>* bucket = m_owner->bucket_at(m_current_bucket_idx);
+      m_current_bucket_node_ptr = bucket->front();
     } else {
       // Next bucket equal or greater than bucket count
       //               set index to the last bucket,
@@ -289,11 +845,13 @@ typename Hashtable<K, V>::iterator& Hashtable<K, V>::iterator::operator++() {
 /// Provides access to Hashtable's element by it's reference.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
 /// @return reference to Hashtable's element.
 /// @throw end_iterator exception in attempt to dereferencing an
 /// end iterator.
-template <typename K, typename V>
-listnode<K, V>& Hashtable<K, V>::iterator::operator*() {
+template <typename K, typename V, typename H, typename M>
+listnode<K, V>& Hashtable<K, V, H, M>::iterator::operator*() {
   // unlikely
   if (m_current_bucket_node_ptr == nullptr) {
     assert(m_current_bucket_idx == m_owner->m_bucket_count - 1);
@@ -307,11 +865,13 @@ listnode<K, V>& Hashtable<K, V>::iterator::operator*() {
 /// Provides access to Hashtable's element by it's pointer.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
 /// @return pointer to Hashtable's element.
 /// @throw end_iterator exception in attempt to dereferencing an
 /// end iterator.
-template <typename K, typename V>
-listnode<K, V>* Hashtable<K, V>::iterator::operator->() {
+template <typename K, typename V, typename H, typename M>
+listnode<K, V>* Hashtable<K, V, H, M>::iterator::operator->() {
   if (m_current_bucket_node_ptr == nullptr) {
     assert(m_current_bucket_idx == m_owner->m_bucket_count - 1);
     throw exception::end_iterator(m_current_bucket_idx,
@@ -325,14 +885,16 @@ listnode<K, V>* Hashtable<K, V>::iterator::operator->() {
 /// and their current element pointers.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
 /// @param rhs is a reference to iterator instance,
 /// right-hand side of a comparison expression.
 /// @return result of the equality comparison.
 /// @retval true if current bucket indicies or
 /// current element pointers of both iterators are not equal.
 /// @retval false otherwise.
-template <typename K, typename V>
-bool Hashtable<K, V>::iterator::operator!=(const iterator& rhs) {
+template <typename K, typename V, typename H, typename M>
+bool Hashtable<K, V, H, M>::iterator::operator!=(const iterator& rhs) {
   return (m_current_bucket_idx != rhs.m_current_bucket_idx) ||
       (m_current_bucket_node_ptr != rhs.m_current_bucket_node_ptr);
 }
@@ -342,47 +904,46 @@ bool Hashtable<K, V>::iterator::operator!=(const iterator& rhs) {
 /// and their current element pointers.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
 /// Right-hand side of a comparison expression.
 /// @return result of the equality comparison.
 /// @retval true if current bucket indicies and
 /// current element pointers of both iterators are equal.
 /// @retval false otherwise.
-template <typename K, typename V>
-bool Hashtable<K, V>::iterator::operator==(const iterator& rhs) {
+template <typename K, typename V, typename H, typename M>
+bool Hashtable<K, V, H, M>::iterator::operator==(const iterator& rhs) {
   return (m_current_bucket_idx == rhs.m_current_bucket_idx) &&
       (m_current_bucket_node_ptr == rhs.m_current_bucket_node_ptr);
 }
 
 /// @brief Gets the beginning of Hashtable.
-/// Searches for the first not empty bucket in
-/// the bucket array. Sets bucket
+/// Finds the first not empty bucket by bits of
+/// occupied buckets, see next_occupied(). Sets bucket
 /// index to found bucket and element pointer to
 /// the first element of found bucket.
 /// Sets bucket index to the last bucket and
 /// element ponter to nullptr if all buckets are empty.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
 /// @return iterator containig bucket index
 /// and bucket pointer.
-template <typename K, typename V>
-typename Hashtable<K, V>::iterator Hashtable<K, V>::begin() {
-  linkedlist<K, V>* bucket = nullptr;
-  size_t first_not_empty_bucket_idx = 0;
-  while (first_not_empty_bucket_idx < m_bucket_count) {
-    bucket = &m_buckets[first_not_empty_bucket_idx];
-    if (bucket->empty())
-      ++first_not_empty_bucket_idx;
-    else
-      break;
-  }
-  assert(first_not_empty_bucket_idx <= m_bucket_count);
+template <typename K, typename V, typename H, typename M>
+typename Hashtable<K, V, H, M>::iterator
+Hashtable<K, V, H, M>::begin() {
+  size_t bucket_count = iteration_bucket_count();
+  size_t first_not_empty_bucket_idx = next_occupied(0);
+  assert(first_not_empty_bucket_idx <= bucket_count);
 
   // Empty hashtable, return end() interator.
-  if (first_not_empty_bucket_idx == m_bucket_count)
+  if (first_not_empty_bucket_idx == bucket_count)
     return iterator(this, m_bucket_count-1, nullptr);
   // Don't want to use "return end()", because of following line.
 
   // Stands at first entry of hashtable
+  linkedlist<K, V>* bucket = bucket_at(first_not_empty_bucket_idx);
   return iterator(this, first_not_empty_bucket_idx, bucket->front());
 }
 
@@ -391,21 +952,280 @@ typename Hashtable<K, V>::iterator Hashtable<K, V>::begin() {
 /// element ponter to nullptr.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
 /// @return iterator containig bucket index
 /// and bucket pointer.
-template <typename K, typename V>
-typename Hashtable<K, V>::iterator Hashtable<K, V>::end() {
+template <typename K, typename V, typename H, typename M>
+typename Hashtable<K, V, H, M>::iterator
+Hashtable<K, V, H, M>::end() {
   return iterator(this, m_bucket_count-1, nullptr);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Parallel Scans.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Gets a number of threads of a parallel scan.
+/// Every thread scans a range of at least m_ScanGrain buckets: a
+/// smaller table is scanned by fewer threads, down to the calling
+/// one alone.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param workers is a wanted number of threads, 0 for the number of
+/// hardware threads.
+/// @return number of threads, at least one.
+template <typename K, typename V, typename H, typename M>
+size_t Hashtable<K, V, H, M>::scan_workers(size_t workers) const {
+  if (workers == 0)
+    workers = hardware_workers();
+  return std::max<size_t>(
+      std::min(workers, iteration_bucket_count()/m_ScanGrain), 1);
+}
+
+/// @brief Visits all elements by a number of threads.
+/// Splits buckets, source buckets of pending incremental resize
+/// included, into a range per thread, see parallel_run(). Every
+/// element is visited once, in no particular order. Threads call
+/// visit at the same time: it may change the value it's given, and
+/// has to synchronize anything else it changes. Table must not be
+/// modified meanwhile.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @tparam F type of function void(const K& key, V& value).
+/// @param visit is a function called for every element.
+/// @param workers is a number of threads, 0 for the number of
+/// hardware threads.
+/// @return nothing.
+/// @throw the first exception thrown by visit, after all threads
+/// are done.
+template <typename K, typename V, typename H, typename M>
+template <typename F>
+void Hashtable<K, V, H, M>::parallel_for_each(F visit, size_t workers) {
+  size_t bucket_count = iteration_bucket_count();
+  workers = scan_workers(workers);
+  parallel_run(workers, [this, &visit, bucket_count, workers](size_t t) {
+      size_t last = bucket_count*(t + 1)/workers;
+      for (size_t i = next_occupied(bucket_count*t/workers); i < last;
+           i = next_occupied(i + 1)) {
+        for (listnode<K, V>* node = bucket_at(i)->front(); node != nullptr;
+             node = node->next())
+          visit(node->key(), node->value());
+      }
+    });
+}
+
+/// @brief Reduces all elements to a value by a number of threads.
+/// Every thread starts with a copy of init and folds map(key, value)
+/// of every element of it's range into it by combine. Partial results
+/// are then folded into init by combine on the calling thread, in
+/// range order. So init has to be an identity of combine, e.g. 0 of
+/// a sum, and combine has to be associative; it may take map result
+/// of another type than T if it takes T as well. Threads call map and
+/// combine at the same time: both must be safe to call concurrently.
+/// combine takes and returns T by value for every element, so T should
+/// be cheap to move, e.g. a number rather than a table of groups.
+/// Table must not be modified meanwhile.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @tparam T type of result, copy and move constructible.
+/// @tparam Map type of function R(const K& key, const V& value).
+/// @tparam Combine type of functions T(T, R) and T(T, T).
+/// @param init is an identity of combine.
+/// @param map is a function called for every element.
+/// @param combine is a function folding its second argument into
+/// the first one.
+/// @param workers is a number of threads, 0 for the number of
+/// hardware threads.
+/// @return init combined with map of every element.
+/// @throw the first exception thrown by map, combine or T, after all
+/// threads are done.
+template <typename K, typename V, typename H, typename M>
+template <typename T, typename Map, typename Combine>
+T Hashtable<K, V, H, M>::parallel_reduce(T init, Map map, Combine combine,
+                                         size_t workers) const {
+  size_t bucket_count = iteration_bucket_count();
+  workers = scan_workers(workers);
+  // partials[t] is constructed by thread t when it's range is done
+  std::allocator<T> allocator;
+  T* partials = allocator.allocate(workers);
+  std::unique_ptr<bool[]> done;
+  auto release = [&allocator, partials, &done, workers]() {
+    for (size_t t = 0; done && t < workers; ++t)
+      if (done[t])
+        partials[t].~T();
+    allocator.deallocate(partials, workers);
+  };
+
+  try {
+    done.reset(new bool[workers]());
+    parallel_run(workers, [this, &init, &map, &combine, partials, &done,
+                           bucket_count, workers](size_t t) {
+        T partial(init);
+        size_t last = bucket_count*(t + 1)/workers;
+        for (size_t i = next_occupied(bucket_count*t/workers); i < last;
+             i = next_occupied(i + 1)) {
+          for (listnode<K, V>* node = bucket_at(i)->front(); node != nullptr;
+               node = node->next())
+            partial = combine(std::move(partial),
+                              map(node->key(),
+                                  static_cast<const V&>(node->value())));
+        }
+        new(&partials[t]) T(std::move(partial));
+        done[t] = true;
+      });
+    for (size_t t = 0; t < workers; ++t)
+      init = combine(std::move(init), std::move(partials[t]));
+  } catch (...) {
+    release();
+    throw;
+  }
+  release();
+  return init;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Accessors and Modifiers.
 ////////////////////////////////////////////////////////////////////////////////
 
+/// @brief Gets the bucket which holds key, or would hold it.
+/// Key of a source bucket not yet moved by pending incremental
+/// resize is in that source bucket, otherwise it is in bucket array.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param code is a hash code of key.
+/// @param bucket_idx is set to iteration index of the bucket.
+/// @return reference to bucket.
+/// @throw bucket_index exception if a bucket number returned
+/// by the hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+linkedlist<K, V>& Hashtable<K, V, H, M>::bucket_of(uint64_t code,
+                                                   size_t* bucket_idx) const {
+  if (m_old_buckets != nullptr) {  // unlikely
+    size_t old_bucket_idx = m_old_mapping(code);
+    if (old_bucket_idx >= m_old_bucket_count)
+      throw exception::bucket_index(old_bucket_idx, __ESR_PRETTY_FUNCTION__);
+    if (old_bucket_idx >= m_migrated) {
+      *bucket_idx = m_bucket_count + old_bucket_idx;
+      return m_old_buckets[old_bucket_idx];
+    }
+  }
+
+  *bucket_idx = m_mapping(code);
+  if (*bucket_idx >= m_bucket_count)
+    throw exception::bucket_index(*bucket_idx, __ESR_PRETTY_FUNCTION__);
+  return m_buckets[*bucket_idx];
+}
+
+/// @brief Gets node of key.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @tparam Q type of key or of view of key.
+/// @param key is a key of element.
+/// @return node or nullptr if no element with such key found.
+/// @throw bucket_index exception if a bucket number returned
+/// by the hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+template <typename Q>
+listnode<K, V>* Hashtable<K, V, H, M>::lookup(const Q& key) const {
+  if (m_size == 0)
+    return nullptr;  // end() iterator
+
+  size_t bucket_idx;
+  uint64_t code = hash(key);
+  return bucket_of(code, &bucket_idx).find(key, code);
+}
+
+/// @brief Gets bucket by it's iteration index.
+/// Iteration indices of source buckets of pending incremental
+/// resize follow indices of bucket array.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param bucket_idx is an iteration index of bucket.
+/// @return pointer to bucket or nullptr if bucket isn't constructed
+/// yet or is already moved.
+template <typename K, typename V, typename H, typename M>
+linkedlist<K, V>* Hashtable<K, V, H, M>::bucket_at(size_t bucket_idx) const {
+  assert(bucket_idx < iteration_bucket_count());
+  if (bucket_idx < m_bucket_count)
+    return bucket_idx < m_constructed ? &m_buckets[bucket_idx] : nullptr;
+  bucket_idx -= m_bucket_count;
+  return bucket_idx >= m_migrated ? &m_old_buckets[bucket_idx] : nullptr;
+}
+
+/// @brief Gets iteration index of the first not empty bucket.
+/// Checks bits of occupied buckets 64 buckets at a time, bucket
+/// headers aren't read: a scan costs O(n + buckets/64). Buckets
+/// which aren't constructed yet have clear bits, moved source
+/// buckets are skipped.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param bucket_idx is an iteration index to start from, may be
+/// iteration_bucket_count().
+/// @return iteration index of the bucket or iteration_bucket_count()
+/// if all buckets from bucket_idx on are empty.
+template <typename K, typename V, typename H, typename M>
+size_t Hashtable<K, V, H, M>::next_occupied(size_t bucket_idx) const {
+  if (bucket_idx < m_bucket_count) {
+    size_t found = m_occupied.find_next(bucket_idx);
+    if (found < m_bucket_count)
+      return found;
+    bucket_idx = m_bucket_count;
+  }
+  size_t old_bucket_idx = std::max(bucket_idx - m_bucket_count, m_migrated);
+  return m_bucket_count + m_old_occupied.find_next(old_bucket_idx);
+}
+
+/// @brief Marks bucket as not empty.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param bucket_idx is an iteration index of bucket.
+/// @return nothing.
+template <typename K, typename V, typename H, typename M>
+void Hashtable<K, V, H, M>::occupy(size_t bucket_idx) {
+  if (bucket_idx < m_bucket_count)
+    m_occupied.set(bucket_idx);
+  else
+    m_old_occupied.set(bucket_idx - m_bucket_count);
+}
+
+/// @brief Marks bucket as empty.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param bucket_idx is an iteration index of bucket.
+/// @return nothing.
+template <typename K, typename V, typename H, typename M>
+void Hashtable<K, V, H, M>::vacate(size_t bucket_idx) {
+  if (bucket_idx < m_bucket_count)
+    m_occupied.reset(bucket_idx);
+  else
+    m_old_occupied.reset(bucket_idx - m_bucket_count);
+}
+
 /// @brief Set value.
 /// Provides write access to Hashtable's element by it's key.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
 /// @param key is a key of element.
 /// @param value is a value of element.
 /// @return result of setting a value.
@@ -413,22 +1233,36 @@ typename Hashtable<K, V>::iterator Hashtable<K, V>::end() {
 /// @retval false if no element with such key found in Hashtable.
 /// @throw bucket_index exception if a bucket number returned
 /// by the hash funtion is out of the bucket array range.
-template <typename K, typename V>
-bool Hashtable<K, V>::set(const K& key, const V& value) {
-  if (m_size == 0) {
-    assert(((m_buckets == nullptr) &&  (m_bucket_count == 0)));
-    return false;  // end() iterator
-  }
+template <typename K, typename V, typename H, typename M>
+bool Hashtable<K, V, H, M>::set(const K& key, const V& value) {
+  listnode<K, V>* node = lookup(key);
+  if (node == nullptr)
+    return false;
 
-  size_t bucket_idx = hash(key);
-  if (bucket_idx >= m_bucket_count)
-    throw exception::bucket_index(bucket_idx, __ESR_PRETTY_FUNCTION__);
+  node->set(value);
+  return true;
+}
 
-  listnode<K, V>* node = m_buckets[bucket_idx].find(key);
+/// @brief Sets value by it's key, moving it.
+/// Same as set() of constant value, but moves value to the element.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param key is a key of element.
+/// @param value is a value of element.
+/// @return result of setting a value.
+/// @retval true on success.
+/// @retval false if no element with such key found in Hashtable.
+/// @throw bucket_index exception if a bucket number returned
+/// by the hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+bool Hashtable<K, V, H, M>::set(const K& key, V&& value) {
+  listnode<K, V>* node = lookup(key);
   if (node == nullptr)
     return false;
 
-  node->set(value);
+  node->set(std::move(value));
   return true;
 }
 
@@ -436,23 +1270,16 @@ bool Hashtable<K, V>::set(const K& key, const V& value) {
 /// Provides read access to Hashtable's element by it's key using pointer.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
 /// @param key is a key of element in Hashtable.
 /// @return valid constant pointer to element in Hashtable or
 /// nullptr if no element with such key found in Hashtable.
 /// @throw bucket_index exception if a bucket number returned
 /// by hash funtion is out of the bucket array range.
-template <typename K, typename V>
-const V* Hashtable<K, V>::get(const K& key) const {
-  if (m_size == 0) {
-    assert(((m_buckets == nullptr) &&  (m_bucket_count == 0)));
-    return nullptr;  // end() iterator
-  }
-
-  size_t bucket_idx = hash(key);
-  if (bucket_idx >= m_bucket_count)
-    throw exception::bucket_index(bucket_idx, __ESR_PRETTY_FUNCTION__);
-
-  listnode<K, V>* node = m_buckets[bucket_idx].find(key);
+template <typename K, typename V, typename H, typename M>
+const V* Hashtable<K, V, H, M>::get(const K& key) const {
+  listnode<K, V>* node = lookup(key);
   if (node == nullptr)
     return nullptr;
 
@@ -461,31 +1288,134 @@ const V* Hashtable<K, V>::get(const K& key) const {
 
 /// @brief Gets value by it's key.
 /// Provides read access to Hashtable's element by it's key using iterator.
+/// Consults both arrays of pending incremental resize, but moves no
+/// bucket: iterators stay valid.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @tparam Q type of key or of view of key.
 /// @param key is a key to Hashtable's element.
 /// @return iterator to element if found, otherwise it returns
 /// an iterator to Hashtable::end.
 /// @throw bucket_index exception if a bucket number returned
 /// by hash funtion is out of the bucket array range.
-template <typename K, typename V>
-typename Hashtable<K, V>::iterator Hashtable<K, V>::find(const K& key) {
-  if (m_size == 0) {
-    assert(((m_buckets == nullptr) &&  (m_bucket_count == 0)));
+template <typename K, typename V, typename H, typename M>
+template <typename Q>
+typename Hashtable<K, V, H, M>::iterator
+Hashtable<K, V, H, M>::locate(const Q& key) {
+  if (m_size == 0)
     return iterator(this, m_bucket_count-1, nullptr);  // end() iterator
-  }
 
-  size_t bucket_idx = hash(key);
-  if (bucket_idx >= m_bucket_count)
-    throw exception::bucket_index(bucket_idx, __ESR_PRETTY_FUNCTION__);
-
-  listnode<K, V>* node = m_buckets[bucket_idx].find(key);
+  size_t bucket_idx;
+  uint64_t code = hash(key);
+  listnode<K, V>* node = bucket_of(code, &bucket_idx).find(key, code);
   if (node == nullptr)
     return iterator(this, m_bucket_count-1, nullptr);
 
   return iterator(this, bucket_idx, node);
 }
 
+/// @brief Finds values of a number of keys at once.
+/// Same as find() of every key, but keys are looked up by groups:
+/// all keys of a group are hashed and their buckets prefetched, then
+/// the first nodes of the buckets are prefetched, and only then keys
+/// are compared. Loads of a group overlap, so a lookup doesn't wait
+/// for the memory one pointer after another, which pays for tables
+/// larger than cache. Moves no bucket of pending incremental resize,
+/// as find() doesn't.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param keys is an array of keys.
+/// @param count is a number of keys.
+/// @param found is an array of count iterators, set to elements of
+/// keys or to Hashtable::end if key isn't found.
+/// @return nothing.
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+void Hashtable<K, V, H, M>::find_batch(const K* keys, size_t count,
+                                       iterator* found) {
+  listnode<K, V>* nodes[m_BatchGroupSize];
+  size_t bucket_idx[m_BatchGroupSize];
+  for (size_t first = 0; first < count; first += m_BatchGroupSize) {
+    size_t group = std::min(m_BatchGroupSize, count - first);
+    lookup_group(keys + first, group, nodes, bucket_idx);
+    for (size_t i = 0; i < group; ++i)
+      found[first + i] = nodes[i] != nullptr ?
+          iterator(this, bucket_idx[i], nodes[i]) : end();
+  }
+}
+
+/// @brief Gets values of a number of keys at once.
+/// Same as get() of every key, keys are looked up by groups as
+/// by find_batch().
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param keys is an array of keys.
+/// @param count is a number of keys.
+/// @param values is an array of count pointers, set to values of
+/// keys or to nullptr if key isn't found.
+/// @return nothing.
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+void Hashtable<K, V, H, M>::get_batch(const K* keys, size_t count,
+                                      const V** values) const {
+  listnode<K, V>* nodes[m_BatchGroupSize];
+  size_t bucket_idx[m_BatchGroupSize];
+  for (size_t first = 0; first < count; first += m_BatchGroupSize) {
+    size_t group = std::min(m_BatchGroupSize, count - first);
+    lookup_group(keys + first, group, nodes, bucket_idx);
+    for (size_t i = 0; i < group; ++i)
+      values[first + i] = nodes[i] != nullptr ? &nodes[i]->value() : nullptr;
+  }
+}
+
+/// @brief Finds nodes of a group of keys.
+/// Hashes all keys and prefetches their buckets, then prefetches
+/// the first nodes of buckets, then compares keys.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param keys is an array of keys.
+/// @param count is a number of keys, not greater than group size.
+/// @param nodes is an array of count nodes, set to nodes of keys
+/// or to nullptr.
+/// @param bucket_idx is an array of count iteration indices of
+/// buckets of keys.
+/// @return nothing.
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+void Hashtable<K, V, H, M>::lookup_group(const K* keys, size_t count,
+                                         listnode<K, V>** nodes,
+                                         size_t* bucket_idx) const {
+  assert(count <= m_BatchGroupSize);
+  if (m_size == 0) {
+    for (size_t i = 0; i < count; ++i)
+      nodes[i] = nullptr;
+    return;
+  }
+
+  uint64_t codes[m_BatchGroupSize];
+  linkedlist<K, V>* buckets[m_BatchGroupSize];
+  for (size_t i = 0; i < count; ++i) {
+    codes[i] = hash(keys[i]);
+    buckets[i] = &bucket_of(codes[i], &bucket_idx[i]);
+    prefetch(buckets[i]);
+  }
+  for (size_t i = 0; i < count; ++i)
+    prefetch(buckets[i]->front());
+  for (size_t i = 0; i < count; ++i)
+    nodes[i] = buckets[i]->find(keys[i], codes[i]);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Isertion, Deletion; private: Resize.
 ////////////////////////////////////////////////////////////////////////////////
@@ -493,9 +1423,16 @@ typename Hashtable<K, V>::iterator Hashtable<K, V>::find(const K& key) {
 /// @brief Adds an element.
 /// Inserts an element to Hashtable. Expands the bucket array to
 /// it's double size if load factor is grater than load factor's
-/// upper threshold.
+/// upper threshold. Expansion waits for a quarter of bucket count
+/// operations after the last resize, so a table oscillating
+/// around a threshold doesn't rehash on every operation. Moves a few
+/// buckets of pending incremental resize instead, new resize doesn't
+/// start before it's finished. Duplicate key costs as much as find(),
+/// neither resizes nor counts as an operation.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
 /// @param key is a key to Hashtable's element.
 /// @param value is a value of Hashtable's element.
 /// @return result of insertion.
@@ -504,106 +1441,840 @@ typename Hashtable<K, V>::iterator Hashtable<K, V>::find(const K& key) {
 /// Hashtable.
 /// @throw bucket_index exception if a bucket number returned
 /// by hash funtion is out of the bucket array range.
-template <typename K, typename V>
-bool Hashtable<K, V>::add(const K& key, const V& value) {
+template <typename K, typename V, typename H, typename M>
+bool Hashtable<K, V, H, M>::add(const K& key, const V& value) {
+  return insert(key, value).second;
+}
+
+/// @brief Adds an element, moving it.
+/// Same as add() of constant key, value, but moves them to
+/// the element. Nothing is moved if key is already in Hashtable.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param key is a key to Hashtable's element.
+/// @param value is a value of Hashtable's element.
+/// @return result of insertion, see add().
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+bool Hashtable<K, V, H, M>::add(K&& key, V&& value) {
+  return insert(std::move(key), std::move(value)).second;
+}
+
+/// @brief Adds an element constructed in place.
+/// Constructs key of it's argument to hash it, value is constructed
+/// in place of it's argument only if key is not in Hashtable.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @tparam KK type of key constructor argument.
+/// @tparam VV type of value constructor argument.
+/// @param key is a key constructor argument.
+/// @param value is a value constructor argument.
+/// @return result of insertion, see add().
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+template <typename KK, typename VV>
+bool Hashtable<K, V, H, M>::emplace(KK&& key, VV&& value) {
+  return insert(K(std::forward<KK>(key)), std::forward<VV>(value)).second;
+}
+
+/// @brief Adds an element constructed in place of argument tuples.
+/// Same as emplace() of two arguments for keys and values of any
+/// number of constructor arguments, as std::pair constructs them.
+/// Key is constructed to hash it, value is constructed in place
+/// only if key is not in Hashtable.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @tparam KArgs types of key constructor arguments.
+/// @tparam VArgs types of value constructor arguments.
+/// @param key_args is a tuple of key constructor arguments.
+/// @param value_args is a tuple of value constructor arguments.
+/// @return result of insertion, see add().
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+template <typename... KArgs, typename... VArgs>
+bool Hashtable<K, V, H, M>::emplace(std::piecewise_construct_t,
+                                    std::tuple<KArgs...> key_args,
+                                    std::tuple<VArgs...> value_args) {
+  return std::apply([this, &key_args](auto&&... args) {
+    return insert(std::make_from_tuple<K>(std::move(key_args)),
+                  std::forward<decltype(args)>(args)...).second;
+  }, std::move(value_args));
+}
+
+/// @brief Adds an element, constructing value if key is absent.
+/// Neither key nor arguments are touched if key is already in
+/// Hashtable.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @tparam Args types of value constructor arguments.
+/// @param key is a key to Hashtable's element.
+/// @param args are value constructor arguments.
+/// @return result of insertion, see add().
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+template <typename... Args>
+bool Hashtable<K, V, H, M>::try_emplace(const K& key, Args&&... args) {
+  return insert(key, std::forward<Args>(args)...).second;
+}
+
+/// @brief Adds an element, constructing value if key is absent.
+/// Same as try_emplace() of constant key, but moves key to
+/// the element. Key is not moved if it is already in Hashtable.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @tparam Args types of value constructor arguments.
+/// @param key is a key to Hashtable's element.
+/// @param args are value constructor arguments.
+/// @return result of insertion, see add().
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+template <typename... Args>
+bool Hashtable<K, V, H, M>::try_emplace(K&& key, Args&&... args) {
+  return insert(std::move(key), std::forward<Args>(args)...).second;
+}
+
+/// @brief Finds an element, adds it if key is absent.
+/// Hashes key once and walks it's chain once, unlike find() followed
+/// by add() on a miss. Value is copied only if key is added.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param key is a key to Hashtable's element.
+/// @param value is a value of added element.
+/// @return iterator to found or added element and true if element
+/// has been added, false if it's found.
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+std::pair<typename Hashtable<K, V, H, M>::iterator, bool>
+Hashtable<K, V, H, M>::find_or_insert(const K& key, const V& value) {
+  return insert(key, value);
+}
+
+/// @brief Adds an element or combines it's value.
+/// Adds key, value if key is absent, otherwise sets value of key
+/// to combine(value of key, value). Hashes key once and walks it's
+/// chain once, e.g. group-by aggregation:
+/// table.upsert(group, x, [](uint64_t sum, uint64_t x) { return sum + x; }).
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @tparam F type of function V(const V&, const V&).
+/// @param key is a key to Hashtable's element.
+/// @param value is a value to add or to combine with.
+/// @param combine is a function of value of key and value.
+/// @return true if element has been added, false if combined.
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+template <typename F>
+bool Hashtable<K, V, H, M>::upsert(const K& key, const V& value,
+                                   F combine) {
+  std::pair<iterator, bool> found = insert(key, value);
+  if (!found.second)
+    found.first->value() = combine(found.first->value(), value);
+  return found.second;
+}
+
+/// @brief Gets the bucket to add key to.
+/// Counts the operation for resize hysteresis. Creates bucket array
+/// for the first element, expands it if due or moves a few buckets
+/// of pending incremental resize.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param code is a hash code of key.
+/// @param bucket_idx is set to iteration index of bucket.
+/// @return reference to bucket.
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+linkedlist<K, V>& Hashtable<K, V, H, M>::insertion_bucket(uint64_t code,
+                                                          size_t* bucket_idx) {
+  ++m_resize_age;
+
   // first element
-  if (m_size == 0)
+  if (m_bucket_count == 0)
     resize(1);
 
   // expand
-  size_t factor = load_factor();
-  if (factor > m_load_factor_bound_up)  // unlikely
+  if (m_old_buckets != nullptr)  // incremental resize is pending
+    migrate(m_MigrationStep);
+  else if (load_factor() > m_load_factor_bound_up &&
+           m_resize_age >= expansion_window())  // unlikely
     resize(2*m_bucket_count);
 
-  size_t bucket_idx  = hash(key);
-  if (bucket_idx >= m_bucket_count)
-    throw exception::bucket_index(bucket_idx, __ESR_PRETTY_FUNCTION__);
+  return bucket_of(code, bucket_idx);
+}
 
-  linkedlist<K, V>& bucket = m_buckets[bucket_idx];
-  bool success = bucket.push_back(key, value);
-  m_size += success ? 1 : 0;
+/// @brief Adds key and value constructed of arguments.
+/// Common part of add(), emplace(), try_emplace(), find_or_insert()
+/// and upsert(): hashes key once and walks it's chain once.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @tparam KK type of key, K or reference to K.
+/// @tparam Args types of value constructor arguments.
+/// @param key is a key, copied or moved to the element.
+/// @param args are value constructor arguments.
+/// @return iterator to found or added element and result of
+/// insertion, see add().
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+template <typename KK, typename... Args>
+std::pair<typename Hashtable<K, V, H, M>::iterator, bool>
+Hashtable<K, V, H, M>::insert(KK&& key, Args&&... args) {
+  uint64_t code = hash(key);
+  size_t bucket_idx;
+  if (m_size != 0) {
+    listnode<K, V>* node = bucket_of(code, &bucket_idx).find(key, code);
+    if (node != nullptr)  // dublicate key, as cheap as find()
+      return std::make_pair(iterator(this, bucket_idx, node), false);
+  }
 
-  return success;
+  return std::make_pair(insert_absent(code, std::forward<KK>(key),
+                                      std::forward<Args>(args)...), true);
+}
+
+/// @brief Adds key known to be absent and value constructed of arguments.
+/// Resizes bucket array if due, which may move key's bucket, then
+/// appends element to the bucket without walking it's chain again.
+/// Kept apart from insert(), so that lookup of duplicate key inlines.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @tparam KK type of key, K or reference to K.
+/// @tparam Args types of value constructor arguments.
+/// @param code is a hash code of key.
+/// @param key is a key, copied or moved to the element.
+/// @param args are value constructor arguments.
+/// @return iterator to added element.
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+template <typename KK, typename... Args>
+typename Hashtable<K, V, H, M>::iterator
+Hashtable<K, V, H, M>::insert_absent(uint64_t code, KK&& key,
+                                     Args&&... args) {
+  size_t bucket_idx;
+  linkedlist<K, V>& bucket = insertion_bucket(code, &bucket_idx);
+  listnode<K, V>* node = bucket.emplace_back_unique(
+      code, std::forward<KK>(key), std::forward<Args>(args)...);
+  occupy(bucket_idx);
+  ++m_size;
+  return iterator(this, bucket_idx, node);
 }
 
 /// @brief Removes an element.
 /// Removes an element from Hashtable. Shrinks the bucket array to
 /// it's half size if load factor is less than load factor's
-/// low threshold.
+/// low threshold, but not below the reserved bucket count. Releases
+/// bucket array of empty Hashtable unless buckets are reserved.
+/// Shrink waits for a quarter of bucket count operations, at least
+/// 16, after the last resize. Moves a few buckets of pending
+/// incremental resize, new resize doesn't start before it's finished.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @tparam Q type of key or of view of key.
 /// @param key is a key to Hashtable's element.
 /// @return nothing.
 /// @throw bucket_index exception if a bucket number returned
 /// by hash funtion is out of the bucket array range.
-template <typename K, typename V>
-void Hashtable<K, V>::remove(const K& key) {
-  if (m_size == 0) {
-    assert(((m_buckets == nullptr) &&  (m_bucket_count == 0)));
+template <typename K, typename V, typename H, typename M>
+template <typename Q>
+void Hashtable<K, V, H, M>::erase(const Q& key) {
+  if (m_size == 0)
     return;
-  }
 
-  size_t bucket_idx = hash(key);
-  if (bucket_idx >= m_bucket_count)
-    throw exception::bucket_index(bucket_idx, __ESR_PRETTY_FUNCTION__);
+  ++m_resize_age;
+  if (m_old_buckets != nullptr)  // incremental resize is pending
+    migrate(m_MigrationStep);
 
-  bool success = m_buckets[bucket_idx].erase(key);
+  size_t bucket_idx;
+  uint64_t code = hash(key);
+  linkedlist<K, V>& bucket = bucket_of(code, &bucket_idx);
+  bool success = bucket.erase(key, code);
   if (!success) return;  // no such key
+  if (bucket.empty())
+    vacate(bucket_idx);
 
   --m_size;
 
   // shrink
-  size_t factor = load_factor();
-  if (factor == 0) {
+  if (m_resize_age < shrink_window())
+    return;
+  if (m_size == 0 && m_min_bucket_count == 0) {
     resize(0);
     return;
   }
-  if (factor < m_load_factor_bound_low) {  // unlikely
-    size_t shrunk_bucket_count = m_bucket_count/2;
-    resize(shrunk_bucket_count);
+  if (m_old_buckets == nullptr &&
+      load_factor() < m_load_factor_bound_low) {  // unlikely
+    size_t shrunk_bucket_count = std::max(m_bucket_count/2,
+                                          m_min_bucket_count);
+    if (shrunk_bucket_count < m_bucket_count)
+      resize(shrunk_bucket_count);
+  }
+}
+
+/// @brief Keeps buckets for a number of elements.
+/// Expands the bucket array at once, so that size elements are
+/// added without resize, and keeps shrink from going below it.
+/// Finishes pending incremental resize first. Smaller size lowers
+/// the limit of shrink without shrinking the bucket array.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param size is a number of elements.
+/// @return nothing.
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+void Hashtable<K, V, H, M>::reserve(size_t size) {
+  size_t bucket_count = bucket_count_for(size);
+  m_min_bucket_count = bucket_count;
+  if (bucket_count <= m_bucket_count)
+    return;
+
+  while (m_old_buckets != nullptr)
+    migrate(iteration_bucket_count());
+  resize(bucket_count);
+}
+
+/// @brief Gets a number of buckets for a number of elements.
+/// Load factor of size elements doesn't exceed upper threshold.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param size is a number of elements.
+/// @return bucket count supported by the bucket mapping, 0 for 0.
+template <typename K, typename V, typename H, typename M>
+size_t Hashtable<K, V, H, M>::bucket_count_for(size_t size) const {
+  assert(m_load_factor_bound_up != 0);
+  if (size == 0)
+    return 0;
+  return M::bucket_count(
+      (m_LoadFactor100Percents*size + m_load_factor_bound_up - 1) /
+      m_load_factor_bound_up);
+}
+
+/// @brief Turns incremental resizing on or off.
+/// Incremental resize keeps source bucket array until every
+/// it's bucket is moved, a few buckets per add() and remove(). Lookups
+/// move nothing, so they don't invalidate iterators.
+/// Turning it off finishes pending incremental resize.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param incremental is true to resize incrementally.
+/// @return nothing.
+template <typename K, typename V, typename H, typename M>
+void Hashtable<K, V, H, M>::set_incremental_resize(bool incremental) {
+  m_incremental = incremental;
+  while (!incremental && m_old_buckets != nullptr)
+    migrate(m_bucket_count + m_old_bucket_count);
+}
+
+/// @brief Sets parallel resize.
+/// Resize of a table of threshold elements and more, which isn't
+/// incremental, relinks nodes by a number of threads, see
+/// rehash_parallel(). Resize of a smaller table stays on the
+/// calling thread: starting threads costs more than it saves. Off
+/// by default, every resize stays on the calling thread.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param threshold is the least number of elements resized by
+/// threads, SIZE_MAX turns parallel resize off.
+/// @param workers is a number of threads, 0 for the number of
+/// hardware threads.
+/// @return nothing.
+template <typename K, typename V, typename H, typename M>
+void Hashtable<K, V, H, M>::set_parallel_resize(size_t threshold,
+                                                size_t workers) {
+  m_parallel_threshold = threshold;
+  m_resize_workers = workers;
+}
+
+/// @brief Moves nodes of a few source buckets to the bucket array.
+/// Constructs buckets of the bucket array first, all keys stay in
+/// source buckets meanwhile. Then relinks nodes, doesn't copy them,
+/// and destroys every moved source bucket. Releases source bucket
+/// array when every it's bucket is moved.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param bucket_count is a number of source buckets to move.
+/// @return nothing.
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+void Hashtable<K, V, H, M>::migrate(size_t bucket_count) {
+  assert(m_old_buckets != nullptr);
+  if (m_constructed < m_bucket_count) {
+    size_t last = std::min(m_constructed + m_ConstructionRatio*bucket_count,
+                           m_bucket_count);
+    for (; m_constructed < last; ++m_constructed)
+      new(&m_buckets[m_constructed]) linkedlist<K, V>(m_pool);
+    return;
+  }
+
+  size_t last = std::min(m_migrated + bucket_count, m_old_bucket_count);
+  for (; m_migrated < last; ++m_migrated) {
+    linkedlist<K, V>& bucket = m_old_buckets[m_migrated];
+    // Checks the chain first: bucket is either moved or left whole.
+    for (listnode<K, V>* node = bucket.front(); node; node = node->next()) {
+      size_t bucket_idx = m_mapping(code_of(*node));
+      if (bucket_idx >= m_bucket_count)
+        throw exception::bucket_index(bucket_idx, __ESR_PRETTY_FUNCTION__);
+    }
+    while (listnode<K, V>* node = bucket.unlink_front()) {
+      size_t bucket_idx = m_mapping(code_of(*node));
+      m_buckets[bucket_idx].link_front(node);
+      m_occupied.set(bucket_idx);
+    }
+    bucket.~linkedlist<K, V>();
+  }
+
+  if (m_migrated == m_old_bucket_count) {
+    delete_buckets(m_old_buckets, 0, 0);
+    m_old_buckets = nullptr;
+    m_old_occupied = bitmap();
+    m_old_bucket_count = 0;
+    m_migrated = 0;
   }
 }
 
 /// @brief Resizes bucket array.
-/// Creates new hashfunction with a cardinality equal to new
-/// buckets count. Creates new bucket array. Adds every element
-/// from source bucket array to new bucket array using new hash
-/// function. Deletes source bucket array.
+/// Creates new bucket mapping for new buckets count.
+/// Creates new bucket array. Relinks every node
+/// of source bucket array to new bucket array using new bucket
+/// mapping: nodes are neither copied nor reallocated, so their
+/// addresses stay valid. Deletes source bucket array.
+/// Incremental resize only allocates new bucket array, keeps
+/// source one and leaves the rest to migrate().
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
 /// @param bucket_count is a bucket array size.
 /// @return nothing.
 /// @throw bucket_index exception if a bucket number returned
 /// by hash funtion is out of the bucket array range.
-template <typename K, typename V>
-void Hashtable<K, V>::resize(size_t bucket_count) {
+template <typename K, typename V, typename H, typename M>
+void Hashtable<K, V, H, M>::resize(size_t bucket_count) {
   assert(bucket_count != m_bucket_count);
-  size_t size = 0;
-  linkedlist<K, V>* table = nullptr;
-  if (bucket_count != 0) {
-    std::unique_ptr<linkedlist<K, V>[]> ptr(new linkedlist<K, V>[bucket_count]);
-    table = ptr.get();
-    hash = hash_function<K>(bucket_count);  // new hash function from family
-
-    // Rehash: adds every entry of table to new one
+  m_resize_age = 0;
+  if (bucket_count == 0) {
+    assert(m_size == 0);
+    delete_buckets(m_old_buckets, m_migrated, m_old_bucket_count);
+    m_old_buckets = nullptr;
+    m_old_occupied = bitmap();
+    m_old_bucket_count = 0;
+    m_migrated = 0;
+    delete_buckets(m_buckets, 0, m_constructed);
+    m_bucket_count = 0;
+    m_buckets = nullptr;
+    m_occupied = bitmap();
+    m_constructed = 0;
+    return;
+  }
+  assert(m_old_buckets == nullptr);
+  M new_mapping(bucket_count);
+
+  if (m_incremental && m_bucket_count != 0) {
+    // Keeps source bucket array, buckets are built by later operations
+    bitmap occupied(bucket_count);
+    linkedlist<K, V>* table = allocate_buckets(bucket_count);
+    m_old_buckets = m_buckets;
+    m_old_occupied = std::move(m_occupied);
+    m_old_bucket_count = m_bucket_count;
+    m_old_mapping = m_mapping;
+    m_migrated = 0;
+    m_mapping = new_mapping;
+    m_bucket_count = bucket_count;
+    m_buckets = table;
+    m_occupied = std::move(occupied);
+    m_constructed = 0;
+    return;
+  }
+
+  // Rehash: moves every node of table to new one
+  bitmap occupied(bucket_count);
+  linkedlist<K, V>* table = make_buckets(bucket_count);
+  size_t workers = std::min(
+      m_resize_workers != 0 ? m_resize_workers : hardware_workers(),
+      m_bucket_count);
+  if (m_size >= m_parallel_threshold && workers > 1) {
+    rehash_parallel(table, &occupied, new_mapping, bucket_count, workers);
+  } else {
     for (int i = 0; i < m_bucket_count; ++i) {
       linkedlist<K, V>& bucket = m_buckets[i];
-      for (listnode<K, V>* node = bucket.front(); node; node = node->next()) {
-        size_t bucket_idx =  hash(node->key());
-        if (bucket_idx >= bucket_count)
-          throw exception::bucket_index(bucket_idx, __ESR_PRETTY_FUNCTION__);
-        bool success = table[bucket_idx].push_back(node->key(), node->value());
-        assert(success);
-        ++size;
+      while (listnode<K, V>* node = bucket.front()) {
+        size_t bucket_idx = new_mapping(code_of(*node));
+        if (bucket_idx >= bucket_count) {  // unlikely: moves nodes back
+          for (size_t j = 0; j < bucket_count; ++j)
+            while (listnode<K, V>* moved = table[j].unlink_front())
+              m_buckets[m_mapping(code_of(*moved))].link_front(moved);
+          delete_buckets(table, 0, bucket_count);
+          throw exception::bucket_index(bucket_idx,
+                                        __ESR_PRETTY_FUNCTION__);
+        }
+        table[bucket_idx].link_front(bucket.unlink_front());
+        occupied.set(bucket_idx);
       }
     }
-    ptr.release();
-    if (m_buckets != nullptr)
-      delete [] m_buckets;
   }
-  m_size = size;
+  delete_buckets(m_buckets, 0, m_bucket_count);
+  m_mapping = new_mapping;
   m_bucket_count = bucket_count;
   m_buckets = table;
+  m_occupied = std::move(occupied);
+  m_constructed = bucket_count;
+}
+
+/// @brief Relinks nodes to new bucket array by a number of threads.
+/// Every worker owns a range of source buckets and a range of new
+/// buckets, so no bucket is shared and no atomic is needed. Scatter:
+/// worker t unlinks nodes of it's source range and links every node
+/// to the outbox of the worker owning it's new bucket. Gather:
+/// worker w relinks nodes of all outboxes addressed to it into it's
+/// new buckets. Nodes are neither copied nor reallocated. Then every
+/// worker sets bits of not empty new buckets of a range of bitmap
+/// words.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param table is a new bucket array, it's buckets constructed.
+/// @param occupied is a bitmap of new bucket array, bits clear.
+/// @param mapping is a bucket mapping of new bucket array.
+/// @param bucket_count is a size of new bucket array.
+/// @param workers is a number of threads, not greater than number
+/// of source buckets.
+/// @return nothing.
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range, or the first
+/// exception of a thread: every node is back in source bucket
+/// array, new one is deleted.
+template <typename K, typename V, typename H, typename M>
+void Hashtable<K, V, H, M>::rehash_parallel(linkedlist<K, V>* table,
+                                            bitmap* occupied,
+                                            const M& mapping,
+                                            size_t bucket_count,
+                                            size_t workers) {
+  // outboxes[t*workers + w]: nodes of source range t for worker w
+  linkedlist<K, V>* outboxes = nullptr;
+  std::unique_ptr<size_t[]> bad_idx;
+  try {
+    outboxes = make_buckets(workers*workers);
+    bad_idx.reset(new size_t[workers]);
+  } catch (...) {
+    delete_buckets(outboxes, 0, outboxes == nullptr ? 0 : workers*workers);
+    delete_buckets(table, 0, bucket_count);
+    throw;
+  }
+
+  // Moves nodes of outboxes and of new buckets back, deletes both
+  auto restore = [this, table, outboxes, bucket_count, workers]() {
+    for (size_t i = 0; i < workers*workers; ++i)
+      while (listnode<K, V>* moved = outboxes[i].unlink_front())
+        m_buckets[m_mapping(code_of(*moved))].link_front(moved);
+    for (size_t i = 0; i < bucket_count; ++i)
+      while (listnode<K, V>* moved = table[i].unlink_front())
+        m_buckets[m_mapping(code_of(*moved))].link_front(moved);
+    delete_buckets(outboxes, 0, workers*workers);
+    delete_buckets(table, 0, bucket_count);
+  };
+
+  try {
+    parallel_run(workers, [this, outboxes, &bad_idx, &mapping, bucket_count,
+                           workers](size_t t) {
+        bad_idx[t] = bucket_count;
+        linkedlist<K, V>* outbox = &outboxes[t*workers];
+        for (size_t i = m_bucket_count*t/workers;
+             i < m_bucket_count*(t + 1)/workers; ++i) {
+          while (listnode<K, V>* node = m_buckets[i].front()) {
+            size_t bucket_idx = mapping(code_of(*node));
+            if (bucket_idx >= bucket_count) {  // unlikely
+              bad_idx[t] = bucket_idx;
+              return;
+            }
+            outbox[bucket_idx*workers/bucket_count].link_front(
+                m_buckets[i].unlink_front());
+          }
+        }
+      });
+  } catch (...) {
+    restore();
+    throw;
+  }
+
+  for (size_t t = 0; t < workers; ++t) {
+    if (bad_idx[t] != bucket_count) {  // unlikely: moves nodes back
+      restore();
+      throw exception::bucket_index(bad_idx[t], __ESR_PRETTY_FUNCTION__);
+    }
+  }
+
+  try {
+    parallel_run(workers, [this, table, outboxes, &mapping,
+                           workers](size_t w) {
+        for (size_t t = 0; t < workers; ++t) {
+          linkedlist<K, V>& outbox = outboxes[t*workers + w];
+          while (listnode<K, V>* node = outbox.front()) {
+            size_t bucket_idx = mapping(code_of(*node));
+            table[bucket_idx].link_front(outbox.unlink_front());
+          }
+        }
+      });
+  } catch (...) {
+    restore();
+    throw;
+  }
+  delete_buckets(outboxes, 0, workers*workers);
+
+  size_t word_bits = bitmap::word_bits();
+  size_t word_count = (bucket_count + word_bits - 1)/word_bits;
+  parallel_run(workers, [table, occupied, bucket_count, workers, word_bits,
+                         word_count](size_t w) {
+      size_t last = std::min(word_count*(w + 1)/workers*word_bits,
+                             bucket_count);
+      for (size_t i = word_count*w/workers*word_bits; i < last; ++i)
+        if (!table[i].empty())
+          occupied->set(i);
+    });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Bulk Load.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Replaces elements by a range of key, value pairs.
+/// Builds new bucket array at once instead of resizing it while
+/// adding one by one, see bulk_load(). The first of duplicate keys
+/// is kept, as add() does. Content is left as is on exception.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @tparam ForwardIt type of forward iterator to std::pair of key,
+/// value or alike, std::move_iterator moves them to the elements.
+/// @param first is the beginning of the range.
+/// @param last is the end of the range.
+/// @param unique_keys is true if the range has no duplicate keys,
+/// skips duplicate checks. Duplicates of such range stay in table.
+/// @return nothing.
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+template <typename ForwardIt>
+void Hashtable<K, V, H, M>::assign_bulk(ForwardIt first, ForwardIt last,
+                                        bool unique_keys) {
+  Hashtable table(m_load_factor_bound_low, m_load_factor_bound_up);
+  table.m_incremental = m_incremental;
+  table.m_parallel_threshold = m_parallel_threshold;
+  table.m_resize_workers = m_resize_workers;
+  table.m_min_bucket_count = m_min_bucket_count;
+  table.bulk_load(first, last, unique_keys);
+  swap(table);
+}
+
+/// @brief Loads a range of key, value pairs.
+/// Sizes bucket array once for the whole range. Hashes every key
+/// once and counts elements per bucket. Then creates every node
+/// right at it's bucket's place of a contiguous run of nodes,
+/// counting sort style, and links chains: nodes of a chain are
+/// next to each other, chains follow bucket order.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @tparam ForwardIt type of forward iterator to std::pair of key,
+/// value or alike.
+/// @param first is the beginning of the range.
+/// @param last is the end of the range.
+/// @param unique_keys is true to skip duplicate checks.
+/// @return nothing.
+/// @throw bucket_index exception if a bucket number returned
+/// by hash funtion is out of the bucket array range.
+template <typename K, typename V, typename H, typename M>
+template <typename ForwardIt>
+void Hashtable<K, V, H, M>::bulk_load(ForwardIt first, ForwardIt last,
+                                      bool unique_keys) {
+  typedef nodepool<listnode<K, V>> pool;
+  assert(m_size == 0 && m_bucket_count == 0);
+  size_t size = std::distance(first, last);
+  if (size == 0)
+    return;
+
+  size_t bucket_count = std::max(bucket_count_for(size), m_min_bucket_count);
+  M mapping(bucket_count);
+  std::unique_ptr<uint64_t[]> codes(new uint64_t[size]);
+  std::unique_ptr<size_t[]> offsets(new size_t[bucket_count + 1]());
+  std::unique_ptr<size_t[]> cursors(new size_t[bucket_count]);
+
+  // Counts elements per bucket
+  size_t i = 0;
+  for (ForwardIt it = first; it != last; ++it, ++i) {
+    codes[i] = hash((*it).first);
+    size_t bucket_idx = mapping(codes[i]);
+    if (bucket_idx >= bucket_count)
+      throw exception::bucket_index(bucket_idx, __ESR_PRETTY_FUNCTION__);
+    ++offsets[bucket_idx + 1];
+  }
+  for (size_t j = 0; j < bucket_count; ++j) {
+    offsets[j + 1] += offsets[j];
+    cursors[j] = offsets[j];
+  }
+
+  bitmap occupied(bucket_count);
+  m_buckets = make_buckets(bucket_count);
+  m_occupied = std::move(occupied);
+  m_mapping = mapping;
+  m_bucket_count = bucket_count;
+  m_constructed = bucket_count;
+  m_resize_age = 0;
+
+  // Creates nodes in place, range order is kept within a bucket
+  typename pool::slot* run = m_pool->allocate_run(size);
+  try {
+    i = 0;
+    for (ForwardIt it = first; it != last; ++it, ++i) {
+      size_t& cursor = cursors[mapping(codes[i])];
+      m_pool->create_at(&run[cursor], emplace_tag(), codes[i], (*it).first,
+                        (*it).second);
+      ++cursor;
+    }
+  } catch (...) {
+    for (size_t j = 0; j < bucket_count; ++j)
+      for (size_t k = offsets[j]; k < cursors[j]; ++k)
+        m_pool->destroy(pool::node(&run[k]));
+    throw;
+  }
+
+  // Links chains, the first of duplicate keys is kept
+  for (size_t j = 0; j < bucket_count; ++j) {
+    linkedlist<K, V>& bucket = m_buckets[j];
+    for (size_t k = offsets[j]; k < offsets[j + 1]; ++k) {
+      listnode<K, V>* node = pool::node(&run[k]);
+      if (!unique_keys &&
+          bucket.find(node->key(), node->hash_code()) != nullptr) {
+        m_pool->destroy(node);
+        continue;
+      }
+      bucket.link_back(node);
+      ++m_size;
+    }
+    if (!bucket.empty())
+      m_occupied.set(j);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Snapshot.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Writes elements to binary snapshot.
+/// Snapshot is m_SnapshotMagic, number of elements by write_size()
+/// and key, value of every element by serializer<K>, serializer<V>.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param os is an output stream, binary.
+/// @return nothing.
+/// @throw table_file exception if stream fails.
+template <typename K, typename V, typename H, typename M>
+void Hashtable<K, V, H, M>::save(std::ostream& os) const {
+  serializer<K> key_serializer;
+  serializer<V> value_serializer;
+  os.write(m_SnapshotMagic, sizeof(m_SnapshotMagic));
+  write_size(os, m_size);
+  size_t bucket_count = iteration_bucket_count();
+  for (size_t i = next_occupied(0); os && i < bucket_count;
+       i = next_occupied(i + 1)) {
+    for (listnode<K, V>* node = bucket_at(i)->front(); node != nullptr;
+         node = node->next()) {
+      key_serializer.write(os, node->key());
+      value_serializer.write(os, node->value());
+    }
+  }
+  if (!os)
+    throw exception::table_file("", __ESR_PRETTY_FUNCTION__,
+                                "can't write snapshot");
+}
+
+/// @brief Replaces elements by elements of binary snapshot.
+/// Reads elements written by save() and loads them at once, without
+/// duplicate checks: bucket array is sized for their number and not
+/// resized, see bulk_load(). Element array grows by doubling from
+/// m_LoadChunk elements up to number of snapshot, so a corrupted
+/// number fails on the end of stream. Content is left as is on
+/// exception.
+/// @tparam K type of hash key, default constructible.
+/// @tparam V type of hash value, default constructible.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param is is an input stream, binary.
+/// @return nothing.
+/// @throw table_file exception if stream isn't a snapshot or fails.
+template <typename K, typename V, typename H, typename M>
+void Hashtable<K, V, H, M>::load(std::istream& is) {
+  typedef std::pair<K, V> element;
+  serializer<K> key_serializer;
+  serializer<V> value_serializer;
+  char magic[sizeof(m_SnapshotMagic)] = {};
+  is.read(magic, sizeof(magic));
+  uint64_t size = read_size(is);
+  if (!is || !std::equal(magic, magic + sizeof(magic), m_SnapshotMagic))
+    throw exception::table_file("", __ESR_PRETTY_FUNCTION__,
+                                "not a snapshot");
+
+  size_t capacity = std::min<uint64_t>(size, m_LoadChunk);
+  std::unique_ptr<element[]> elements(new element[capacity]);
+  for (size_t i = 0; i < size; ++i) {
+    if (i == capacity) {
+      capacity = std::min<uint64_t>(2*capacity, size);
+      std::unique_ptr<element[]> grown(new element[capacity]);
+      std::move(elements.get(), elements.get() + i, grown.get());
+      elements.swap(grown);
+    }
+    key_serializer.read(is, &elements[i].first);
+    value_serializer.read(is, &elements[i].second);
+    if (!is)
+      throw exception::table_file("", __ESR_PRETTY_FUNCTION__,
+                                  "snapshot is truncated");
+  }
+  assign_bulk(std::make_move_iterator(elements.get()),
+              std::make_move_iterator(elements.get() + size), true);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -614,13 +2285,18 @@ void Hashtable<K, V>::resize(size_t bucket_count) {
 /// Outputs the Hashtable's contents to output stream.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
 /// @param os is an output stream.
 /// @param htable is an Hashtable instance.
 /// @return reference to output stream.
-template <typename K, typename V>
-ostream & operator<<(ostream & os, const Hashtable<K, V> & htable) {
-  for (int i = 0; i < htable.m_bucket_count; ++i)
+template <typename K, typename V, typename H, typename M>
+ostream & operator<<(ostream & os, const Hashtable<K, V, H, M> & htable) {
+  for (int i = 0; i < htable.m_constructed; ++i)
     os << std::setw(3) << i << ": {" << htable.m_buckets[i] << "}\n";
+  for (size_t i = htable.m_migrated; i < htable.m_old_bucket_count; ++i)
+    os << "old " << std::setw(3) << i << ": {"
+       << htable.m_old_buckets[i] << "}\n";
   return os;
 }
 
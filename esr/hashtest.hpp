@@ -5,13 +5,45 @@
 // Correctness Test
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <string>  // std::string
+#include <algorithm>      // std::min, std::count
+#include <atomic>         // std::atomic
+#include <cstdint>        // int64_t
+#include <cstdio>         // std::remove
+#include <fstream>        // std::ofstream
+#include <sstream>        // std::ostringstream
+#include <string>         // std::string
+#include <string_view>    // std::string_view
+#include <thread>         // std::thread
+#include <tuple>          // std::forward_as_tuple
+#include <type_traits>    // std::is_nothrow_move_constructible
+#include <unordered_map>  // std::unordered_map
+#include <utility>        // std::pair, std::piecewise_construct
+#include <vector>         // std::vector
 
-#include <esr/hashtable.hpp>   // Hashtable
+#include <esr/hashtable.hpp>            // Hashtable
+#include <esr/concurrenthashtable.hpp>  // ConcurrentHashtable
+#include <esr/epochhashtable.hpp>       // EpochHashtable
+#include <esr/shardedhashtable.hpp>     // ShardedHashtable
+#include <esr/mappedhashtable.hpp>      // MappedHashtable
+#include <esr/statichashtable.hpp>      // StaticHashtable
+#include <esr/literalhashtable.hpp>     // LiteralHashtable
 #include <esr/hashexcept.hpp>  // exceptions, __ESR_PRETTY_FUNCTION__
 
 namespace esr_test {
 
+/// @brief Makes expected content of hashtable.
+/// Must be specialized for concrete key and value types.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param input_size is a desired number of elements.
+/// @param positive_table is filled with elements to be inserted.
+/// @param negative_table is filled with elements to be absent.
+/// @return result of making tables.
+template <typename K, typename V>
+bool make_expected_tables(int input_size,
+                          std::unordered_map<K, V>* positive_table,
+                          std::unordered_map<K, V>* negative_table);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @class CorrectnessTest.
 ///
@@ -43,11 +75,12 @@ class CorrectnessTest {
 /// @brief Test for setters and getters of Hashtable.
 /// Tests correctness of esr::Hashtable::add,
 /// esr::Hashtable::get, esr::Hashtable::find.
+/// @tparam Table is a hashtable engine under test.
 ///////////////////////////////////////////////////////////////////////////////
-template <typename K, typename V>
+template <typename K, typename V, typename Table = esr::Hashtable<K, V>>
 class InsertionRetrievalTest : public CorrectnessTest {
  public:
-  typedef typename esr::Hashtable<K, V>::iterator hashtable_iterator_t;
+  typedef typename Table::iterator hashtable_iterator_t;
 
   explicit InsertionRetrievalTest(int intput_size = 1024,
                                   const std::string &
@@ -56,7 +89,11 @@ class InsertionRetrievalTest : public CorrectnessTest {
                                   name = "InsertionRetrievalTest") :
       CorrectnessTest(intput_size, description, name) , m_test_table() {}
   virtual ~InsertionRetrievalTest() {}
-  virtual bool make_expected_hashtable();
+  virtual bool make_expected_hashtable() {
+    return make_expected_tables<K, V>(intput_size(),
+                                      &m_positive_table,
+                                      &m_negative_table);
+  }
 
   virtual bool run() {
     if (m_positive_table.empty()) {
@@ -79,7 +116,7 @@ class InsertionRetrievalTest : public CorrectnessTest {
   }
 
  protected:
-  esr::Hashtable<K, V> m_test_table;
+  Table m_test_table;
   std::unordered_map<K, V> m_positive_table;
   std::unordered_map<K, V> m_negative_table;
 
@@ -93,8 +130,8 @@ class InsertionRetrievalTest : public CorrectnessTest {
   bool find_negative();
 };
 
-template <typename K, typename V>
-bool InsertionRetrievalTest<K, V>::add_positive() {
+template <typename K, typename V, typename Table>
+bool InsertionRetrievalTest<K, V, Table>::add_positive() {
   for (auto & key_value : m_positive_table) {
     const K& key = key_value.first;
     const V& value = key_value.second;
@@ -110,8 +147,8 @@ bool InsertionRetrievalTest<K, V>::add_positive() {
   return true;
 }
 
-template <typename K, typename V>
-bool InsertionRetrievalTest<K, V>::add_positive_negative() {
+template <typename K, typename V, typename Table>
+bool InsertionRetrievalTest<K, V, Table>::add_positive_negative() {
   if (!add_positive())
     return false;
 
@@ -131,8 +168,8 @@ bool InsertionRetrievalTest<K, V>::add_positive_negative() {
   return true;
 }
 
-template <typename K, typename V>
-bool InsertionRetrievalTest<K, V>::get_by_pointer_positive() {
+template <typename K, typename V, typename Table>
+bool InsertionRetrievalTest<K, V, Table>::get_by_pointer_positive() {
   for (auto & key_value : m_positive_table) {
     const K& e_key = key_value.first;
     const V& e_value = key_value.second;
@@ -156,8 +193,8 @@ bool InsertionRetrievalTest<K, V>::get_by_pointer_positive() {
   return true;
 }
 
-template <typename K, typename V>
-bool InsertionRetrievalTest<K, V>::get_by_pointer_negative() {
+template <typename K, typename V, typename Table>
+bool InsertionRetrievalTest<K, V, Table>::get_by_pointer_negative() {
   for (auto & key_value : m_negative_table) {
     const K& e_key = key_value.first;
     const V& e_value = key_value.second;
@@ -173,8 +210,8 @@ bool InsertionRetrievalTest<K, V>::get_by_pointer_negative() {
   return true;
 }
 
-template <typename K, typename V>
-bool InsertionRetrievalTest<K, V>::find_positive() {
+template <typename K, typename V, typename Table>
+bool InsertionRetrievalTest<K, V, Table>::find_positive() {
   for (auto & key_value : m_positive_table) {
     const K& e_key = key_value.first;
     const V& e_value = key_value.second;
@@ -202,8 +239,8 @@ bool InsertionRetrievalTest<K, V>::find_positive() {
   return true;
 }
 
-template <typename K, typename V>
-bool InsertionRetrievalTest<K, V>::find_negative() {
+template <typename K, typename V, typename Table>
+bool InsertionRetrievalTest<K, V, Table>::find_negative() {
   for (auto & key_value : m_negative_table) {
     const K& e_key = key_value.first;
     const V& e_value = key_value.second;
@@ -228,13 +265,13 @@ bool InsertionRetrievalTest<K, V>::find_negative() {
 /// Tests correctness of esr::Hashtable::Hashtable(const Hashtable&),
 /// esr::Hashtable::operator=().
 ////////////////////////////////////////////////////////////////////////////////
-template <typename K, typename V>
-class CopyAssignmentTest : public InsertionRetrievalTest<K, V> {
+template <typename K, typename V, typename Table = esr::Hashtable<K, V>>
+class CopyAssignmentTest : public InsertionRetrievalTest<K, V, Table> {
  public:
   explicit CopyAssignmentTest(int intput_size = 1024,
                         const std::string & description = "",
                         const std::string & name = "CopyAssignmentTest") :
-      InsertionRetrievalTest<K, V>(intput_size, description, name) {}
+      InsertionRetrievalTest<K, V, Table>(intput_size, description, name) {}
   virtual bool run() {
     if (this->m_positive_table.empty()) {
       std::cout << "expected hashtable empty in "
@@ -262,9 +299,9 @@ class CopyAssignmentTest : public InsertionRetrievalTest<K, V> {
   bool copy_assignment();
 };
 
-template <typename K, typename V>
-bool CopyAssignmentTest<K, V>::copy_constructor() {
-  esr::Hashtable<K, V> temp(this->m_test_table);
+template <typename K, typename V, typename Table>
+bool CopyAssignmentTest<K, V, Table>::copy_constructor() {
+  Table temp(this->m_test_table);
   // Destination more than source
   for (auto& t : temp) {
     auto found = this->m_test_table.find(t.key());
@@ -316,9 +353,9 @@ bool CopyAssignmentTest<K, V>::copy_constructor() {
   return true;
 }
 
-template <typename K, typename V>
-bool CopyAssignmentTest<K, V>::copy_assignment() {
-  esr::Hashtable<K, V> temp;
+template <typename K, typename V, typename Table>
+bool CopyAssignmentTest<K, V, Table>::copy_assignment() {
+  Table temp;
   temp = this->m_test_table;
   // Destination more than source
   for (auto& t : temp) {
@@ -379,13 +416,13 @@ bool CopyAssignmentTest<K, V>::copy_assignment() {
 /// Tests correctness of esr::Hashtable::remove(),
 /// esr::Hashtable::operator=().
 ////////////////////////////////////////////////////////////////////////////////
-template <typename K, typename V>
-class DeletionTest : public InsertionRetrievalTest<K, V> {
+template <typename K, typename V, typename Table = esr::Hashtable<K, V>>
+class DeletionTest : public InsertionRetrievalTest<K, V, Table> {
  public:
   explicit DeletionTest(int intput_size = 1024,
                         const std::string & description = "",
                         const std::string & name = "DeletionTest") :
-      InsertionRetrievalTest<K, V>(intput_size, description, name) {}
+      InsertionRetrievalTest<K, V, Table>(intput_size, description, name) {}
   virtual bool run() {
     if (this->m_positive_table.empty()) {
       std::cout << "expected hashtable empty in "
@@ -409,9 +446,9 @@ class DeletionTest : public InsertionRetrievalTest<K, V> {
   bool rm_negative();
 };
 
-template <typename K, typename V>
-bool DeletionTest<K, V>::rm_positive() {
-    esr::Hashtable<K, V> temp = this->m_test_table;
+template <typename K, typename V, typename Table>
+bool DeletionTest<K, V, Table>::rm_positive() {
+    Table temp = this->m_test_table;
     for (auto& expect : this->m_test_table) {
       temp.remove(expect.key());
       auto found = temp.find(expect.key());
@@ -427,14 +464,1751 @@ bool DeletionTest<K, V>::rm_positive() {
     return true;
   }
 
-template <typename K, typename V>
-bool DeletionTest<K, V>::rm_negative() {
-  esr::Hashtable<K, V> temp = this->m_test_table;
+template <typename K, typename V, typename Table>
+bool DeletionTest<K, V, Table>::rm_negative() {
+  Table temp = this->m_test_table;
   for (auto& expect : this->m_negative_table)
     temp.remove(expect.first);
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @class IterationTest.
+///
+/// @brief Test for iteration over sparse Hashtable.
+/// Tests that esr::Hashtable::begin() and iterator increment meet
+/// every element once after mass removal left buckets mostly empty,
+/// after all elements are removed and after they are added back, and
+/// while a resize is pending, with esr::Hashtable::find() and
+/// esr::Hashtable::find_batch() of every element met.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V, typename Table = esr::Hashtable<K, V>>
+class IterationTest : public InsertionRetrievalTest<K, V, Table> {
+ public:
+  explicit IterationTest(int intput_size = 1024,
+                         const std::string & description = "",
+                         const std::string & name = "IterationTest") :
+      InsertionRetrievalTest<K, V, Table>(intput_size, description, name) {}
+  virtual bool run() {
+    if (this->m_positive_table.empty()) {
+      std::cout << "expected hashtable empty in "
+                << __ESR_PRETTY_FUNCTION__ << '\n'
+                << std::flush;
+      return false;
+    }
+    // reserved buckets stay while the table empties
+    this->m_test_table.reserve(this->m_positive_table.size());
+    if (!this->add_positive() || !iterate(this->m_positive_table.size())) {
+      std::cout << "Unexpected iteration of full table. " << std::flush;
+      return false;
+    }
+    size_t kept = 0;
+    size_t i = 0;
+    for (auto& expect : this->m_positive_table) {
+      if (i++ % m_KeepEvery == 0)
+        ++kept;
+      else
+        this->m_test_table.remove(expect.first);
+    }
+    if (!iterate(kept)) {
+      std::cout << "Unexpected iteration of sparse table. " << std::flush;
+      return false;
+    }
+    for (auto& expect : this->m_positive_table)
+      this->m_test_table.remove(expect.first);
+    if (!iterate(0) || !this->add_positive() ||
+        !iterate(this->m_positive_table.size())) {
+      std::cout << "Unexpected iteration of refilled table. " << std::flush;
+      return false;
+    }
+    if (!iterate_finding()) {
+      std::cout << "Unexpected iteration of resized table. " << std::flush;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  /// One of this number of elements is kept by mass removal.
+  static const size_t m_KeepEvery = 64;
+
+  bool iterate(size_t expected);
+  bool iterate_finding();
+};
+
+/// Elements met by iteration are expected ones, as many as there are.
+template <typename K, typename V, typename Table>
+bool IterationTest<K, V, Table>::iterate(size_t expected) {
+  size_t visited = 0;
+  for (auto& element : this->m_test_table) {
+    auto expect = this->m_positive_table.find(element.key());
+    if (expect == this->m_positive_table.end() ||
+        expect->second != element.value() ||
+        this->m_test_table.get(element.key()) == nullptr) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << element.key() << " is unexpected. "
+                << std::flush;
+      return false;
+    }
+    ++visited;
+  }
+  if (visited != expected || visited != this->m_test_table.size()) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "visited " << visited << " elements of "
+              << expected << ". " << std::flush;
+    return false;
+  }
+  return true;
+}
+
+/// Lookups don't move elements: iteration meets every one once.
+template <typename K, typename V, typename Table>
+bool IterationTest<K, V, Table>::iterate_finding() {
+  // Adds half of elements, then more until a resize starts: incremental
+  // one is pending
+  Table table;
+  size_t bucket_count = 0;
+  for (auto& expect : this->m_negative_table) {
+    table.add(expect.first, expect.second);
+    if (table.size() == this->m_negative_table.size()/2)
+      bucket_count = table.bucket_count();
+    else if (bucket_count != 0 && table.bucket_count() != bucket_count)
+      break;
+  }
+
+  std::unordered_map<K, size_t> visits;
+  for (auto& element : table) {
+    auto found = table.end();
+    table.find_batch(&element.key(), 1, &found);
+    if (table.find(element.key()) == table.end() || found == table.end() ||
+        ++visits[element.key()] != 1) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << element.key() << " is met twice or lost. "
+                << std::flush;
+      return false;
+    }
+  }
+  if (visits.size() != table.size()) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "visited " << visits.size() << " elements of "
+              << table.size() << ". " << std::flush;
+    return false;
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class InsertionOrderTest.
+///
+/// @brief Test for iteration order of insertion ordered Hashtable.
+/// Tests that esr::CompactHashtable iteration meets elements in the
+/// order they were added, after every other one is removed and after
+/// removed ones are added back, at the end of the order.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V, typename Table>
+class InsertionOrderTest : public InsertionRetrievalTest<K, V, Table> {
+ public:
+  explicit InsertionOrderTest(int intput_size = 1024,
+                              const std::string & description = "",
+                              const std::string & name =
+                              "InsertionOrderTest") :
+      InsertionRetrievalTest<K, V, Table>(intput_size, description, name) {}
+  virtual bool run() {
+    if (this->m_positive_table.empty()) {
+      std::cout << "expected hashtable empty in "
+                << __ESR_PRETTY_FUNCTION__ << '\n'
+                << std::flush;
+      return false;
+    }
+    std::vector<K> order;
+    for (auto& expect : this->m_positive_table)
+      order.push_back(expect.first);
+    if (!this->add_positive() || !iterate(order)) {
+      std::cout << "Unexpected order of full table. " << std::flush;
+      return false;
+    }
+    std::vector<K> kept;
+    std::vector<K> removed;
+    for (size_t i = 0; i < order.size(); ++i) {
+      if (i % 2 == 0) {
+        kept.push_back(order[i]);
+      } else {
+        removed.push_back(order[i]);
+        this->m_test_table.remove(order[i]);
+      }
+    }
+    if (!iterate(kept)) {
+      std::cout << "Unexpected order after removal. " << std::flush;
+      return false;
+    }
+    for (auto& key : removed) {
+      this->m_test_table.add(key, this->m_positive_table[key]);
+      kept.push_back(key);
+    }
+    if (!iterate(kept)) {
+      std::cout << "Unexpected order after re-insertion. " << std::flush;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  bool iterate(const std::vector<K>& order);
+};
+
+/// Elements met by iteration are expected ones, in expected order.
+template <typename K, typename V, typename Table>
+bool InsertionOrderTest<K, V, Table>::iterate(const std::vector<K>& order) {
+  size_t visited = 0;
+  for (auto& element : this->m_test_table) {
+    if (visited == order.size() || !(element.key() == order[visited]) ||
+        !(element.value() == this->m_positive_table[element.key()])) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << element.key() << " is out of order at "
+                << visited << ". " << std::flush;
+      return false;
+    }
+    ++visited;
+  }
+  if (visited != order.size() || visited != this->m_test_table.size()) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "visited " << visited << " elements of "
+              << order.size() << ". " << std::flush;
+    return false;
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class ReserveTest.
+///
+/// @brief Test for reserved buckets and resize hysteresis.
+/// Tests that esr::Hashtable::reserve() keeps bucket array while
+/// loading and emptying, and that oscillating size doesn't resize
+/// on every esr::Hashtable::add(), esr::Hashtable::remove().
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V, typename Table = esr::Hashtable<K, V>>
+class ReserveTest : public InsertionRetrievalTest<K, V, Table> {
+ public:
+  explicit ReserveTest(int intput_size = 1024,
+                       const std::string & description = "",
+                       const std::string & name = "ReserveTest") :
+      InsertionRetrievalTest<K, V, Table>(intput_size, description, name) {}
+  virtual bool run() {
+    if (this->m_positive_table.empty()) {
+      std::cout << "expected hashtable empty in "
+                << __ESR_PRETTY_FUNCTION__ << '\n'
+                << std::flush;
+      return false;
+    }
+    if (!reserved() || !oscillation()) {
+      std::cout << "Unexpected resize behavour. " << std::flush;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  bool reserved();
+  bool oscillation();
+
+  /// Number of add(), remove() pairs of oscillation.
+  static const size_t m_Oscillations = 1024;
+
+  /// Least number of elements oscillating around thresholds.
+  static const size_t m_FillSize = 1024;
+};
+
+template <typename K, typename V, typename Table>
+bool ReserveTest<K, V, Table>::reserved() {
+  this->m_test_table.reserve(this->m_positive_table.size());
+  size_t bucket_count = this->m_test_table.bucket_count();
+  if (!this->add_positive())
+    return false;
+  for (auto& expect : this->m_positive_table) {
+    const V* value = this->m_test_table.get(expect.first);
+    if (value == nullptr || *value != expect.second) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << expect.first << " not found. "
+                << std::flush;
+      return false;
+    }
+  }
+  for (auto& expect : this->m_positive_table)
+    this->m_test_table.remove(expect.first);
+  if (this->m_test_table.bucket_count() != bucket_count ||
+      this->m_test_table.size() != 0) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "bucket count " << this->m_test_table.bucket_count()
+              << " doesn't match reserved " << bucket_count << ". "
+              << std::flush;
+    return false;
+  }
+  return true;
+}
+
+template <typename K, typename V, typename Table>
+bool ReserveTest<K, V, Table>::oscillation() {
+  // Size oscillates between 0 and 1
+  Table table;
+  const K& key = this->m_positive_table.begin()->first;
+  const V& value = this->m_positive_table.begin()->second;
+  size_t resize_count = 0;
+  size_t bucket_count = table.bucket_count();
+  for (size_t i = 0; i < m_Oscillations; ++i) {
+    table.add(key, value);
+    resize_count += (table.bucket_count() != bucket_count) ? 1 : 0;
+    bucket_count = table.bucket_count();
+    table.remove(key);
+    resize_count += (table.bucket_count() != bucket_count) ? 1 : 0;
+    bucket_count = table.bucket_count();
+  }
+  if (resize_count > m_Oscillations/4) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << resize_count << " resizes of 0, 1 oscillation. "
+              << std::flush;
+    return false;
+  }
+
+  // Size oscillates around both thresholds: fills keys until expansion
+  std::vector<K> keys;
+  for (auto& expect : this->m_positive_table) {
+    table.add(expect.first, expect.second);
+    keys.push_back(expect.first);
+    if (table.bucket_count() != bucket_count && keys.size() > m_FillSize)
+      break;
+    bucket_count = table.bucket_count();
+  }
+  if (keys.size() <= m_FillSize)
+    return true;  // too few keys to oscillate
+
+  // then removes and adds back a few last keys
+  bucket_count = table.bucket_count();
+  size_t amplitude = bucket_count/32;
+  size_t rounds = 64;
+  resize_count = 0;
+  for (size_t i = 0; i < rounds; ++i) {
+    for (size_t j = keys.size() - amplitude; j < keys.size(); ++j) {
+      table.remove(keys[j]);
+      resize_count += (table.bucket_count() != bucket_count) ? 1 : 0;
+      bucket_count = table.bucket_count();
+    }
+    for (size_t j = keys.size() - amplitude; j < keys.size(); ++j) {
+      table.add(keys[j], this->m_positive_table[keys[j]]);
+      resize_count += (table.bucket_count() != bucket_count) ? 1 : 0;
+      bucket_count = table.bucket_count();
+    }
+  }
+  if (resize_count > rounds/2 || table.size() != keys.size()) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << resize_count << " resizes of " << rounds
+              << " oscillations around thresholds. " << std::flush;
+    return false;
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class BulkLoadTest.
+///
+/// @brief Test for bulk load of Hashtable.
+/// Tests correctness of esr::Hashtable constructor of a range and
+/// esr::Hashtable::assign_bulk() with and without duplicate keys.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V, typename Table = esr::Hashtable<K, V>>
+class BulkLoadTest : public InsertionRetrievalTest<K, V, Table> {
+ public:
+  explicit BulkLoadTest(int intput_size = 1024,
+                        const std::string & description = "",
+                        const std::string & name = "BulkLoadTest") :
+      InsertionRetrievalTest<K, V, Table>(intput_size, description, name) {}
+  virtual bool run() {
+    if (this->m_positive_table.empty()) {
+      std::cout << "expected hashtable empty in "
+                << __ESR_PRETTY_FUNCTION__ << '\n'
+                << std::flush;
+      return false;
+    }
+
+    // Unique keys
+    Table table(this->m_positive_table.begin(), this->m_positive_table.end(),
+                true);
+    if (!match(table)) {
+      std::cout << "Unexpected construction behavour. " << std::flush;
+      return false;
+    }
+
+    // Every key twice, the first value is kept
+    std::vector<std::pair<K, V>> range(this->m_positive_table.begin(),
+                                       this->m_positive_table.end());
+    for (auto& expect : this->m_negative_table)
+      range.push_back(std::make_pair(expect.first, expect.second));
+    range.insert(range.end(), range.begin(), range.end());
+    for (size_t i = range.size()/2; i < range.size(); ++i)
+      range[i].second = V();
+    table.assign_bulk(range.begin(), range.begin() + range.size()/2);
+    table.assign_bulk(range.begin(), range.end());
+    for (auto& expect : this->m_negative_table)
+      table.remove(expect.first);
+    if (!match(table)) {
+      std::cout << "Unexpected assignment behavour. " << std::flush;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  bool match(Table& table);
+};
+
+template <typename K, typename V, typename Table>
+bool BulkLoadTest<K, V, Table>::match(Table& table) {
+  if (table.size() != this->m_positive_table.size()) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "size " << table.size() << " doesn't match expected "
+              << this->m_positive_table.size() << ". " << std::flush;
+    return false;
+  }
+  for (auto& expect : this->m_positive_table) {
+    const V* value = table.get(expect.first);
+    if (value == nullptr || *value != expect.second) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << expect.first << " not found. "
+                << std::flush;
+      return false;
+    }
+  }
+  for (auto& expect : this->m_negative_table) {
+    if (table.get(expect.first) != nullptr) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << expect.first << " found. "
+                << std::flush;
+      return false;
+    }
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class MoveTest.
+///
+/// @brief Test for move semantics of Hashtable.
+/// Tests correctness of esr::Hashtable::add() of rvalues,
+/// esr::Hashtable::emplace(), esr::Hashtable::try_emplace(),
+/// move constructor and move assignment, which neither allocate
+/// nor throw: std::vector moves tables when it grows.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V, typename Table = esr::Hashtable<K, V>>
+class MoveTest : public InsertionRetrievalTest<K, V, Table> {
+ public:
+  explicit MoveTest(int intput_size = 1024,
+                    const std::string & description = "",
+                    const std::string & name = "MoveTest") :
+      InsertionRetrievalTest<K, V, Table>(intput_size, description, name) {}
+  virtual bool run() {
+    if (this->m_positive_table.empty()) {
+      std::cout << "expected hashtable empty in "
+                << __ESR_PRETTY_FUNCTION__ << '\n'
+                << std::flush;
+      return false;
+    }
+    if (!add_moved() || !move_table()) {
+      std::cout << "Unexpected move behavour. " << std::flush;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  bool add_moved();
+  bool move_table();
+};
+
+template <typename K, typename V, typename Table>
+bool MoveTest<K, V, Table>::add_moved() {
+  size_t i = 0;
+  for (auto& expect : this->m_positive_table) {
+    K key = expect.first;
+    V value = expect.second;
+    bool success = false;
+    switch (i++ % 3) {
+      case 0:
+        success = this->m_test_table.add(std::move(key), std::move(value));
+        break;
+      case 1:
+        success = this->m_test_table.emplace(key, value);
+        break;
+      default:
+        success = this->m_test_table.emplace(std::piecewise_construct,
+                                             std::forward_as_tuple(key),
+                                             std::forward_as_tuple(value));
+    }
+    if (!success) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "failed to add(key = " << expect.first << "). "
+                << std::flush;
+      return false;
+    }
+  }
+
+  // Duplicate key: arguments are left as they are
+  for (auto& expect : this->m_positive_table) {
+    K key = expect.first;
+    V value = V();
+    if (this->m_test_table.try_emplace(std::move(key), std::move(value)) ||
+        this->m_test_table.add(std::move(key), std::move(value)) ||
+        !(key == expect.first) ||
+        *this->m_test_table.get(expect.first) != expect.second) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "duplicate key = " << expect.first << " moved. "
+                << std::flush;
+      return false;
+    }
+  }
+  for (auto& expect : this->m_negative_table) {
+    if (!this->m_test_table.try_emplace(expect.first, expect.second) ||
+        *this->m_test_table.get(expect.first) != expect.second) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "failed to try_emplace(key = " << expect.first << "). "
+                << std::flush;
+      return false;
+    }
+    this->m_test_table.remove(expect.first);
+  }
+  return this->m_test_table.size() == this->m_positive_table.size();
+}
+
+template <typename K, typename V, typename Table>
+bool MoveTest<K, V, Table>::move_table() {
+  if (!std::is_nothrow_move_constructible<Table>::value) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "move constructor may throw. " << std::flush;
+    return false;
+  }
+  const V* value = this->m_test_table.get(
+      this->m_positive_table.begin()->first);
+  Table moved(std::move(this->m_test_table));
+  if (this->m_test_table.size() != 0 ||
+      moved.size() != this->m_positive_table.size() ||
+      moved.get(this->m_positive_table.begin()->first) != value) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "move constructor copied. " << std::flush;
+    return false;
+  }
+
+  // Moved-from table is usable, moved back by assignment
+  this->m_test_table.add(this->m_negative_table.begin()->first,
+                         this->m_negative_table.begin()->second);
+  this->m_test_table = std::move(moved);
+  if (this->m_test_table.size() != this->m_positive_table.size() ||
+      this->m_test_table.get(this->m_positive_table.begin()->first) != value) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "move assignment copied. " << std::flush;
+    return false;
+  }
+  for (auto& expect : this->m_positive_table) {
+    const V* found = this->m_test_table.get(expect.first);
+    if (found == nullptr || *found != expect.second) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << expect.first << " lost. " << std::flush;
+      return false;
+    }
+  }
+
+  // Growing vector moves tables, elements stay in place
+  std::vector<Table> tables;
+  tables.push_back(std::move(this->m_test_table));
+  for (int i = 0; i < 16; ++i)
+    tables.emplace_back();
+  if (tables.front().get(this->m_positive_table.begin()->first) != value) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "vector copied table. " << std::flush;
+    return false;
+  }
+  this->m_test_table = std::move(tables.front());
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class KeyViewTest.
+///
+/// @brief Test for heterogeneous lookup of Hashtable.
+/// Tests correctness of esr::Hashtable::find(), esr::Hashtable::get(),
+/// esr::Hashtable::contains() and esr::Hashtable::remove() by
+/// std::string_view and const char* of std::string keys.
+////////////////////////////////////////////////////////////////////////////////
+template <typename V, typename Table = esr::Hashtable<std::string, V>>
+class KeyViewTest : public InsertionRetrievalTest<std::string, V, Table> {
+ public:
+  explicit KeyViewTest(int intput_size = 1024,
+                       const std::string & description = "",
+                       const std::string & name = "KeyViewTest") :
+      InsertionRetrievalTest<std::string, V, Table>(intput_size,
+                                                    description, name) {}
+  virtual bool run() {
+    if (this->m_positive_table.empty()) {
+      std::cout << "expected hashtable empty in "
+                << __ESR_PRETTY_FUNCTION__ << '\n'
+                << std::flush;
+      return false;
+    }
+    if (!this->add_positive() || !lookup() || !remove()) {
+      std::cout << "Unexpected lookup by view. " << std::flush;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  bool lookup();
+  bool remove();
+};
+
+template <typename V, typename Table>
+bool KeyViewTest<V, Table>::lookup() {
+  esr::hash_function<std::string> hash;
+  for (auto& expect : this->m_positive_table) {
+    std::string_view view(expect.first);
+    const char* chars = expect.first.c_str();
+    const V* value = this->m_test_table.get(view);
+    auto found = this->m_test_table.find(chars);
+    if (hash(view) != hash(expect.first) ||
+        value == nullptr || *value != expect.second ||
+        found == this->m_test_table.end() || found->key() != expect.first ||
+        !this->m_test_table.contains(view) ||
+        !this->m_test_table.contains(chars)) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << expect.first << " not found by view. "
+                << std::flush;
+      return false;
+    }
+  }
+  for (auto& expect : this->m_negative_table) {
+    std::string_view view(expect.first);
+    if (this->m_test_table.get(view) != nullptr ||
+        this->m_test_table.find(view) != this->m_test_table.end() ||
+        this->m_test_table.contains(expect.first.c_str())) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "absent key = " << expect.first << " found by view. "
+                << std::flush;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename V, typename Table>
+bool KeyViewTest<V, Table>::remove() {
+  bool odd = false;
+  for (auto& expect : this->m_positive_table) {
+    if ((odd = !odd))
+      this->m_test_table.remove(std::string_view(expect.first));
+    else
+      this->m_test_table.remove(expect.first.c_str());
+    if (this->m_test_table.contains(expect.first)) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << expect.first << " not removed by view. "
+                << std::flush;
+      return false;
+    }
+  }
+  return this->m_test_table.size() == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class SnapshotTest.
+///
+/// @brief Test for binary snapshot of Hashtable.
+/// Tests that esr::Hashtable::load() of esr::Hashtable::save() output
+/// replaces content by every saved element, and that truncated or
+/// foreign snapshot is refused and leaves content as is.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V, typename Table = esr::Hashtable<K, V>>
+class SnapshotTest : public InsertionRetrievalTest<K, V, Table> {
+ public:
+  explicit SnapshotTest(int intput_size = 1024,
+                        const std::string & description = "",
+                        const std::string & name = "SnapshotTest") :
+      InsertionRetrievalTest<K, V, Table>(intput_size, description, name) {}
+  virtual bool run() {
+    if (this->m_positive_table.empty()) {
+      std::cout << "expected hashtable empty in "
+                << __ESR_PRETTY_FUNCTION__ << '\n'
+                << std::flush;
+      return false;
+    }
+    if (!this->add_positive() || !loaded() || !refused()) {
+      std::cout << "Unexpected snapshot. " << std::flush;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  bool loaded();
+  bool refused();
+};
+
+template <typename K, typename V, typename Table>
+bool SnapshotTest<K, V, Table>::loaded() {
+  std::ostringstream os;
+  this->m_test_table.save(os);
+  Table table;
+  for (auto& expect : this->m_negative_table)
+    table.add(expect.first, expect.second);
+  std::istringstream is(os.str());
+  table.load(is);
+  if (table.size() != this->m_positive_table.size()) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "loaded " << table.size() << " elements of "
+              << this->m_positive_table.size() << ". " << std::flush;
+    return false;
+  }
+  for (auto& expect : this->m_positive_table) {
+    const V* value = table.get(expect.first);
+    if (value == nullptr || *value != expect.second) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << expect.first << " not loaded. " << std::flush;
+      return false;
+    }
+  }
+  for (auto& expect : this->m_negative_table) {
+    if (table.get(expect.first) != nullptr) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << expect.first << " not replaced. "
+                << std::flush;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename K, typename V, typename Table>
+bool SnapshotTest<K, V, Table>::refused() {
+  std::ostringstream os;
+  this->m_test_table.save(os);
+  std::string snapshot = os.str();
+  std::string foreign = snapshot;
+  foreign[0] = ~foreign[0];
+  for (const std::string& bytes :
+           {snapshot.substr(0, snapshot.size() - 1), foreign}) {
+    std::istringstream is(bytes);
+    try {
+      this->m_test_table.load(is);
+      return false;
+    } catch (const esr::exception::table_file&) {}
+    if (this->m_test_table.size() != this->m_positive_table.size())
+      return false;
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class MappedTableTest.
+///
+/// @brief Test for table file of Hashtable mapped to memory.
+/// Tests that esr::MappedHashtable serves every element written by
+/// esr::MappedHashtable::write(), no other key, that the mapped
+/// file stays readable when it's rewritten, and that a file of
+/// other value type or of no table is refused.
+////////////////////////////////////////////////////////////////////////////////
+template <typename V, typename Table = esr::Hashtable<std::string, V>>
+class MappedTableTest : public InsertionRetrievalTest<std::string, V, Table> {
+ public:
+  explicit MappedTableTest(int intput_size = 1024,
+                           const std::string & description = "",
+                           const std::string & name = "MappedTableTest") :
+      InsertionRetrievalTest<std::string, V, Table>(intput_size,
+                                                    description, name) {}
+  virtual bool run() {
+    if (this->m_positive_table.empty()) {
+      std::cout << "expected hashtable empty in "
+                << __ESR_PRETTY_FUNCTION__ << '\n'
+                << std::flush;
+      return false;
+    }
+    bool success = false;
+    try {
+      success = this->add_positive() && mapped() && refused();
+    } catch (const esr::exception::table_file& e) {
+      std::cout << e.who() << ' ' << e.what() << ' ' << e.path() << ". "
+                << std::flush;
+    }
+    std::remove(m_Path);
+    if (!success) {
+      std::cout << "Unexpected mapped table. " << std::flush;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  bool mapped();
+  bool refused();
+
+  /// Path of table file, removed by the test.
+  static constexpr const char* m_Path = "mapped_test.table";
+};
+
+template <typename V, typename Table>
+bool MappedTableTest<V, Table>::mapped() {
+  esr::MappedHashtable<V>::write(this->m_test_table, m_Path);
+  esr::MappedHashtable<V> mapped(m_Path);
+  for (auto& expect : this->m_positive_table) {
+    const V* value = mapped.get(expect.first);
+    auto found = mapped.find(expect.first);
+    if (value == nullptr || *value != expect.second ||
+        found == mapped.end() || found->key() != expect.first) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << expect.first << " not mapped. " << std::flush;
+      return false;
+    }
+  }
+  for (auto& expect : this->m_negative_table) {
+    if (mapped.contains(expect.first)) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "absent key = " << expect.first << " mapped. "
+                << std::flush;
+      return false;
+    }
+  }
+  size_t visited = 0;
+  for (auto& element : mapped) {
+    auto expect = this->m_positive_table.find(std::string(element.key()));
+    if (expect == this->m_positive_table.end() ||
+        expect->second != element.value())
+      return false;
+    ++visited;
+  }
+  if (visited != this->m_positive_table.size() || mapped.size() != visited)
+    return false;
+
+  // Rewritten file replaces the mapped one, which stays readable
+  Table empty;
+  esr::MappedHashtable<V>::write(empty, m_Path);
+  if (esr::MappedHashtable<V>(m_Path).size() != 0 ||
+      std::ifstream(std::string(m_Path) + ".tmp").is_open())
+    return false;
+  for (auto& expect : this->m_positive_table) {
+    const V* value = mapped.get(expect.first);
+    if (value == nullptr || *value != expect.second) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << expect.first << " lost by rewrite. "
+                << std::flush;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename V, typename Table>
+bool MappedTableTest<V, Table>::refused() {
+  struct other { V value; char tail; };
+  try {
+    esr::MappedHashtable<other> mapped(m_Path);
+    return false;
+  } catch (const esr::exception::table_file&) {}
+  {
+    std::ofstream file(m_Path, std::ios::binary | std::ios::trunc);
+    file << std::string(1024, 'x');
+  }
+  try {
+    esr::MappedHashtable<V> mapped(m_Path);
+    return false;
+  } catch (const esr::exception::table_file&) {}
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class coarse_hash.
+///
+/// @brief Hash function of a few distinct codes.
+/// Keeps 2 low bits of hash code: most of keys share codes, so no
+/// level of perfect hash function places them.
+/// @tparam K type of hash key.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K>
+class coarse_hash : public esr::hasher<K, coarse_hash<K>> {
+ public:
+  uint64_t code(const K& key) const { return m_hash(key) & 3; }
+
+ private:
+  esr::hash_function<K> m_hash;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class StaticTableTest.
+///
+/// @brief Test for StaticHashtable.
+/// Tests correctness of esr::StaticHashtable built of a range with
+/// and without duplicate keys, it's lookups, iteration, set(), copy
+/// constructor and assignment.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V, typename H = esr::hash_function<K>>
+class StaticTableTest : public InsertionRetrievalTest<K, V> {
+ public:
+  typedef esr::StaticHashtable<K, V, H> Table;
+  explicit StaticTableTest(int intput_size = 1024,
+                           const std::string & description = "",
+                           const std::string & name = "StaticTableTest") :
+      InsertionRetrievalTest<K, V>(intput_size, description, name) {}
+  virtual bool run() {
+    if (this->m_positive_table.empty()) {
+      std::cout << "expected hashtable empty in "
+                << __ESR_PRETTY_FUNCTION__ << '\n'
+                << std::flush;
+      return false;
+    }
+
+    // Unique keys
+    Table empty;
+    Table table(this->m_positive_table.begin(), this->m_positive_table.end());
+    if (!match(table) || empty.begin() != empty.end() ||
+        empty.contains(this->m_positive_table.begin()->first)) {
+      std::cout << "Unexpected construction behavour. " << std::flush;
+      return false;
+    }
+
+    // Every key twice, the first value is kept
+    std::vector<std::pair<K, V>> range(this->m_positive_table.begin(),
+                                       this->m_positive_table.end());
+    range.insert(range.end(), range.begin(), range.end());
+    for (size_t i = range.size()/2; i < range.size(); ++i)
+      range[i].second = V();
+    Table twice(range.begin(), range.end());
+    if (!match(twice)) {
+      std::cout << "Unexpected duplicate keys behavour. " << std::flush;
+      return false;
+    }
+
+    // Copies, then values set by key
+    Table copy(table);
+    twice = copy;
+    for (auto& expect : this->m_positive_table) {
+      if (!twice.set(expect.first, V()) ||
+          *copy.get(expect.first) != expect.second) {
+        std::cout << "Unexpected copy behavour. " << std::flush;
+        return false;
+      }
+    }
+    for (auto& expect : this->m_negative_table) {
+      if (twice.set(expect.first, V())) {
+        std::cout << "Unexpected set behavour. " << std::flush;
+        return false;
+      }
+    }
+    for (auto& element : twice) {
+      if (element.value() != V()) {
+        std::cout << "Unexpected set behavour. " << std::flush;
+        return false;
+      }
+    }
+    return match(copy);
+  }
+
+ private:
+  bool match(Table& table);
+};
+
+template <typename K, typename V, typename H>
+bool StaticTableTest<K, V, H>::match(Table& table) {
+  if (table.size() != this->m_positive_table.size()) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "size " << table.size() << " doesn't match expected "
+              << this->m_positive_table.size() << ". " << std::flush;
+    return false;
+  }
+  for (auto& expect : this->m_positive_table) {
+    const V* value = table.get(expect.first);
+    if (value == nullptr || *value != expect.second ||
+        table.find(expect.first)->key() != expect.first) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << expect.first << " not found. "
+                << std::flush;
+      return false;
+    }
+  }
+  for (auto& expect : this->m_negative_table) {
+    if (table.contains(expect.first) ||
+        table.find(expect.first) != table.end()) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << expect.first << " found. "
+                << std::flush;
+      return false;
+    }
+  }
+  size_t visited = 0;
+  for (auto& element : table) {
+    auto expect = this->m_positive_table.find(element.key());
+    if (expect == this->m_positive_table.end() ||
+        expect->second != element.value()) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << element.key() << " unexpected. "
+                << std::flush;
+      return false;
+    }
+    ++visited;
+  }
+  return visited == table.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class LiteralTableTest.
+///
+/// @brief Test for LiteralHashtable.
+/// Tests esr::LiteralHashtable built at compile time, checked by
+/// static assertions, and built at run time of the first m_Elements
+/// expected elements, with duplicate key refused.
+////////////////////////////////////////////////////////////////////////////////
+template <typename V>
+class LiteralTableTest : public InsertionRetrievalTest<std::string, V> {
+ public:
+  explicit LiteralTableTest(int intput_size = 1024,
+                            const std::string & description = "",
+                            const std::string & name = "LiteralTableTest") :
+      InsertionRetrievalTest<std::string, V>(intput_size, description,
+                                             name) {}
+  virtual bool run() {
+    if (this->m_positive_table.size() < m_Elements) {
+      std::cout << "expected hashtable too small in "
+                << __ESR_PRETTY_FUNCTION__ << '\n'
+                << std::flush;
+      return false;
+    }
+
+    // Compile time
+    static constexpr auto methods = esr::make_literal_table<int>(
+        {{"GET", 1}, {"HEAD", 2}, {"POST", 3}, {"PUT", 4}, {"DELETE", 5}});
+    static_assert(methods.size() == 5 && methods.capacity() == 16,
+                  "unexpected literal table size");
+    static_assert(*methods.get("GET") == 1 && *methods.get("DELETE") == 5,
+                  "literal key not found");
+    static_assert(!methods.contains("PATCH") && !methods.contains(""),
+                  "literal key found");
+
+    // Run time
+    typename esr::LiteralHashtable<V, m_Elements>::value_type
+        elements[m_Elements];
+    auto expect = this->m_positive_table.begin();
+    for (size_t i = 0; i < m_Elements; ++i, ++expect)
+      elements[i] = std::make_pair(std::string_view(expect->first),
+                                   expect->second);
+    esr::LiteralHashtable<V, m_Elements> table(elements);
+    for (size_t i = 0; i < m_Elements; ++i) {
+      const V* value = table.get(elements[i].first);
+      if (value == nullptr || *value != elements[i].second ||
+          table.key(i) != elements[i].first) {
+        std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                  << "key = " << elements[i].first << " not found. "
+                  << std::flush;
+        return false;
+      }
+    }
+    for (auto& absent : this->m_negative_table) {
+      if (table.contains(absent.first)) {
+        std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                  << "key = " << absent.first << " found. " << std::flush;
+        return false;
+      }
+    }
+
+    // Duplicate key
+    elements[m_Elements - 1].first = elements[0].first;
+    try {
+      esr::LiteralHashtable<V, m_Elements> duplicate(elements);
+      std::cout << "Unexpected duplicate key behavour. " << std::flush;
+      return false;
+    } catch (const esr::exception::hashtable&) {}
+    return true;
+  }
+
+ private:
+  /// Number of elements of table built at run time.
+  static const size_t m_Elements = 64;
+};
+
+template <typename V>
+const size_t LiteralTableTest<V>::m_Elements;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class UpsertTest.
+///
+/// @brief Test for single lookup insertions of Hashtable.
+/// Tests correctness of esr::Hashtable::find_or_insert() and
+/// esr::Hashtable::upsert().
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V, typename Table = esr::Hashtable<K, V>>
+class UpsertTest : public InsertionRetrievalTest<K, V, Table> {
+ public:
+  explicit UpsertTest(int intput_size = 1024,
+                      const std::string & description = "",
+                      const std::string & name = "UpsertTest") :
+      InsertionRetrievalTest<K, V, Table>(intput_size, description, name) {}
+  virtual bool run() {
+    if (this->m_positive_table.empty()) {
+      std::cout << "expected hashtable empty in "
+                << __ESR_PRETTY_FUNCTION__ << '\n'
+                << std::flush;
+      return false;
+    }
+    if (!find_or_insert() || !upsert()) {
+      std::cout << "Unexpected single lookup insertion. " << std::flush;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  bool find_or_insert();
+  bool upsert();
+};
+
+template <typename K, typename V, typename Table>
+bool UpsertTest<K, V, Table>::find_or_insert() {
+  for (int pass = 0; pass < 2; ++pass) {
+    for (auto& expect : this->m_positive_table) {
+      // the second pass finds keys, values are kept
+      auto found = this->m_test_table.find_or_insert(
+          expect.first, pass == 0 ? expect.second : V());
+      if (found.second != (pass == 0) ||
+          found.first == this->m_test_table.end() ||
+          found.first->key() != expect.first ||
+          found.first->value() != expect.second) {
+        std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                  << "pass " << pass << " key = " << expect.first
+                  << " is not found or inserted. " << std::flush;
+        return false;
+      }
+    }
+  }
+  return this->m_test_table.size() == this->m_positive_table.size();
+}
+
+template <typename K, typename V, typename Table>
+bool UpsertTest<K, V, Table>::upsert() {
+  auto sum = [](const V& total, const V& value) { return total + value; };
+  for (auto& expect : this->m_positive_table) {
+    if (this->m_test_table.upsert(expect.first, expect.second, sum) ||
+        *this->m_test_table.get(expect.first) !=
+        expect.second + expect.second) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << expect.first << " is not combined. "
+                << std::flush;
+      return false;
+    }
+  }
+  for (auto& expect : this->m_negative_table) {
+    if (!this->m_test_table.upsert(expect.first, expect.second, sum) ||
+        *this->m_test_table.get(expect.first) != expect.second) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << expect.first << " is not added. "
+                << std::flush;
+      return false;
+    }
+  }
+  return this->m_test_table.size() ==
+      this->m_positive_table.size() + this->m_negative_table.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class BatchLookupTest.
+///
+/// @brief Test for batch lookups of Hashtable.
+/// Tests correctness of esr::Hashtable::find_batch() and
+/// esr::Hashtable::get_batch() of present and absent keys mixed,
+/// batches of any size.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V, typename Table = esr::Hashtable<K, V>>
+class BatchLookupTest : public InsertionRetrievalTest<K, V, Table> {
+ public:
+  explicit BatchLookupTest(int intput_size = 1024,
+                           const std::string & description = "",
+                           const std::string & name = "BatchLookupTest") :
+      InsertionRetrievalTest<K, V, Table>(intput_size, description, name) {}
+  virtual bool run() {
+    if (this->m_positive_table.empty()) {
+      std::cout << "expected hashtable empty in "
+                << __ESR_PRETTY_FUNCTION__ << '\n'
+                << std::flush;
+      return false;
+    }
+    make_keys();
+    if (!lookup(m_Batch) || !this->add_positive() ||
+        !lookup(1) || !lookup(m_Batch)) {
+      std::cout << "Unexpected batch lookup. " << std::flush;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  /// Number of keys of a batch, not multiple of group size.
+  static const size_t m_Batch = 77;
+
+  std::vector<K> m_keys;  ///< Present and absent keys, interleaved.
+
+  void make_keys();
+  bool lookup(size_t batch);
+};
+
+template <typename K, typename V, typename Table>
+void BatchLookupTest<K, V, Table>::make_keys() {
+  auto negative = this->m_negative_table.begin();
+  for (auto& expect : this->m_positive_table) {
+    m_keys.push_back(expect.first);
+    if (negative != this->m_negative_table.end())
+      m_keys.push_back((negative++)->first);
+  }
+}
+
+template <typename K, typename V, typename Table>
+bool BatchLookupTest<K, V, Table>::lookup(size_t batch) {
+  const Table& constant = this->m_test_table;
+  std::vector<typename Table::iterator> found(batch, this->m_test_table.end());
+  std::vector<const V*> values(batch);
+  for (size_t first = 0; first < m_keys.size(); first += batch) {
+    size_t count = std::min(batch, m_keys.size() - first);
+    this->m_test_table.find_batch(&m_keys[first], count, found.data());
+    constant.get_batch(&m_keys[first], count, values.data());
+    for (size_t i = 0; i < count; ++i) {
+      const K& key = m_keys[first + i];
+      auto expect = this->m_test_table.find(key);
+      if (found[i] != expect || values[i] != this->m_test_table.get(key)) {
+        std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                  << "key = " << key << " differs from find(). "
+                  << std::flush;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class ParallelScanTest.
+///
+/// @brief Test for parallel scans of Hashtable.
+/// Tests correctness of esr::Hashtable::parallel_for_each() and
+/// esr::Hashtable::parallel_reduce(): every element is met once by
+/// a few threads.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V, typename Table = esr::Hashtable<K, V>>
+class ParallelScanTest : public InsertionRetrievalTest<K, V, Table> {
+ public:
+  explicit ParallelScanTest(int intput_size = 1024,
+                            const std::string & description = "",
+                            const std::string & name = "ParallelScanTest") :
+      InsertionRetrievalTest<K, V, Table>(intput_size, description, name) {}
+  virtual bool run() {
+    if (this->m_positive_table.empty()) {
+      std::cout << "expected hashtable empty in "
+                << __ESR_PRETTY_FUNCTION__ << '\n'
+                << std::flush;
+      return false;
+    }
+    if (!this->add_positive() || !visit_all() || !reduce_all()) {
+      std::cout << "Unexpected parallel scan. " << std::flush;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  typedef std::unordered_map<K, V> elements_t;
+
+  /// Number of threads.
+  static const size_t m_Workers = 4;
+
+  /// Adds an element or elements of another partial result.
+  struct collect {
+    elements_t operator()(elements_t all, std::pair<K, V> element) const {
+      all.insert(std::move(element));
+      return all;
+    }
+    elements_t operator()(elements_t all, elements_t partial) const {
+      all.insert(partial.begin(), partial.end());
+      return all;
+    }
+  };
+
+  bool visit_all();
+  bool reduce_all() const;
+};
+
+/// Every element is visited with it's value, as many as there are.
+template <typename K, typename V, typename Table>
+bool ParallelScanTest<K, V, Table>::visit_all() {
+  std::atomic<size_t> visited(0);
+  std::atomic<size_t> mismatched(0);
+  this->m_test_table.parallel_for_each(
+      [this, &visited, &mismatched](const K& key, V& value) {
+        auto expect = this->m_positive_table.find(key);
+        if (expect == this->m_positive_table.end() || expect->second != value)
+          ++mismatched;
+        ++visited;
+      }, m_Workers);
+  if (mismatched != 0 || visited != this->m_positive_table.size()) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "visited " << visited << " elements of "
+              << this->m_positive_table.size() << ", "
+              << mismatched << " mismatched. " << std::flush;
+    return false;
+  }
+  return true;
+}
+
+/// Count of elements is size, collected elements are the expected ones.
+template <typename K, typename V, typename Table>
+bool ParallelScanTest<K, V, Table>::reduce_all() const {
+  const Table& table = this->m_test_table;
+  size_t count = table.parallel_reduce(
+      size_t(0),
+      [](const K&, const V&) { return size_t(1); },
+      [](size_t sum, size_t x) { return sum + x; },
+      m_Workers);
+  elements_t all = table.parallel_reduce(
+      elements_t(),
+      [](const K& key, const V& value) { return std::make_pair(key, value); },
+      collect(),
+      m_Workers);
+  if (count != table.size() || all != this->m_positive_table) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "counted " << count << ", collected " << all.size()
+              << " elements of " << this->m_positive_table.size() << ". "
+              << std::flush;
+    return false;
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class failing_hash.
+///
+/// @brief Hash function which throws once, on a call of choice.
+/// @tparam K type of hash key.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K>
+class failing_hash : public esr::hasher<K, failing_hash<K>> {
+ public:
+  uint64_t code(const K& key) const {
+    if (m_countdown.fetch_sub(1) == 1)
+      throw esr::exception::hashtable(__ESR_PRETTY_FUNCTION__,
+                                      "hash failure");
+    return m_hash(key);
+  }
+
+  /// Makes the call of a number from now throw.
+  static void fail_at(int64_t call) { m_countdown = call; }
+
+ private:
+  esr::hash_function<K> m_hash;
+
+  /// Number of calls left to the failing one, not positive for none.
+  static std::atomic<int64_t> m_countdown;
+};
+
+template <typename K>
+std::atomic<int64_t> failing_hash<K>::m_countdown(0);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class ParallelResizeFailureTest.
+///
+/// @brief Test for failure of parallel resize of Hashtable.
+/// Tests that a hash function throwing while threads unlink nodes
+/// into outboxes or link them into new buckets leaves every element
+/// in place, then that resize succeeds. Keys must not cache hash
+/// codes, so that resize hashes them.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V>
+class ParallelResizeFailureTest :
+      public InsertionRetrievalTest<K, V,
+                                    esr::Hashtable<K, V, failing_hash<K>>> {
+ public:
+  typedef esr::Hashtable<K, V, failing_hash<K>> table_t;
+
+  explicit ParallelResizeFailureTest(
+      int intput_size = 1024, const std::string & description = "",
+      const std::string & name = "ParallelResizeFailureTest") :
+      InsertionRetrievalTest<K, V, table_t>(intput_size, description, name) {}
+  virtual bool run() {
+    if (this->m_positive_table.empty()) {
+      std::cout << "expected hashtable empty in "
+                << __ESR_PRETTY_FUNCTION__ << '\n'
+                << std::flush;
+      return false;
+    }
+    this->m_test_table.set_parallel_resize(0, m_Workers);
+    size_t size = this->m_positive_table.size();
+    if (!this->add_positive() || !fail_resize(size/2) ||
+        !fail_resize(size + size/2)) {
+      std::cout << "Unexpected failure of parallel resize. " << std::flush;
+      return false;
+    }
+    size_t bucket_count = this->m_test_table.bucket_count();
+    this->m_test_table.reserve(m_Growth*size);
+    if (this->m_test_table.bucket_count() <= bucket_count || !kept()) {
+      std::cout << "Unexpected parallel resize. " << std::flush;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  /// Number of threads.
+  static const size_t m_Workers = 4;
+
+  /// Reserved number of elements per element of the table.
+  static const size_t m_Growth = 4;
+
+  bool fail_resize(int64_t call);
+  bool kept();
+};
+
+/// Resize throws on a call of hash function, elements are left as is.
+template <typename K, typename V>
+bool ParallelResizeFailureTest<K, V>::fail_resize(int64_t call) {
+  size_t bucket_count = this->m_test_table.bucket_count();
+  failing_hash<K>::fail_at(call);
+  try {
+    this->m_test_table.reserve(m_Growth*this->m_positive_table.size());
+    failing_hash<K>::fail_at(0);
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "resize hasn't failed at call " << call << ". "
+              << std::flush;
+    return false;
+  } catch (const esr::exception::hashtable&) {}
+  failing_hash<K>::fail_at(0);
+  if (this->m_test_table.bucket_count() != bucket_count) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "failed resize changed bucket count. " << std::flush;
+    return false;
+  }
+  return kept();
+}
+
+/// Every element is found and iterated.
+template <typename K, typename V>
+bool ParallelResizeFailureTest<K, V>::kept() {
+  for (auto& expect : this->m_positive_table) {
+    const V* value = this->m_test_table.get(expect.first);
+    if (value == nullptr || *value != expect.second) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << expect.first << " lost. " << std::flush;
+      return false;
+    }
+  }
+  size_t visited = 0;
+  for (auto it = this->m_test_table.begin(); it != this->m_test_table.end();
+       ++it)
+    ++visited;
+  if (visited != this->m_positive_table.size() ||
+      visited != this->m_test_table.size()) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "visited " << visited << " elements of "
+              << this->m_positive_table.size() << ". " << std::flush;
+    return false;
+  }
+  return true;
+}
+
+/// @brief Gets type of thread safe table of other value type.
+/// @tparam Table is a table type of K, V, H.
+/// @tparam W is a value type of the other table.
+template <typename Table, typename W>
+struct rebind_value;
+
+template <template <typename, typename, typename> class T,
+          typename K, typename V, typename H, typename W>
+struct rebind_value<T<K, V, H>, W> {
+  typedef T<K, W, H> type;
+};
+
+template <template <typename, typename, typename, typename> class T,
+          typename K, typename V, typename H, typename M, typename W>
+struct rebind_value<T<K, V, H, M>, W> {
+  typedef T<K, W, H, M> type;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class ConcurrentTest.
+///
+/// @brief Test for thread safe tables shared by threads.
+/// Tests correctness of esr::ConcurrentHashtable::add, get, remove,
+/// find_or_insert and upsert called by several threads at once,
+/// while bucket array grows from a few buckets. The same for
+/// esr::EpochHashtable and esr::ShardedHashtable.
+/// @tparam Table is a thread safe hashtable engine under test,
+/// constructed from a number of stripes or reader slots.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V,
+          typename Table = esr::ConcurrentHashtable<K, V>>
+class ConcurrentTest : public InsertionRetrievalTest<K, V> {
+ public:
+  explicit ConcurrentTest(int intput_size = 1024,
+                          const std::string & description = "",
+                          const std::string & name = "ConcurrentTest") :
+      InsertionRetrievalTest<K, V>(intput_size, description, name),
+      m_table(m_Stripes) {}
+  virtual bool run() {
+    if (this->m_positive_table.empty()) {
+      std::cout << "expected hashtable empty in "
+                << __ESR_PRETTY_FUNCTION__ << '\n'
+                << std::flush;
+      return false;
+    }
+    m_positive.assign(this->m_positive_table.begin(),
+                      this->m_positive_table.end());
+    m_negative.assign(this->m_negative_table.begin(),
+                      this->m_negative_table.end());
+    if (!add_get() || !remove_find_or_insert() || !upsert()) {
+      std::cout << "Unexpected concurrent behavour. " << std::flush;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  /// Number of threads.
+  static const size_t m_Threads = 4;
+
+  /// Number of stripes or reader slots, stripes are less than
+  /// buckets after resizes.
+  static const size_t m_Stripes = 8;
+
+  Table m_table;
+  std::vector<std::pair<K, V>> m_positive;
+  std::vector<std::pair<K, V>> m_negative;
+
+  /// Runs work(thread number) in m_Threads threads, counts failures.
+  template <typename F>
+  static size_t parallel(F work);
+
+  /// Checks value of every element, size of table.
+  bool match(const std::vector<std::pair<K, V>>& present,
+             const std::vector<std::pair<K, V>>& absent) const;
+
+  bool add_get();
+  bool remove_find_or_insert();
+  bool upsert();
+};
+
+template <typename K, typename V, typename Table>
+template <typename F>
+size_t ConcurrentTest<K, V, Table>::parallel(F work) {
+  std::atomic<size_t> failures(0);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < m_Threads; ++t)
+    threads.emplace_back([&work, &failures, t]() {
+        failures += work(t);
+      });
+  for (auto& thread : threads)
+    thread.join();
+  return failures;
+}
+
+template <typename K, typename V, typename Table>
+bool ConcurrentTest<K, V, Table>::match(
+    const std::vector<std::pair<K, V>>& present,
+    const std::vector<std::pair<K, V>>& absent) const {
+  if (m_table.size() != present.size()) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "size = " << m_table.size() << ", expected "
+              << present.size() << ". " << std::flush;
+    return false;
+  }
+  V value;
+  for (auto& expect : present) {
+    if (!m_table.get(expect.first, &value) || value != expect.second) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << expect.first << " is not found. "
+                << std::flush;
+      return false;
+    }
+  }
+  for (auto& expect : absent) {
+    if (m_table.contains(expect.first)) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << expect.first << " is found. "
+                << std::flush;
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Every thread adds it's share of keys and reads keys of others.
+template <typename K, typename V, typename Table>
+bool ConcurrentTest<K, V, Table>::add_get() {
+  size_t failures = parallel([this](size_t t) {
+      size_t failures = 0;
+      V value;
+      for (size_t i = t; i < m_positive.size(); i += m_Threads) {
+        if (!m_table.add(m_positive[i].first, m_positive[i].second))
+          ++failures;
+        if (!m_table.get(m_positive[i].first, &value) ||
+            value != m_positive[i].second)
+          ++failures;
+        // a key of other thread is either absent or complete
+        const std::pair<K, V>& other = m_positive[m_positive.size() - 1 - i];
+        if (m_table.get(other.first, &value) && value != other.second)
+          ++failures;
+      }
+      return failures;
+    });
+  return failures == 0 && match(m_positive, m_negative);
+}
+
+/// Threads remove even keys, find odd keys and add absent keys.
+template <typename K, typename V, typename Table>
+bool ConcurrentTest<K, V, Table>::remove_find_or_insert() {
+  size_t failures = parallel([this](size_t t) {
+      size_t failures = 0;
+      for (size_t i = t; i < m_positive.size(); i += m_Threads) {
+        if (i % 2 == 0) {
+          m_table.remove(m_positive[i].first);
+          continue;
+        }
+        auto found = m_table.find_or_insert(m_positive[i].first, V());
+        if (found.second || found.first != m_positive[i].second)
+          ++failures;
+      }
+      for (size_t i = t; i < m_negative.size(); i += m_Threads) {
+        auto found = m_table.find_or_insert(m_negative[i].first,
+                                            m_negative[i].second);
+        if (!found.second || found.first != m_negative[i].second)
+          ++failures;
+      }
+      return failures;
+    });
+  std::vector<std::pair<K, V>> present(m_negative);
+  std::vector<std::pair<K, V>> absent;
+  for (size_t i = 0; i < m_positive.size(); ++i)
+    (i % 2 == 0 ? absent : present).push_back(m_positive[i]);
+  return failures == 0 && match(present, absent);
+}
+
+/// All threads count every key, each thread tries to add every key.
+template <typename K, typename V, typename Table>
+bool ConcurrentTest<K, V, Table>::upsert() {
+  typename rebind_value<Table, int>::type counts(m_Stripes);
+  std::atomic<size_t> added(0);
+  parallel([this, &counts, &added](size_t) {
+      auto sum = [](int total, int value) { return total + value; };
+      for (auto& element : m_positive)
+        counts.upsert(element.first, 1, sum);
+      for (auto& element : m_negative)
+        added += counts.add(element.first, 0);
+      return size_t(0);
+    });
+  if (added != m_negative.size() ||
+      counts.size() != m_positive.size() + m_negative.size())
+    return false;
+
+  int count = 0;
+  for (auto& expect : m_positive) {
+    if (!counts.get(expect.first, &count) || count != int(m_Threads)) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "key = " << expect.first << " is counted " << count
+                << " times. " << std::flush;
+      return false;
+    }
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class ShardedTest.
+///
+/// @brief Test for whole table operations of ShardedHashtable.
+/// Tests correctness of esr::ShardedHashtable::for_each, size,
+/// stats and dump_stats.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V>
+class ShardedTest : public InsertionRetrievalTest<K, V> {
+ public:
+  explicit ShardedTest(int intput_size = 1024,
+                       const std::string & description = "",
+                       const std::string & name = "ShardedTest") :
+      InsertionRetrievalTest<K, V>(intput_size, description, name),
+      m_table(m_Shards) {}
+  virtual bool run() {
+    if (this->m_positive_table.empty()) {
+      std::cout << "expected hashtable empty in "
+                << __ESR_PRETTY_FUNCTION__ << '\n'
+                << std::flush;
+      return false;
+    }
+    m_table.reserve(this->m_positive_table.size());
+    for (auto& expect : this->m_positive_table)
+      m_table.add(expect.first, expect.second);
+    if (!visit_all() || !count_all()) {
+      std::cout << "Unexpected sharded behavour. " << std::flush;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  /// Number of shards.
+  static const size_t m_Shards = 16;
+
+  esr::ShardedHashtable<K, V> m_table;
+
+  bool visit_all();
+  bool count_all() const;
+};
+
+/// Every element is visited once with it's value.
+template <typename K, typename V>
+bool ShardedTest<K, V>::visit_all() {
+  size_t visited = 0;
+  bool matched = true;
+  m_table.for_each([this, &visited, &matched](const K& key, V& value) {
+      auto expect = this->m_positive_table.find(key);
+      matched &= expect != this->m_positive_table.end() &&
+          expect->second == value;
+      ++visited;
+    });
+  if (!matched || visited != this->m_positive_table.size()) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "visited " << visited << " elements of "
+              << this->m_positive_table.size() << ". " << std::flush;
+    return false;
+  }
+  return true;
+}
+
+/// Shard sizes add up to size, every add() and visit is counted.
+template <typename K, typename V>
+bool ShardedTest<K, V>::count_all() const {
+  size_t size = 0;
+  size_t operations = 0;
+  for (size_t i = 0; i < m_table.shard_count(); ++i) {
+    auto counters = m_table.stats(i);
+    if (counters.size == 0 || counters.bucket_count == 0) {
+      std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+                << "shard " << i << " is empty. " << std::flush;
+      return false;
+    }
+    size += counters.size;
+    operations += counters.operations;
+  }
+  // reserve() and for_each() count once per shard
+  size_t expected = this->m_positive_table.size() + 2*m_table.shard_count();
+  std::ostringstream dump;
+  m_table.dump_stats(dump);
+  std::string text = dump.str();
+  size_t lines = std::count(text.begin(), text.end(), '\n');
+  if (size != m_table.size() || size != this->m_positive_table.size() ||
+      operations != expected || lines != m_table.shard_count() + 1) {
+    std::cout << __ESR_PRETTY_FUNCTION__ << ' '
+              << "size " << size << ", operations " << operations
+              << ", lines " << lines << ". " << std::flush;
+    return false;
+  }
+  return true;
+}
+
 }  // namespace esr_test
 
 #endif  // ESR_HASHTEST_FLYMAKE_HPP_
@@ -5,36 +5,103 @@
 // Linked List <K, V>.
 ////////////////////////////////////////////////////////////////////////////////
 #include <algorithm>  // std::swap()
+#include <cassert>    // assert()
 #include <ostream>    // operator<<()
+#include <utility>    // std::forward(), std::move()
 using std::ostream;
 
+#include <esr/hasher.hpp>    // Hash code caching opt-in.
+#include <esr/nodepool.hpp>  // Storage for nodes.
+
 namespace esr {
 
+////////////////////////////////////////////////////////////////////////////////
+/// @class codecache.
+///
+/// @brief Hash code of node.
+/// Keeps hash code for key types which opt in, see cache_hash_code.
+/// @tparam Cached is true to keep hash code.
+////////////////////////////////////////////////////////////////////////////////
+template <bool Cached>
+class codecache {
+ public:
+  /// Constructor, keeps hash code.
+  explicit codecache(uint64_t code) : m_code(code) {}
+
+  /// Gets hash code.
+  uint64_t code() const { return m_code; }
+
+  /// Node may hold key with such hash code, if codes are equal.
+  bool may_match(uint64_t code) const { return m_code == code; }
+
+ private:
+  uint64_t m_code;  //< Hash code of key.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class codecache.
+///
+/// @brief Hash code of node, not kept.
+/// Takes no space as a base of node.
+////////////////////////////////////////////////////////////////////////////////
+template <>
+class codecache<false> {
+ public:
+  /// Constructor, ignores hash code.
+  explicit codecache(uint64_t) {}
+
+  /// Gets hash code, always 0.
+  uint64_t code() const { return 0; }
+
+  /// Node may hold key with any hash code.
+  bool may_match(uint64_t) const { return true; }
+};
+
+/// @brief Tag of node constructor which builds key and value in place.
+struct emplace_tag {};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @class listnode.
 ///
 /// @brief Node of Linked List.
-/// Node contains key and value.
+/// Node contains key and value, and hash code of key if key type
+/// caches it.
 /// @tparam K type of hash key.
 /// @tparam V type of hash value.
 ////////////////////////////////////////////////////////////////////////////////
 template <typename K, typename V>
-class listnode {
+class listnode : private codecache<cache_hash_code<K>::value> {
   template <typename KK, typename VV>
   friend class linkedlist;
+  typedef codecache<cache_hash_code<K>::value> cache;
  public:
   /// Default constructor, creates empty node without link.
-  listnode() : m_next(nullptr) {}
+  listnode() : cache(0), m_next(nullptr) {}
 
   /// @brief Constructor for node.
   /// Creates node with key, value without link.
   listnode(const K& key, const V& value) :
-      m_key(key), m_value(value), m_next(nullptr) {}
+      cache(0), m_key(key), m_value(value), m_next(nullptr) {}
+
+  /// @brief Constructor for node.
+  /// Creates node with key, value and it's hash code without link.
+  listnode(const K& key, const V& value, uint64_t code) :
+      cache(code), m_key(key), m_value(value), m_next(nullptr) {}
 
   /// @brief Constructor for node.
   /// Creates node with key, value with link to next node.
   listnode(const K& key, const V& value, listnode* next) :
-      m_key(key), m_value(value), m_next(next) {}
+      cache(0), m_key(key), m_value(value), m_next(next) {}
+
+  /// @brief Constructor for node.
+  /// Creates node with key and value constructed in place of
+  /// arguments, and hash code of key, without link.
+  template <typename KK, typename... Args>
+  listnode(emplace_tag, uint64_t code, KK&& key, Args&&... args) :
+      cache(code),
+      m_key(std::forward<KK>(key)),
+      m_value(std::forward<Args>(args)...),
+      m_next(nullptr) {}
 
   // deprecated: K& key() { return m_key; }
 
@@ -42,6 +109,10 @@ class listnode {
   /// Returns reference to key.
   const K& key() const { return m_key; }
 
+  /// @brief Gets cached hash code.
+  /// Returns hash code of key, 0 if key type doesn't cache it.
+  uint64_t hash_code() const { return cache::code(); }
+
   /// @brief Gets mutable value.
   /// Returns reference to value.
   V& value() { return m_value; }
@@ -53,6 +124,9 @@ class listnode {
   /// @brief Sets the value.
   void set(const V& value) { m_value = value; }
 
+  /// @brief Sets the value, moving it.
+  void set(V&& value) { m_value = std::move(value); }
+
   /// @brief Gets next node.
   /// Returns pointer to the next to this node.
   listnode* next() { return m_next; }
@@ -82,9 +156,15 @@ class linkedlist {
   /// Default constructor.
   linkedlist();
 
+  /// Constructor, creates List which takes nodes from pool.
+  explicit linkedlist(nodepool<listnode<K, V>>* pool);
+
   /// Copy constructor.
   linkedlist(const linkedlist& other);
 
+  /// Move constructor.
+  linkedlist(linkedlist&& other);
+
   /// Destructor.
   ~linkedlist();
 
@@ -92,19 +172,34 @@ class linkedlist {
   linkedlist& operator=(linkedlist other);
 
   /// Adds element to List.
-  bool push_back(const K& key, const V& value);
+  bool push_back(const K& key, const V& value, uint64_t code = 0);
+
+  /// Adds element to List, moving key and value.
+  bool push_back(K&& key, V&& value, uint64_t code = 0);
+
+  /// Adds element to List, constructing it's value in place.
+  template <typename KK, typename... Args>
+  listnode<K, V>* emplace_back(uint64_t code, KK&& key, Args&&... args);
+
+  /// Adds element of absent key, constructing it's value in place.
+  template <typename KK, typename... Args>
+  listnode<K, V>* emplace_back_unique(uint64_t code, KK&& key,
+                                      Args&&... args);
 
   /// Gets immutable element from List by it's key.
-  const listnode<K, V>* find(const K& key) const;
+  template <typename Q>
+  const listnode<K, V>* find(const Q& key, uint64_t code = 0) const;
 
   /// Gets mutable element from List by it's key.
-  listnode<K, V>* find(const K& key);
+  template <typename Q>
+  listnode<K, V>* find(const Q& key, uint64_t code = 0);
 
   /// Gets first element of List.
   listnode<K, V>* front();
 
   /// Removes element from List.
-  bool erase(const K& key);
+  template <typename Q>
+  bool erase(const Q& key, uint64_t code = 0);
 
   /// Gets a number of elements in List.
   size_t size() { return m_size; }
@@ -112,6 +207,21 @@ class linkedlist {
   /// Is List empty or not.
   bool empty();
 
+  /// Sets pool to take nodes from.
+  void set_pool(nodepool<listnode<K, V>>* pool);
+
+  /// Forgets all elements without destroying them.
+  void detach();
+
+  /// Unlinks first element without destroying it.
+  listnode<K, V>* unlink_front();
+
+  /// Links element to the front of List, no duplicate check.
+  void link_front(listnode<K, V>* node);
+
+  /// Links element to the back of List, no duplicate check.
+  void link_back(listnode<K, V>* node);
+
   /// Printout List.
   template <typename KK, typename VV>
   friend ostream & operator<<(ostream & os, const linkedlist<KK, VV>& ll);
@@ -120,7 +230,11 @@ class linkedlist {
   size_t m_size;            //< Number of elements of Linked List.
   listnode<K, V> *m_front;  //< First element of Linked List.
   listnode<K, V> *m_back;   //< Last element of Linked List.
+  nodepool<listnode<K, V>> *m_pool;  //< Storage of nodes, nullptr for heap.
   void clear();
+  template <typename... Args>
+  listnode<K, V>* create_node(Args&&... args);
+  void destroy_node(listnode<K, V>* node);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -132,17 +246,41 @@ class linkedlist {
 /// @tparam K type of key.
 /// @tparam V type of value.
 template <typename K, typename V>
-linkedlist<K, V>::linkedlist() : m_size(0), m_front(nullptr), m_back(nullptr) {}
+linkedlist<K, V>::linkedlist() :
+    m_size(0), m_front(nullptr), m_back(nullptr), m_pool(nullptr) {}
+
+/// @brief Constructor.
+/// Creates an empty List which takes nodes from pool.
+/// @tparam K type of key.
+/// @tparam V type of value.
+/// @param pool is a storage of nodes, must outlive List.
+template <typename K, typename V>
+linkedlist<K, V>::linkedlist(nodepool<listnode<K, V>>* pool) :
+    m_size(0), m_front(nullptr), m_back(nullptr), m_pool(pool) {}
 
 /// @brief Copy constructor.
-/// Creates a copy of List instance.
+/// Creates a copy of List instance. Copy takes nodes from heap.
 /// @tparam K type of key.
 /// @tparam V type of value.
 template <typename K, typename V>
 linkedlist<K, V>::linkedlist(const linkedlist& other) :
-    m_size(0), m_front(nullptr), m_back(nullptr) {
+    m_size(0), m_front(nullptr), m_back(nullptr), m_pool(nullptr) {
   for (listnode<K, V>* node = other.m_front; node; node = node->m_next)
-    push_back(node->m_key, node->m_value);
+    push_back(node->m_key, node->m_value, node->code());
+}
+
+/// @brief Move constructor.
+/// Takes elements and pool of other List, other is left empty.
+/// @tparam K type of key.
+/// @tparam V type of value.
+template <typename K, typename V>
+linkedlist<K, V>::linkedlist(linkedlist&& other) :
+    m_size(other.m_size),
+    m_front(other.m_front),
+    m_back(other.m_back),
+    m_pool(other.m_pool) {
+  other.m_size = 0;
+  other.m_back = other.m_front = nullptr;
 }
 
 /// @brief Destructor for List.
@@ -156,7 +294,8 @@ linkedlist<K, V>::~linkedlist() {
 
 /// @brief Assignment operator for List.
 /// Creates copy of existing List instance,
-/// cleaning up left-hand target.
+/// cleaning up left-hand target. Moves rvalue List
+/// without copying, other is move constructed.
 /// @tparam K type of key.
 /// @tparam V type of value.
 template <typename K, typename V>
@@ -164,6 +303,7 @@ linkedlist<K, V>& linkedlist<K, V>::operator=(linkedlist other) {
   std::swap(m_size, other.m_size);
   std::swap(m_front, other.m_front);
   std::swap(m_back, other.m_back);
+  std::swap(m_pool, other.m_pool);
   return *this;
 }
 
@@ -173,29 +313,84 @@ linkedlist<K, V>& linkedlist<K, V>::operator=(linkedlist other) {
 
 /// @brief Adds an element.
 /// Adds an element to List using it's key, value.
-/// Traverses a list comparing keys to find dublicate key.
+/// Traverses a list comparing keys to find dublicate key,
+/// keys are compared only if cached hash codes are equal.
 /// Creates new element with key, value and appends it
 /// to back of List, if no duplicate key found.
 /// @tparam K type of key.
 /// @tparam V type of value.
+/// @param code is a hash code of key, the same for every call
+/// with the same key. Ignored if key type doesn't cache hash codes.
 /// @return result of adding.
 /// @retval true key has been added successfully.
 /// @retval false duplicate key found.
 template <typename K, typename V>
-bool linkedlist<K, V>::push_back(const K& key, const V& value) {
-  if (m_front == nullptr) {
-    m_back = m_front = new listnode<K, V>(key, value);
-  } else {
-    // issue: no need to have a tail because of that.
-    for (listnode<K, V>* node = m_front; node; node = node->m_next)
-      if (node->m_key == key) {
-        return false;  // dublicate keys
-      }
-    m_back->m_next = new listnode<K, V>(key, value);
-    m_back = m_back->m_next;
-  }
-  m_size++;
-  return true;
+bool linkedlist<K, V>::push_back(const K& key, const V& value,
+                                 uint64_t code) {
+  return emplace_back(code, key, value) != nullptr;
+}
+
+/// @brief Adds an element, moving it.
+/// Same as push_back() of constant key, value, but moves them
+/// to the new element. Nothing is moved if duplicate key found.
+/// @tparam K type of key.
+/// @tparam V type of value.
+/// @param code is a hash code of key, see push_back().
+/// @return result of adding.
+/// @retval true key has been added successfully.
+/// @retval false duplicate key found.
+template <typename K, typename V>
+bool linkedlist<K, V>::push_back(K&& key, V&& value, uint64_t code) {
+  return emplace_back(code, std::move(key), std::move(value)) != nullptr;
+}
+
+/// @brief Adds an element, constructing it's value in place.
+/// Traverses a list to find dublicate key first, constructs
+/// neither key nor value if it's found. Otherwise creates new
+/// element of key and value constructed of args, appends it to
+/// back of List.
+/// @tparam K type of key.
+/// @tparam V type of value.
+/// @tparam KK type of key, K or reference to K.
+/// @tparam Args types of value constructor arguments.
+/// @param code is a hash code of key, see push_back().
+/// @param key is a key, copied or moved to the element.
+/// @param args are value constructor arguments.
+/// @return new element or nullptr if duplicate key found.
+template <typename K, typename V>
+template <typename KK, typename... Args>
+listnode<K, V>* linkedlist<K, V>::emplace_back(uint64_t code, KK&& key,
+                                               Args&&... args) {
+  // issue: no need to have a tail because of that.
+  for (listnode<K, V>* node = m_front; node; node = node->m_next)
+    if (node->may_match(code) && node->m_key == key)
+      return nullptr;  // dublicate keys
+  return emplace_back_unique(code, std::forward<KK>(key),
+                             std::forward<Args>(args)...);
+}
+
+/// @brief Adds an element of absent key, constructing value in place.
+/// Creates new element of key and value constructed of args, appends
+/// it to back of List without looking for dublicate key: caller
+/// knows key is not in List.
+/// @tparam K type of key.
+/// @tparam V type of value.
+/// @tparam KK type of key, K or reference to K.
+/// @tparam Args types of value constructor arguments.
+/// @param code is a hash code of key, see push_back().
+/// @param key is a key, copied or moved to the element.
+/// @param args are value constructor arguments.
+/// @return new element.
+template <typename K, typename V>
+template <typename KK, typename... Args>
+listnode<K, V>* linkedlist<K, V>::emplace_back_unique(uint64_t code,
+                                                      KK&& key,
+                                                      Args&&... args) {
+  listnode<K, V>* node = create_node(emplace_tag(), code,
+                                     std::forward<KK>(key),
+                                     std::forward<Args>(args)...);
+  link_back(node);
+  return node;
 }
 
 /// @brief Removes an element.
@@ -204,27 +399,30 @@ bool linkedlist<K, V>::push_back(const K& key, const V& value) {
 /// removes found element from List.
 /// @tparam K type of key.
 /// @tparam V type of value.
+/// @tparam Q type of key or of view of key comparable to K.
+/// @param code is a hash code of key, see push_back().
 /// @return result of removal.
 /// @retval true key has been removed successfully.
 /// @retval false no key found.
 template <typename K, typename V>
-bool linkedlist<K, V>::erase(const K& key) {
+template <typename Q>
+bool linkedlist<K, V>::erase(const Q& key, uint64_t code) {
   listnode<K, V>* node;
   listnode<K, V>* prev = nullptr;
   for ( node = m_front; node; node = node->m_next ) {
-    if ( node->m_key == key ) {
+    if ( node->may_match(code) && node->m_key == key ) {
       if ( node == m_front ) {
         m_front = node->m_next;
         if (node == m_back)
           m_back = nullptr;
-        delete node;
+        destroy_node(node);
         m_size--;
         return true;
       } else {
         prev->m_next = node->m_next;
         if (node == m_back)
           m_back = prev;
-        delete node;
+        destroy_node(node);
         m_size--;
         return true;
       }
@@ -239,13 +437,17 @@ bool linkedlist<K, V>::erase(const K& key) {
 /// Traverses a list comparing keys to find a matched key,
 /// @tparam K type of key.
 /// @tparam V type of value.
+/// @tparam Q type of key or of view of key comparable to K.
+/// @param code is a hash code of key, see push_back().
 /// @return immutable list node.
 /// @retval true key has been removed successfully.
 /// @retval false no key found.
 template <typename K, typename V>
-const listnode<K, V>* linkedlist<K, V>::find(const K& key) const {
+template <typename Q>
+const listnode<K, V>* linkedlist<K, V>::find(const Q& key,
+                                             uint64_t code) const {
   for (listnode<K, V>* node = m_front; node; node = node->m_next)
-    if (node->m_key == key)
+    if (node->may_match(code) && node->m_key == key)
       return node;
     // likely, because list size is usually about 1
   return nullptr;
@@ -256,13 +458,16 @@ const listnode<K, V>* linkedlist<K, V>::find(const K& key) const {
 /// Traverses a list comparing keys to find a matched key,
 /// @tparam K type of key.
 /// @tparam V type of value.
+/// @tparam Q type of key or of view of key comparable to K.
+/// @param code is a hash code of key, see push_back().
 /// @return immutable list node.
 /// @retval pointer to node, if element found.
 /// @retval nullptr, if element is not found.
 template <typename K, typename V>
-listnode<K, V>* linkedlist<K, V>::find(const K& key) {
+template <typename Q>
+listnode<K, V>* linkedlist<K, V>::find(const Q& key, uint64_t code) {
   for (listnode<K, V>* node = m_front; node; node = node->m_next)
-    if (node->m_key == key)
+    if (node->may_match(code) && node->m_key == key)
       return node;
     // likely, because list size is usually about 1
   return nullptr;
@@ -293,6 +498,86 @@ bool linkedlist<K, V>::empty() {
   return false;
 }
 
+/// @brief Sets pool to take nodes from.
+/// @tparam K type of key.
+/// @tparam V type of value.
+/// @param pool is a storage of nodes, must outlive List.
+/// @return nothing.
+template <typename K, typename V>
+void linkedlist<K, V>::set_pool(nodepool<listnode<K, V>>* pool) {
+  assert(m_front == nullptr);
+  m_pool = pool;
+}
+
+/// @brief Forgets all elements without destroying them.
+/// Nodes are left to the owner of pool, which releases
+/// them all at once.
+/// @tparam K type of key.
+/// @tparam V type of value.
+/// @return nothing.
+template <typename K, typename V>
+void linkedlist<K, V>::detach() {
+  assert(m_pool != nullptr || m_front == nullptr);
+  m_size = 0;
+  m_back = m_front = nullptr;
+}
+
+/// @brief Unlinks first element without destroying it.
+/// Node keeps it's address and may be linked to another List
+/// sharing the same pool.
+/// @tparam K type of key.
+/// @tparam V type of value.
+/// @return unlinked node.
+/// @retval pointer to node, if List is not empty.
+/// @retval nullptr otherwise.
+template <typename K, typename V>
+listnode<K, V>* linkedlist<K, V>::unlink_front() {
+  listnode<K, V>* node = m_front;
+  if (node == nullptr)
+    return nullptr;
+  m_front = node->m_next;
+  if (node == m_back)
+    m_back = nullptr;
+  node->m_next = nullptr;
+  m_size--;
+  return node;
+}
+
+/// @brief Links element to the front of List.
+/// Takes ownership of node unlinked from another List sharing
+/// the same pool. Caller guarantees the key is not in List.
+/// @tparam K type of key.
+/// @tparam V type of value.
+/// @param node is a node without link.
+/// @return nothing.
+template <typename K, typename V>
+void linkedlist<K, V>::link_front(listnode<K, V>* node) {
+  assert(node != nullptr && node->m_next == nullptr);
+  node->m_next = m_front;
+  m_front = node;
+  if (m_back == nullptr)
+    m_back = node;
+  m_size++;
+}
+
+/// @brief Links element to the back of List.
+/// Takes ownership of node created by the pool of List, keeps
+/// order of linked nodes. Caller guarantees the key is not in List.
+/// @tparam K type of key.
+/// @tparam V type of value.
+/// @param node is a node without link.
+/// @return nothing.
+template <typename K, typename V>
+void linkedlist<K, V>::link_back(listnode<K, V>* node) {
+  assert(node != nullptr && node->m_next == nullptr);
+  if (m_back == nullptr)
+    m_front = node;
+  else
+    m_back->m_next = node;
+  m_back = node;
+  m_size++;
+}
+
 /// @brief Removes all elements from List.
 /// @tparam K type of key.
 /// @tparam V type of value.
@@ -302,13 +587,41 @@ void linkedlist<K, V>::clear() {
   listnode<K, V> *node_to_delete = m_front;
     while (node_to_delete != nullptr) {
         m_front = m_front->m_next;
-        delete node_to_delete;
+        destroy_node(node_to_delete);
         node_to_delete = m_front;
     }
     m_size = 0;
     m_back = m_front = nullptr;
 }
 
+/// @brief Creates node.
+/// Takes node from pool if List has one, otherwise from heap.
+/// @tparam K type of key.
+/// @tparam V type of value.
+/// @tparam Args types of node constructor arguments.
+/// @param args are node constructor arguments.
+/// @return new node.
+template <typename K, typename V>
+template <typename... Args>
+listnode<K, V>* linkedlist<K, V>::create_node(Args&&... args) {
+  if (m_pool != nullptr)
+    return m_pool->create(std::forward<Args>(args)...);
+  return new listnode<K, V>(std::forward<Args>(args)...);
+}
+
+/// @brief Destroys node.
+/// Returns node to pool if List has one, otherwise to heap.
+/// @tparam K type of key.
+/// @tparam V type of value.
+/// @return nothing.
+template <typename K, typename V>
+void linkedlist<K, V>::destroy_node(listnode<K, V>* node) {
+  if (m_pool != nullptr)
+    m_pool->destroy(node);
+  else
+    delete node;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Printout
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,175 @@
+// Copyright 2016
+#ifndef ESR_LITERALHASHTABLE_FLYMAKE_HPP_
+#define ESR_LITERALHASHTABLE_FLYMAKE_HPP_
+////////////////////////////////////////////////////////////////////////////////
+// LiteralHashtable <V, N>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>      // uint8_t, uint16_t, uint32_t.
+#include <string_view>  // std::string_view.
+#include <type_traits>  // std::conditional_t.
+#include <utility>      // std::pair.
+
+#include <esr/hasher.hpp>      // fnv1a(), mix().
+#include <esr/hashexcept.hpp>  // Hashtable's specific exceptions.
+
+namespace esr {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class LiteralHashtable.
+///
+/// @brief Fixed size hashtable of N keys known at compile time.
+/// Built by constexpr constructor, see make_literal_table(): a table
+/// declared constexpr lives in read only data, no allocation and no
+/// initialization at run time, and lookups of literal keys in
+/// constant expressions fold to constants. Keys are hashed by
+/// fnv1a(), slots are numbers of elements plus one, 0 is an empty
+/// slot, found by linear probing. Slot array is a power of two of at
+/// least 2N slots of the narrowest type which fits N.
+/// Keys are views: characters must outlive the table, as literals do.
+/// @tparam V type of hash value, must be literal type and default
+/// constructible.
+/// @tparam N number of elements.
+////////////////////////////////////////////////////////////////////////////////
+template <typename V, size_t N>
+class LiteralHashtable {
+  static_assert(N > 0, "LiteralHashtable needs at least one element");
+
+ public:
+  /// Element of the range the table is built of.
+  typedef std::pair<std::string_view, V> value_type;
+
+  /// Constructor, builds LiteralHashtable of N elements.
+  constexpr explicit LiteralHashtable(const value_type (&elements)[N]);
+
+  /// Gets constant pointer to value by key.
+  constexpr const V* get(std::string_view key) const;
+
+  /// Checks if key is in table.
+  constexpr bool contains(std::string_view key) const {
+    return get(key) != nullptr;
+  }
+
+  /// Gets a number of elements in table.
+  constexpr size_t size() const { return N; }
+
+  /// Gets a number of slots.
+  constexpr size_t capacity() const { return m_Capacity; }
+
+  /// Gets key of element by it's number, in order of construction.
+  constexpr std::string_view key(size_t idx) const { return m_keys[idx]; }
+
+  /// Gets value of element by it's number, in order of construction.
+  constexpr const V& value(size_t idx) const { return m_values[idx]; }
+
+ private:
+  /// Gets the least power of two of at least 2N.
+  static constexpr size_t capacity_of(size_t size) {
+    size_t capacity = 2;
+    while (capacity < 2*size)
+      capacity *= 2;
+    return capacity;
+  }
+
+  /// Number of slots.
+  static constexpr size_t m_Capacity = capacity_of(N);
+
+  /// Type of slot, the narrowest for numbers 0..N.
+  typedef std::conditional_t<(N < 0xff), uint8_t,
+          std::conditional_t<(N < 0xffff), uint16_t, uint32_t>> slot_type;
+
+  /// Keys by numbers of elements.
+  std::string_view m_keys[N];
+
+  /// Values by numbers of elements.
+  V m_values[N];
+
+  /// Numbers of elements plus one, 0 for empty slot.
+  slot_type m_slots[m_Capacity];
+
+  /// Gets the first slot of key.
+  static constexpr size_t home(std::string_view key) {
+    return mix(fnv1a(key)) & (m_Capacity - 1);
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+template <typename V, size_t N>
+constexpr size_t LiteralHashtable<V, N>::m_Capacity;
+
+////////////////////////////////////////////////////////////////////////////////
+// Constructors.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Constructor for LiteralHashtable.
+/// Places elements in order, each at the first empty slot from the
+/// home slot of it's key.
+/// @tparam V type of hash value.
+/// @tparam N number of elements.
+/// @param elements is an array of key, value pairs.
+/// @return nothing.
+/// @throw hashtable exception on duplicate key, which fails
+/// compilation of constexpr table.
+template <typename V, size_t N>
+constexpr LiteralHashtable<V, N>::LiteralHashtable(
+    const value_type (&elements)[N]) :
+    m_keys(),
+    m_values(),
+    m_slots() {
+  for (size_t i = 0; i < N; ++i) {
+    size_t slot = home(elements[i].first);
+    for (; m_slots[slot] != 0; slot = (slot + 1) & (m_Capacity - 1)) {
+      if (m_keys[m_slots[slot] - 1] == elements[i].first)
+        throw exception::hashtable(__ESR_PRETTY_FUNCTION__, "duplicate key");
+    }
+    m_keys[i] = elements[i].first;
+    m_values[i] = elements[i].second;
+    m_slots[slot] = static_cast<slot_type>(i + 1);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Accessors.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Gets value by it's key.
+/// Provides read access to LiteralHashtable's element by it's key
+/// using pointer. Probes slots from the home slot of key to an empty
+/// one, at most half of the slots are taken.
+/// @tparam V type of hash value.
+/// @tparam N number of elements.
+/// @param key is a key of element in LiteralHashtable.
+/// @return valid constant pointer to value in LiteralHashtable or
+/// nullptr if no element with such key found in LiteralHashtable.
+template <typename V, size_t N>
+constexpr const V* LiteralHashtable<V, N>::get(std::string_view key) const {
+  for (size_t slot = home(key); m_slots[slot] != 0;
+       slot = (slot + 1) & (m_Capacity - 1)) {
+    if (m_keys[m_slots[slot] - 1] == key)
+      return &m_values[m_slots[slot] - 1];
+  }
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Builder.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Builds LiteralHashtable of a braced list of elements.
+/// E.g. constexpr auto table = make_literal_table<int>({{"one", 1},
+/// {"two", 2}}); the number of elements is deduced.
+/// @tparam V type of hash value.
+/// @tparam N number of elements.
+/// @param elements is an array of key, value pairs.
+/// @return LiteralHashtable of the elements.
+template <typename V, size_t N>
+constexpr LiteralHashtable<V, N> make_literal_table(
+    const std::pair<std::string_view, V> (&elements)[N]) {
+  return LiteralHashtable<V, N>(elements);
+}
+
+}  // namespace esr
+
+#endif  // ESR_LITERALHASHTABLE_FLYMAKE_HPP_
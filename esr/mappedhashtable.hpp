@@ -0,0 +1,536 @@
+// Copyright 2016
+#ifndef ESR_MAPPEDHASHTABLE_FLYMAKE_HPP_
+#define ESR_MAPPEDHASHTABLE_FLYMAKE_HPP_
+////////////////////////////////////////////////////////////////////////////////
+// MappedHashtable <V>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <fcntl.h>     // open().
+#include <sys/mman.h>  // mmap(), munmap().
+#include <sys/stat.h>  // fstat().
+#include <unistd.h>    // close().
+
+#include <cstdint>      // uint64_t.
+#include <cstdio>       // std::rename(), std::remove().
+#include <cstring>      // std::memcpy(), std::memcmp().
+#include <fstream>      // std::ofstream.
+#include <memory>       // std::unique_ptr.
+#include <string>       // std::string.
+#include <string_view>  // std::string_view.
+#include <type_traits>  // std::is_trivially_copyable.
+
+#include <esr/hasher.hpp>      // Basic hash functions.
+#include <esr/hashexcept.hpp>  // Hashtable's specific exceptions.
+
+namespace esr {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class mappedentry.
+///
+/// @brief Element of MappedHashtable.
+/// Views key and value in the mapped file.
+/// @tparam V type of hash value.
+////////////////////////////////////////////////////////////////////////////////
+template <typename V>
+class mappedentry {
+ public:
+  /// @brief Creates element of key and value in the mapped file.
+  mappedentry(std::string_view key, const V* value) :
+      m_key(key), m_value(value) {}
+
+  /// @brief Gets key.
+  /// Returns view of key.
+  std::string_view key() const { return m_key; }
+
+  /// @brief Gets immutable value.
+  /// Returns reference to value.
+  const V& value() const { return *m_value; }
+
+ private:
+  std::string_view m_key;
+  const V* m_value;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class MappedHashtable.
+///
+/// @brief Read only Hashtable of std::string keys served from a file
+/// mapped to memory.
+/// write() stores a table to a file of position independent
+/// sections: bucket array of offsets of the first element of every
+/// bucket, element records of hash code and key offset, packed values
+/// and packed keys. Constructor maps the file and checks it's header,
+/// lookups read the mapping: no parsing, no allocation, pages are read
+/// on the first touch and shared by processes mapping the same file.
+/// Files are in native byte order of the writer.
+/// @tparam V type of hash value, trivially copyable.
+////////////////////////////////////////////////////////////////////////////////
+template <typename V>
+class MappedHashtable {
+  static_assert(std::is_trivially_copyable<V>::value,
+                "values of mapped table are bytes of the file");
+
+ public:
+  class iterator;
+
+  /// Maps table file.
+  explicit MappedHashtable(const std::string& path);
+
+  /// Destructor, unmaps table file.
+  virtual ~MappedHashtable();
+
+  /// Writes table of std::string keys and V values to table file.
+  template <typename Table>
+  static void write(Table& table, const std::string& path);
+
+  /// Gets constant pointer to value by key.
+  const V* get(std::string_view key) const;
+
+  /// Checks if key is in table.
+  bool contains(std::string_view key) const { return get(key) != nullptr; }
+
+  /// Finds a value by key.
+  iterator find(std::string_view key) const;
+
+  /// Gets a number of elements in table.
+  size_t size() const { return m_size; }
+
+  /// Gets a number of buckets.
+  size_t bucket_count() const { return m_bucket_count; }
+
+  /// Forward iterator, follows buckets.
+  class iterator {
+   public:
+    /// @brief Creates MappedHashtable's iterator.
+    /// @param owner is a MappedHashtable object, owner of the iterator.
+    /// @param current_idx is a number of the current element.
+    iterator(const MappedHashtable* owner, size_t current_idx) :
+        m_owner(owner),
+        m_current_idx(current_idx),
+        m_current(owner->element(current_idx)) {}
+
+    /// Advances the iterator to the next element.
+    iterator& operator++() {
+      m_current = m_owner->element(++m_current_idx);
+      return *this;
+    }
+
+    /// Dereferenses an iterator.
+    const mappedentry<V>& operator*() const;
+
+    /// Dereferenses an iterator.
+    const mappedentry<V>* operator->() const { return &**this; }
+
+    /// Inequality comparison of iterators.
+    bool operator!=(const iterator& rhs) const {
+      return m_current_idx != rhs.m_current_idx;
+    }
+
+    /// Equality comparison of iterators.
+    bool operator==(const iterator& rhs) const {
+      return m_current_idx == rhs.m_current_idx;
+    }
+
+   private:
+    /// Owner of the iterator.
+    const MappedHashtable* m_owner;
+
+    /// Number of the current element, size of table for end iterator.
+    size_t m_current_idx;
+
+    /// The current element.
+    mappedentry<V> m_current;
+  };
+
+  /// Gets the beginning of MappedHashtable.
+  iterator begin() const { return iterator(this, 0); }
+
+  /// Gets the end of MappedHashtable.
+  iterator end() const { return iterator(this, m_size); }
+
+ private:
+  /// Header of table file, offsets are from the file start.
+  struct header {
+    char magic[8];          //< m_Magic.
+    uint64_t version;       //< m_Version.
+    uint64_t value_size;    //< sizeof(V).
+    uint64_t value_align;   //< alignof(V).
+    uint64_t size;          //< Number of elements.
+    uint64_t bucket_count;  //< Number of buckets, power of two.
+    uint64_t buckets;       //< Offset of bucket_count + 1 element numbers.
+    uint64_t records;       //< Offset of size records.
+    uint64_t values;        //< Offset of size values.
+    uint64_t keys;          //< Offset of packed keys.
+    uint64_t file_size;     //< Size of file.
+  };
+
+  /// Element record, elements of a bucket are adjacent.
+  struct record {
+    uint64_t code;        //< Hash code of key.
+    uint64_t key_offset;  //< Offset of key from the packed keys.
+    uint64_t key_size;    //< Size of key.
+  };
+
+  /// Hash function to get hash code of key.
+  hash_function<std::string> hash;
+
+  /// Path of table file.
+  std::string m_path;
+
+  /// Mapped table file.
+  const unsigned char* m_mapping;
+
+  /// Size of table file.
+  size_t m_file_size;
+
+  /// Number of elements.
+  size_t m_size;
+
+  /// Number of buckets.
+  size_t m_bucket_count;
+
+  /// Numbers of the first elements of buckets.
+  const uint64_t* m_buckets;
+
+  /// Element records.
+  const record* m_records;
+
+  /// Values.
+  const V* m_values;
+
+  /// Packed keys.
+  const char* m_keys;
+
+  /// Size of packed keys.
+  size_t m_keys_size;
+
+  /// Gets bucket of hash code.
+  static size_t bucket_of(uint64_t code, size_t bucket_count) {
+    return mix(code) & (bucket_count - 1);
+  }
+
+  /// Gets element by number, key of end element is empty.
+  mappedentry<V> element(size_t idx) const;
+
+  /// Gets a number of element by key, size of table if no such key.
+  size_t lookup(std::string_view key) const;
+
+  /// Checks header and sets sections of mapped file.
+  void attach();
+
+  /// Checks that a section of count items of item_size bytes at
+  /// offset lies in the file.
+  bool in_file(uint64_t offset, uint64_t count, uint64_t item_size) const {
+    return offset <= m_file_size &&
+        (item_size == 0 || count <= (m_file_size - offset)/item_size);
+  }
+
+  /// Gets offset aligned up to align.
+  static uint64_t aligned(uint64_t offset, uint64_t align) {
+    return (offset + align - 1)/align*align;
+  }
+
+  /// Not copyable, the mapping is owned by one table.
+  MappedHashtable(const MappedHashtable&);
+  MappedHashtable& operator=(const MappedHashtable&);
+
+  /// Signature of table file.
+  static const char m_Magic[8];
+
+  /// Version of table file format.
+  static const uint64_t m_Version = 1;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+template <typename V>
+const char MappedHashtable<V>::m_Magic[8] = {
+  'E', 'S', 'R', 'M', 'A', 'P', 'H', 'T'};
+template <typename V>
+const uint64_t MappedHashtable<V>::m_Version;
+
+////////////////////////////////////////////////////////////////////////////////
+// Constructor, Destructor.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Constructor for MappedHashtable.
+/// Maps table file read only and checks it's header: the cost doesn't
+/// depend on number of elements.
+/// @tparam V type of hash value.
+/// @param path is a path of table file written by write().
+/// @return nothing.
+/// @throw table_file exception if file can't be mapped or isn't a
+/// table of V values.
+template <typename V>
+MappedHashtable<V>::MappedHashtable(const std::string& path) :
+    hash(),
+    m_path(path),
+    m_mapping(nullptr),
+    m_file_size(0),
+    m_size(0),
+    m_bucket_count(0),
+    m_buckets(nullptr),
+    m_records(nullptr),
+    m_values(nullptr),
+    m_keys(nullptr),
+    m_keys_size(0) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw exception::table_file(path, __ESR_PRETTY_FUNCTION__,
+                                "can't open table file");
+  struct stat status;
+  void* mapping = MAP_FAILED;
+  if (::fstat(fd, &status) == 0 && status.st_size > 0)
+    mapping = ::mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);  // mapping keeps the file
+  if (mapping == MAP_FAILED)
+    throw exception::table_file(path, __ESR_PRETTY_FUNCTION__,
+                                "can't map table file");
+  m_mapping = static_cast<const unsigned char*>(mapping);
+  m_file_size = status.st_size;
+  try {
+    attach();
+  } catch (...) {
+    ::munmap(const_cast<unsigned char*>(m_mapping), m_file_size);
+    throw;
+  }
+}
+
+/// @brief Destructor for MappedHashtable.
+/// Unmaps table file.
+/// @tparam V type of hash value.
+/// @return nothing.
+template <typename V>
+MappedHashtable<V>::~MappedHashtable() {
+  ::munmap(const_cast<unsigned char*>(m_mapping), m_file_size);
+}
+
+/// @brief Checks header and sets sections of mapped file.
+/// Sections must lie in the file and be aligned for their items.
+/// Content of sections is checked by lookups as they go.
+/// @tparam V type of hash value.
+/// @return nothing.
+/// @throw table_file exception if file isn't a table of V values.
+template <typename V>
+void MappedHashtable<V>::attach() {
+  header head;
+  if (m_file_size < sizeof(head))
+    throw exception::table_file(m_path, __ESR_PRETTY_FUNCTION__,
+                                "table file is truncated");
+  std::memcpy(&head, m_mapping, sizeof(head));
+  if (std::memcmp(head.magic, m_Magic, sizeof(m_Magic)) != 0 ||
+      head.version != m_Version)
+    throw exception::table_file(m_path, __ESR_PRETTY_FUNCTION__,
+                                "not a table file");
+  if (head.value_size != sizeof(V) || head.value_align != alignof(V))
+    throw exception::table_file(m_path, __ESR_PRETTY_FUNCTION__,
+                                "table file of other value type");
+  if (head.file_size != m_file_size ||
+      head.bucket_count == 0 ||
+      (head.bucket_count & (head.bucket_count - 1)) != 0 ||
+      head.buckets % alignof(uint64_t) != 0 ||
+      head.records % alignof(record) != 0 ||
+      head.values % alignof(V) != 0 ||
+      !in_file(head.buckets, head.bucket_count + 1, sizeof(uint64_t)) ||
+      !in_file(head.records, head.size, sizeof(record)) ||
+      !in_file(head.values, head.size, sizeof(V)) ||
+      !in_file(head.keys, 0, 0))
+    throw exception::table_file(m_path, __ESR_PRETTY_FUNCTION__,
+                                "table file is corrupted");
+
+  m_size = head.size;
+  m_bucket_count = head.bucket_count;
+  m_buckets = reinterpret_cast<const uint64_t*>(m_mapping + head.buckets);
+  m_records = reinterpret_cast<const record*>(m_mapping + head.records);
+  m_values = reinterpret_cast<const V*>(m_mapping + head.values);
+  m_keys = reinterpret_cast<const char*>(m_mapping + head.keys);
+  m_keys_size = m_file_size - head.keys;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Iterator.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Dereferenses an iterator.
+/// Provides access to MappedHashtable's element by it's reference.
+/// @tparam V type of hash value.
+/// @return reference to MappedHashtable's element, valid until the
+/// iterator advances.
+/// @throw end_iterator exception in attempt to dereferencing an
+/// end iterator.
+template <typename V>
+const mappedentry<V>& MappedHashtable<V>::iterator::operator*() const {
+  if (m_current_idx >= m_owner->m_size)
+    throw exception::end_iterator(m_current_idx, __ESR_PRETTY_FUNCTION__);
+  return m_current;
+}
+
+/// @brief Gets element by number.
+/// Key of element which lies out of packed keys is empty.
+/// @tparam V type of hash value.
+/// @param idx is a number of element, size of table for end element.
+/// @return element, empty key and no value for end element.
+template <typename V>
+mappedentry<V> MappedHashtable<V>::element(size_t idx) const {
+  if (idx >= m_size)
+    return mappedentry<V>(std::string_view(), nullptr);
+  const record& r = m_records[idx];
+  if (r.key_offset > m_keys_size || r.key_size > m_keys_size - r.key_offset)
+    return mappedentry<V>(std::string_view(), &m_values[idx]);
+  return mappedentry<V>(std::string_view(m_keys + r.key_offset, r.key_size),
+                        &m_values[idx]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Accessors.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Gets a number of element by key.
+/// Compares hash codes of elements of the key's bucket first, keys
+/// only when codes match.
+/// @tparam V type of hash value.
+/// @param key is a key of element.
+/// @return number of element or size of table if no such key.
+template <typename V>
+size_t MappedHashtable<V>::lookup(std::string_view key) const {
+  uint64_t code = hash.code(key);
+  size_t bucket_idx = bucket_of(code, m_bucket_count);
+  uint64_t last = m_buckets[bucket_idx + 1];
+  if (last > m_size)
+    return m_size;  // corrupted bucket
+  for (uint64_t idx = m_buckets[bucket_idx]; idx < last; ++idx) {
+    const record& r = m_records[idx];
+    if (r.code != code || r.key_size != key.size() ||
+        r.key_offset > m_keys_size || r.key_size > m_keys_size - r.key_offset)
+      continue;
+    if (std::memcmp(m_keys + r.key_offset, key.data(), key.size()) == 0)
+      return idx;
+  }
+  return m_size;
+}
+
+/// @brief Gets value by it's key.
+/// Provides read access to MappedHashtable's element by it's key
+/// using pointer.
+/// @tparam V type of hash value.
+/// @param key is a key of element in MappedHashtable.
+/// @return valid constant pointer to value in mapped file or nullptr
+/// if no element with such key found in MappedHashtable.
+template <typename V>
+const V* MappedHashtable<V>::get(std::string_view key) const {
+  size_t idx = lookup(key);
+  return idx == m_size ? nullptr : &m_values[idx];
+}
+
+/// @brief Finds a value by key.
+/// Provides read access to MappedHashtable's element by it's key
+/// using iterator.
+/// @tparam V type of hash value.
+/// @param key is a key to MappedHashtable's element.
+/// @return iterator to element if found, otherwise it returns
+/// an iterator to MappedHashtable::end.
+template <typename V>
+typename MappedHashtable<V>::iterator
+MappedHashtable<V>::find(std::string_view key) const {
+  return iterator(this, lookup(key));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writer.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Writes table to table file.
+/// Iterates table twice: counts elements and key bytes of every
+/// bucket, then places elements of a bucket next to each other.
+/// Buckets of file are about as many as elements. File is written
+/// aside, to path with ".tmp" suffix, and renamed over path once
+/// it's complete: tables which map the former file keep reading it,
+/// and no reader opens a partial file.
+/// @tparam V type of hash value.
+/// @tparam Table is a table of std::string keys and V values, e.g.
+/// Hashtable<std::string, V>.
+/// @param table is a table to write.
+/// @param path is a path of table file, replaced if exists.
+/// @return nothing.
+/// @throw table_file exception if file can't be written.
+template <typename V>
+template <typename Table>
+void MappedHashtable<V>::write(Table& table, const std::string& path) {
+  hash_function<std::string> hash;
+  size_t size = table.size();
+  size_t bucket_count = 1;
+  while (bucket_count < size)
+    bucket_count += bucket_count;
+
+  // bucket_idx + 1 counts elements of bucket, then becomes position
+  // of it's next element
+  std::unique_ptr<uint64_t[]> buckets(new uint64_t[bucket_count + 1]());
+  uint64_t keys_size = 0;
+  for (auto& element : table) {
+    ++buckets[bucket_of(hash.code(element.key()), bucket_count) + 1];
+    keys_size += element.key().size();
+  }
+  for (size_t i = 0; i < bucket_count; ++i)
+    buckets[i + 1] += buckets[i];
+
+  std::unique_ptr<record[]> records(new record[size]);
+  std::unique_ptr<unsigned char[]> values(new unsigned char[size*sizeof(V)]);
+  std::unique_ptr<const std::string*[]> keys(new const std::string*[size]);
+  std::unique_ptr<uint64_t[]> next(new uint64_t[bucket_count]);
+  std::memcpy(next.get(), buckets.get(), bucket_count*sizeof(uint64_t));
+  for (auto& element : table) {
+    uint64_t code = hash.code(element.key());
+    uint64_t idx = next[bucket_of(code, bucket_count)]++;
+    records[idx].code = code;
+    records[idx].key_size = element.key().size();
+    std::memcpy(&values[idx*sizeof(V)], &element.value(), sizeof(V));
+    keys[idx] = &element.key();
+  }
+  uint64_t key_offset = 0;
+  for (size_t idx = 0; idx < size; ++idx) {
+    records[idx].key_offset = key_offset;
+    key_offset += records[idx].key_size;
+  }
+
+  header head = header();
+  std::memcpy(head.magic, m_Magic, sizeof(m_Magic));
+  head.version = m_Version;
+  head.value_size = sizeof(V);
+  head.value_align = alignof(V);
+  head.size = size;
+  head.bucket_count = bucket_count;
+  head.buckets = aligned(sizeof(head), alignof(uint64_t));
+  head.records = aligned(head.buckets + (bucket_count + 1)*sizeof(uint64_t),
+                         alignof(record));
+  head.values = aligned(head.records + size*sizeof(record), alignof(V));
+  head.keys = head.values + size*sizeof(V);
+  head.file_size = head.keys + keys_size;
+
+  std::string temp_path = path + ".tmp";
+  std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+  uint64_t written = 0;
+  const char padding[alignof(record) + alignof(V)] = {};
+  auto put = [&file, &written, &padding](uint64_t offset, const void* data,
+                                         uint64_t count) {
+    file.write(padding, offset - written);
+    file.write(static_cast<const char*>(data), count);
+    written = offset + count;
+  };
+  put(0, &head, sizeof(head));
+  put(head.buckets, buckets.get(), (bucket_count + 1)*sizeof(uint64_t));
+  put(head.records, records.get(), size*sizeof(record));
+  put(head.values, values.get(), size*sizeof(V));
+  for (size_t idx = 0; idx < size; ++idx)
+    file.write(keys[idx]->data(), keys[idx]->size());
+  file.close();
+  if (!file || std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+    throw exception::table_file(path, __ESR_PRETTY_FUNCTION__,
+                                "can't write table file");
+  }
+}
+
+}  // namespace esr
+
+#endif  // ESR_MAPPEDHASHTABLE_FLYMAKE_HPP_
@@ -0,0 +1,214 @@
+// Copyright 2016
+#ifndef ESR_NODEPOOL_FLYMAKE_HPP_
+#define ESR_NODEPOOL_FLYMAKE_HPP_
+////////////////////////////////////////////////////////////////////////////////
+// Node Pool <T>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>      // assert().
+#include <new>          // placement new.
+#include <type_traits>  // std::aligned_storage.
+#include <utility>      // std::forward().
+
+namespace esr {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class nodepool.
+///
+/// @brief Slab allocator for nodes of one type.
+/// Carves nodes from large blocks, block size doubles up to a limit.
+/// Destroyed nodes go to a free list and are reused by next creations.
+/// All blocks are released at once by the destructor, without
+/// destroying nodes still in use: their owner either destroys them
+/// before or doesn't need their destructors run.
+/// @tparam T type of node.
+////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+class nodepool {
+ public:
+  /// Storage of a node, links free storages together.
+  union slot {
+    slot* m_next;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type m_storage;
+  };
+
+  /// @brief Default constructor, creates empty pool.
+  /// @param first_block_size is a number of nodes in the first block.
+  /// @return nothing.
+  explicit nodepool(size_t first_block_size = m_FirstBlockSizeDefault) :
+      m_next_block_size(first_block_size),
+      m_blocks(nullptr),
+      m_free(nullptr),
+      m_cursor(nullptr),
+      m_end(nullptr),
+      m_block_count(0) {
+    assert(first_block_size != 0);
+  }
+
+  /// Destructor, releases all blocks.
+  ~nodepool();
+
+  /// Creates node.
+  template <typename... Args>
+  T* create(Args&&... args);
+
+  /// Destroys node.
+  void destroy(T* node);
+
+  /// Gets storage for a number of nodes next to each other.
+  slot* allocate_run(size_t count);
+
+  /// Creates node in storage taken from the pool.
+  template <typename... Args>
+  T* create_at(slot* storage, Args&&... args);
+
+  /// Gets node constructed in storage.
+  static T* node(slot* storage) { return reinterpret_cast<T*>(storage); }
+
+  /// Gets a number of allocated blocks.
+  size_t block_count() const { return m_block_count; }
+
+ private:
+  /// Number of nodes in next block.
+  size_t m_next_block_size;
+
+  /// Allocated blocks, first slot of a block links the next one.
+  slot* m_blocks;
+
+  /// List of destroyed nodes.
+  slot* m_free;
+
+  /// Next never used slot of the last block.
+  slot* m_cursor;
+
+  /// End of the last block.
+  slot* m_end;
+
+  /// Number of allocated blocks.
+  size_t m_block_count;
+
+  /// Gets storage for a node.
+  slot* allocate();
+
+  /// Not copyable: nodes belong to the pool they came from.
+  nodepool(const nodepool&);
+  nodepool& operator=(const nodepool&);
+
+  /// Default number of nodes in the first block.
+  static const size_t m_FirstBlockSizeDefault = 64;
+
+  /// Maximum number of nodes in a block.
+  static const size_t m_MaxBlockSize = 64*1024;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+const size_t nodepool<T>::m_FirstBlockSizeDefault;
+template <typename T>
+const size_t nodepool<T>::m_MaxBlockSize;
+
+/// @brief Destructor for pool.
+/// Releases all blocks, one deallocation per block.
+/// @tparam T type of node.
+/// @return nothing.
+template <typename T>
+nodepool<T>::~nodepool() {
+  while (m_blocks != nullptr) {
+    slot* block = m_blocks;
+    m_blocks = block->m_next;
+    delete [] block;
+  }
+}
+
+/// @brief Gets storage for a node.
+/// Takes storage from the free list, then from the last block.
+/// Allocates a new block when the last one is exhausted.
+/// @tparam T type of node.
+/// @return pointer to storage.
+template <typename T>
+typename nodepool<T>::slot* nodepool<T>::allocate() {
+  if (m_free != nullptr) {
+    slot* storage = m_free;
+    m_free = storage->m_next;
+    return storage;
+  }
+  if (m_cursor == m_end) {  // unlikely
+    slot* block = new slot[m_next_block_size + 1];
+    block->m_next = m_blocks;  // first slot links blocks together
+    m_blocks = block;
+    m_cursor = block + 1;
+    m_end = m_cursor + m_next_block_size;
+    ++m_block_count;
+    if (m_next_block_size < m_MaxBlockSize)
+      m_next_block_size *= 2;
+  }
+  return m_cursor++;
+}
+
+/// @brief Creates node.
+/// Constructs node in storage taken from the pool.
+/// @tparam T type of node.
+/// @tparam Args types of node constructor arguments.
+/// @param args are node constructor arguments.
+/// @return pointer to node.
+template <typename T>
+template <typename... Args>
+T* nodepool<T>::create(Args&&... args) {
+  return create_at(allocate(), std::forward<Args>(args)...);
+}
+
+/// @brief Gets storage for a number of nodes next to each other.
+/// Allocates a block of it's own for the run, blocks of single
+/// nodes are not affected. Every node of the run is created by
+/// create_at(), may be destroyed one by one by destroy().
+/// @tparam T type of node.
+/// @param count is a number of nodes.
+/// @return storage of the first node, others follow it.
+template <typename T>
+typename nodepool<T>::slot* nodepool<T>::allocate_run(size_t count) {
+  assert(count != 0);
+  slot* block = new slot[count + 1];
+  block->m_next = m_blocks;  // first slot links blocks together
+  m_blocks = block;
+  ++m_block_count;
+  return block + 1;
+}
+
+/// @brief Creates node in storage.
+/// Constructs node in storage taken from the pool, storage returns
+/// to the free list if constructor throws.
+/// @tparam T type of node.
+/// @tparam Args types of node constructor arguments.
+/// @param storage is a storage taken from the pool.
+/// @param args are node constructor arguments.
+/// @return pointer to node.
+template <typename T>
+template <typename... Args>
+T* nodepool<T>::create_at(slot* storage, Args&&... args) {
+  try {
+    return new(&storage->m_storage) T(std::forward<Args>(args)...);
+  } catch (...) {
+    storage->m_next = m_free;
+    m_free = storage;
+    throw;
+  }
+}
+
+/// @brief Destroys node.
+/// Calls destructor of node and puts it's storage to the free list.
+/// @tparam T type of node.
+/// @param node is a pointer to node created by this pool.
+/// @return nothing.
+template <typename T>
+void nodepool<T>::destroy(T* node) {
+  node->~T();
+  slot* storage = reinterpret_cast<slot*>(node);
+  storage->m_next = m_free;
+  m_free = storage;
+}
+
+}  // namespace esr
+
+#endif  // ESR_NODEPOOL_FLYMAKE_HPP_
@@ -0,0 +1,75 @@
+// Copyright 2016
+#ifndef ESR_PARALLEL_FLYMAKE_HPP_
+#define ESR_PARALLEL_FLYMAKE_HPP_
+////////////////////////////////////////////////////////////////////////////////
+// Parallel tasks.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>       // size_t.
+#include <exception>     // std::exception_ptr.
+#include <memory>        // std::unique_ptr.
+#include <mutex>         // std::mutex, std::lock_guard.
+#include <new>           // std::nothrow.
+#include <system_error>  // std::system_error.
+#include <thread>        // std::thread.
+
+namespace esr {
+
+/// @brief Gets default number of workers of parallel tasks.
+/// @return number of hardware threads, at least one.
+inline size_t hardware_workers() {
+  unsigned count = std::thread::hardware_concurrency();
+  return count == 0 ? 1 : count;
+}
+
+/// @brief Runs tasks in parallel.
+/// Runs task(0), ..., task(count - 1) on count - 1 new threads and
+/// the calling one, returns when all of them are done. Tasks of
+/// threads which fail to start, for lack of threads or memory, run
+/// on the calling thread one after another: every task runs once.
+/// Thread start costs tens of microseconds: a task should be worth
+/// it.
+/// @tparam F type of function void(size_t).
+/// @param count is a number of tasks.
+/// @param task is a function of task number.
+/// @return nothing.
+/// @throw the first exception thrown by a task, after all tasks
+/// are done.
+template <typename F>
+void parallel_run(size_t count, F task) {
+  if (count == 0)
+    return;
+
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto run = [&task, &error, &error_mutex](size_t task_idx) {
+    try {
+      task(task_idx);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error)
+        error = std::current_exception();
+    }
+  };
+
+  std::unique_ptr<std::thread[]> threads(
+      new(std::nothrow) std::thread[count - 1]);
+  size_t started = 0;
+  try {
+    for (; threads && started < count - 1; ++started)
+      threads[started] = std::thread(run, started + 1);
+  } catch (const std::system_error&) {
+    // no more threads: the rest runs here
+  }
+  run(0);
+  for (size_t i = started + 1; i < count; ++i)
+    run(i);
+  for (size_t i = 0; i < started; ++i)
+    threads[i].join();
+  if (error)
+    std::rethrow_exception(error);
+}
+
+}  // namespace esr
+
+#endif  // ESR_PARALLEL_FLYMAKE_HPP_
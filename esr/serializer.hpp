@@ -0,0 +1,115 @@
+// Copyright 2016
+#ifndef ESR_SERIALIZER_FLYMAKE_HPP_
+#define ESR_SERIALIZER_FLYMAKE_HPP_
+////////////////////////////////////////////////////////////////////////////////
+// Serializers <T>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>      // uint64_t.
+#include <istream>      // std::istream.
+#include <ostream>      // std::ostream.
+#include <string>       // std::string.
+#include <type_traits>  // std::enable_if_t, std::is_arithmetic.
+
+namespace esr {
+
+/// @brief Writes a size as variable length integer.
+/// Seven bits per byte, low bits first, high bit of byte is set if
+/// more bytes follow: sizes below 128 take one byte.
+/// @param os is an output stream.
+/// @param size is a size to write.
+/// @return nothing.
+inline void write_size(std::ostream& os, uint64_t size) {
+  while (size >= 0x80) {
+    os.put(static_cast<char>((size & 0x7f) | 0x80));
+    size >>= 7;
+  }
+  os.put(static_cast<char>(size));
+}
+
+/// @brief Reads a size written by write_size().
+/// Sets failbit of the stream on a size of more than 64 bits.
+/// @param is is an input stream.
+/// @return size, 0 if stream failed.
+inline uint64_t read_size(std::istream& is) {
+  uint64_t size = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    int byte = is.get();
+    if (!is)
+      return 0;
+    size |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0)
+      return size;
+  }
+  is.setstate(std::ios::failbit);
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class serializer.
+///
+/// @brief Binary serializer of value of type T.
+/// Writes value to output stream and reads it back from input stream.
+/// Failures are reported by stream state, as stream operators do.
+/// Specialize with members void write(std::ostream&, const T&) and
+/// void read(std::istream&, T*) for custom type.
+/// @tparam T type of value.
+////////////////////////////////////////////////////////////////////////////////
+template <typename T, typename = void>
+class serializer;
+
+/// @brief Serializer of arithmetic types, e.g. int, uint32_t, double.
+/// Bytes of value in native byte order.
+template <typename T>
+class serializer<T, std::enable_if_t<std::is_arithmetic<T>::value &&
+                                     !std::is_same<T, bool>::value>> {
+ public:
+  void write(std::ostream& os, const T& value) const {
+    os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+  void read(std::istream& is, T* value) const {
+    is.read(reinterpret_cast<char*>(value), sizeof(*value));
+  }
+};
+
+/// @brief Serializer of bool, one byte of 0 or 1.
+template <>
+class serializer<bool> {
+ public:
+  void write(std::ostream& os, const bool& value) const {
+    os.put(value ? 1 : 0);
+  }
+  void read(std::istream& is, bool* value) const {
+    *value = is.get() == 1;
+  }
+};
+
+/// @brief Serializer of std::string, size followed by characters.
+/// Reads characters by chunks: a corrupted size fails on the end of
+/// stream rather than allocates as much.
+template <>
+class serializer<std::string> {
+ public:
+  void write(std::ostream& os, const std::string& value) const {
+    write_size(os, value.size());
+    os.write(value.data(), value.size());
+  }
+  void read(std::istream& is, std::string* value) const {
+    uint64_t size = read_size(is);
+    value->clear();
+    while (is && value->size() < size) {
+      size_t done = value->size();
+      size_t chunk = (size - done < m_Chunk) ? size - done : m_Chunk;
+      value->resize(done + chunk);
+      is.read(&(*value)[done], chunk);
+    }
+  }
+
+ private:
+  /// Number of characters read at once.
+  static const size_t m_Chunk = 1 << 16;
+};
+
+}  // namespace esr
+
+#endif  // ESR_SERIALIZER_FLYMAKE_HPP_
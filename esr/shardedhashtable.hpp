@@ -0,0 +1,414 @@
+// Copyright 2016
+#ifndef ESR_SHARDEDHASHTABLE_FLYMAKE_HPP_
+#define ESR_SHARDEDHASHTABLE_FLYMAKE_HPP_
+////////////////////////////////////////////////////////////////////////////////
+// ShardedHashtable <K, V>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <iomanip>  // std::setw().
+#include <mutex>    // std::mutex, std::unique_lock.
+#include <ostream>  // operator<<().
+#include <utility>  // std::pair.
+
+#include <esr/hashtable.hpp>  // Hashtable of a shard.
+#include <esr/hasher.hpp>     // Basic hash functions, mix().
+
+namespace esr {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class ShardedHashtable.
+///
+/// @brief Thread safe Hashtable split into independent shards.
+/// Shard number is taken from the high bits of mixed hash code of
+/// key, every shard is a Hashtable of it's own with a lock, node pool
+/// and resize of it's own, on cache lines of it's own. Writers of
+/// different shards don't collide and a resize moves 1/S of elements
+/// while other shards keep working. Buckets of a shard are mapped
+/// from hash code by M, which doesn't depend on the shard bits.
+/// Every operation counts in it's shard, and so does every wait for
+/// a shard held by another thread: stats() and dump_stats() show
+/// hot shards. Key is hashed twice: for it's shard and by the
+/// Hashtable of the shard.
+/// Interface is the one of ConcurrentHashtable.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H hash function: functor returning hash code of key,
+/// resolved at compile time.
+/// @tparam M bucket mapping of shards.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V, typename H = hash_function<K>,
+          typename M = fibonacci_mapping>
+class ShardedHashtable {
+ public:
+  /// Hashtable of a shard.
+  typedef Hashtable<K, V, H, M> shard_table_t;
+
+  /// Counters of a shard.
+  struct shard_stats {
+    size_t size;          ///< Number of elements.
+    size_t bucket_count;  ///< Number of buckets.
+    size_t load_factor;   ///< Elements per bucket (%).
+    size_t operations;    ///< Number of operations.
+    size_t contended;     ///< Operations that waited for the shard.
+  };
+
+  /// Constructor, creates ShardedHashtable.
+  explicit ShardedHashtable(size_t shard_count = m_ShardCountDefault);
+
+  /// Destructor, deletes ShardedHashtable.
+  ~ShardedHashtable() { delete [] m_shards; }
+
+  /// Adds key, value to hashtable.
+  bool add(const K& key, const V& value);
+
+  /// Removes key from hashtable.
+  void remove(const K& key);
+
+  /// Sets the value by key.
+  bool set(const K& key, const V& value);
+
+  /// Gets copy of value by key.
+  bool get(const K& key, V* value) const;
+
+  /// Checks if key is in hashtable.
+  bool contains(const K& key) const;
+
+  /// Gets copy of value of key, adds key, value if key is absent.
+  std::pair<V, bool> find_or_insert(const K& key, const V& value = V());
+
+  /// Adds key, value or combines value with value of key.
+  template <typename F>
+  bool upsert(const K& key, const V& value, F combine);
+
+  /// Reserves buckets of all shards for size elements.
+  void reserve(size_t size);
+
+  /// Visits all elements, shard after shard.
+  template <typename F>
+  void for_each(F visit);
+
+  /// Gets a number of elements in hashtable.
+  size_t size() const;
+
+  /// Gets a number of shards.
+  size_t shard_count() const { return size_t(1) << m_shard_bits; }
+
+  /// Gets counters of a shard.
+  shard_stats stats(size_t shard_idx) const;
+
+  /// Prints counters of all shards, a line per shard.
+  void dump_stats(std::ostream& os) const;
+
+ private:
+  /// Hashtable and it's lock, on cache lines of it's own.
+  struct alignas(64) shard {
+    shard() : m_operations(0), m_contended(0) {}
+    std::mutex m_mutex;     ///< Lock of table.
+    shard_table_t m_table;  ///< Elements.
+    size_t m_operations;    ///< Number of operations, under lock.
+    size_t m_contended;     ///< Number of waits for lock, under lock.
+  };
+
+  /// Hash function.
+  H hash;
+
+  /// Number of bits of shard number.
+  unsigned m_shard_bits;
+
+  /// Shards.
+  shard* m_shards;
+
+  /// Gets shard of key.
+  shard& shard_of(const K& key) const {
+    return m_shard_bits == 0 ?
+        m_shards[0] : m_shards[mix(hash(key)) >> (64 - m_shard_bits)];
+  }
+
+  /// Locks shard and counts the operation.
+  static std::unique_lock<std::mutex> acquire(shard* target);
+
+  /// Not copyable: threads share one table.
+  ShardedHashtable(const ShardedHashtable&);
+  ShardedHashtable& operator=(const ShardedHashtable&);
+
+  /// Default number of shards.
+  static const size_t m_ShardCountDefault = 64;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V, typename H, typename M>
+const size_t ShardedHashtable<K, V, H, M>::m_ShardCountDefault;
+
+////////////////////////////////////////////////////////////////////////////////
+// Constructor.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Constructor for ShardedHashtable.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param shard_count is a number of shards, rounded up to a power
+/// of two. About a shard or a few per core let writers rarely wait.
+/// @return nothing.
+template <typename K, typename V, typename H, typename M>
+ShardedHashtable<K, V, H, M>::ShardedHashtable(size_t shard_count) :
+    hash(),
+    m_shard_bits(0),
+    m_shards(nullptr) {
+  while ((size_t(1) << m_shard_bits) < shard_count)
+    ++m_shard_bits;
+  m_shards = new shard[this->shard_count()];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Accessors and Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Adds an element.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param key is a key to hashtable's element.
+/// @param value is a value of hashtable's element.
+/// @return result of insertion.
+/// @retval true if an element has been successfully inserted.
+/// @retval false if an element with such key is already in a
+/// hashtable.
+template <typename K, typename V, typename H, typename M>
+bool ShardedHashtable<K, V, H, M>::add(const K& key, const V& value) {
+  shard& target = shard_of(key);
+  std::unique_lock<std::mutex> lock(acquire(&target));
+  return target.m_table.add(key, value);
+}
+
+/// @brief Removes an element.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param key is a key to hashtable's element.
+/// @return nothing.
+template <typename K, typename V, typename H, typename M>
+void ShardedHashtable<K, V, H, M>::remove(const K& key) {
+  shard& target = shard_of(key);
+  std::unique_lock<std::mutex> lock(acquire(&target));
+  target.m_table.remove(key);
+}
+
+/// @brief Sets value by it's key.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param key is a key of element.
+/// @param value is a value of element.
+/// @return result of setting a value.
+/// @retval true on success.
+/// @retval false if no element with such key found in hashtable.
+template <typename K, typename V, typename H, typename M>
+bool ShardedHashtable<K, V, H, M>::set(const K& key, const V& value) {
+  shard& target = shard_of(key);
+  std::unique_lock<std::mutex> lock(acquire(&target));
+  return target.m_table.set(key, value);
+}
+
+/// @brief Gets value by it's key.
+/// Copies value under lock of key's shard.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param key is a key of element.
+/// @param value is set to a copy of value if key is found.
+/// @return true if key is found, false otherwise.
+template <typename K, typename V, typename H, typename M>
+bool ShardedHashtable<K, V, H, M>::get(const K& key, V* value) const {
+  shard& target = shard_of(key);
+  std::unique_lock<std::mutex> lock(acquire(&target));
+  const V* found = target.m_table.get(key);
+  if (found == nullptr)
+    return false;
+
+  *value = *found;
+  return true;
+}
+
+/// @brief Checks if key is in hashtable.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param key is a key of element.
+/// @return true if key is found, false otherwise.
+template <typename K, typename V, typename H, typename M>
+bool ShardedHashtable<K, V, H, M>::contains(const K& key) const {
+  shard& target = shard_of(key);
+  std::unique_lock<std::mutex> lock(acquire(&target));
+  return target.m_table.contains(key);
+}
+
+/// @brief Finds an element, adds it if key is absent.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param key is a key to hashtable's element.
+/// @param value is a value of added element.
+/// @return copy of value of key and true if element has been added,
+/// false if it's found.
+template <typename K, typename V, typename H, typename M>
+std::pair<V, bool> ShardedHashtable<K, V, H, M>::find_or_insert(
+    const K& key, const V& value) {
+  shard& target = shard_of(key);
+  std::unique_lock<std::mutex> lock(acquire(&target));
+  auto found = target.m_table.find_or_insert(key, value);
+  return std::pair<V, bool>(found.first->value(), found.second);
+}
+
+/// @brief Adds an element or combines it's value.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @tparam F type of function V(const V&, const V&).
+/// @param key is a key to hashtable's element.
+/// @param value is a value to add or to combine with.
+/// @param combine is a function of value of key and value, called
+/// under lock of key's shard.
+/// @return true if element has been added, false if combined.
+template <typename K, typename V, typename H, typename M>
+template <typename F>
+bool ShardedHashtable<K, V, H, M>::upsert(const K& key, const V& value,
+                                          F combine) {
+  shard& target = shard_of(key);
+  std::unique_lock<std::mutex> lock(acquire(&target));
+  return target.m_table.upsert(key, value, combine);
+}
+
+/// @brief Reserves buckets of all shards for size elements.
+/// Every shard reserves for it's share and an eighth more: shards
+/// of random keys differ in size.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param size is an expected number of elements.
+/// @return nothing.
+template <typename K, typename V, typename H, typename M>
+void ShardedHashtable<K, V, H, M>::reserve(size_t size) {
+  size_t share = size/shard_count() + 1;
+  for (size_t i = 0; i < shard_count(); ++i) {
+    std::unique_lock<std::mutex> lock(acquire(&m_shards[i]));
+    m_shards[i].m_table.reserve(share + share/8);
+  }
+}
+
+/// @brief Visits all elements, shard after shard.
+/// Elements of a shard are visited in it's iteration order under
+/// it's lock, other shards may change meanwhile: elements added to
+/// or removed from them may or may not be visited.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @tparam F type of function void(const K&, V&).
+/// @param visit is called with key and value of every element, it
+/// must not use the table.
+/// @return nothing.
+template <typename K, typename V, typename H, typename M>
+template <typename F>
+void ShardedHashtable<K, V, H, M>::for_each(F visit) {
+  for (size_t i = 0; i < shard_count(); ++i) {
+    std::unique_lock<std::mutex> lock(acquire(&m_shards[i]));
+    for (auto& element : m_shards[i].m_table)
+      visit(element.key(), element.value());
+  }
+}
+
+/// @brief Gets a number of elements.
+/// Sum of shard sizes, each taken under it's lock: concurrent
+/// modifications may or may not be counted.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @return number of elements.
+template <typename K, typename V, typename H, typename M>
+size_t ShardedHashtable<K, V, H, M>::size() const {
+  size_t size = 0;
+  for (size_t i = 0; i < shard_count(); ++i) {
+    std::unique_lock<std::mutex> lock(m_shards[i].m_mutex);
+    size += m_shards[i].m_table.size();
+  }
+  return size;
+}
+
+/// @brief Gets counters of a shard.
+/// Reading counters isn't counted as an operation.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param shard_idx is a number of shard, less than shard_count().
+/// @return counters of the shard.
+template <typename K, typename V, typename H, typename M>
+typename ShardedHashtable<K, V, H, M>::shard_stats
+ShardedHashtable<K, V, H, M>::stats(size_t shard_idx) const {
+  const shard& target = m_shards[shard_idx];
+  std::unique_lock<std::mutex> lock(m_shards[shard_idx].m_mutex);
+  shard_stats result;
+  result.size = target.m_table.size();
+  result.bucket_count = target.m_table.bucket_count();
+  result.load_factor = target.m_table.load_factor();
+  result.operations = target.m_operations;
+  result.contended = target.m_contended;
+  return result;
+}
+
+/// @brief Prints counters of all shards.
+/// A line per shard: number, size, bucket count, load factor (%),
+/// operations and operations which waited for the shard.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param os is an output stream.
+/// @return nothing.
+template <typename K, typename V, typename H, typename M>
+void ShardedHashtable<K, V, H, M>::dump_stats(std::ostream& os) const {
+  os << "shard size buckets load% operations contended\n";
+  for (size_t i = 0; i < shard_count(); ++i) {
+    shard_stats counters = stats(i);
+    os << std::setw(5) << i << ' ' << counters.size << ' '
+       << counters.bucket_count << ' ' << counters.load_factor << ' '
+       << counters.operations << ' ' << counters.contended << '\n';
+  }
+}
+
+/// @brief Locks shard and counts the operation.
+/// Tries the lock first to count operations which wait for it.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam M type of bucket mapping.
+/// @param target is a shard to lock.
+/// @return lock of the shard.
+template <typename K, typename V, typename H, typename M>
+std::unique_lock<std::mutex> ShardedHashtable<K, V, H, M>::acquire(
+    shard* target) {
+  std::unique_lock<std::mutex> lock(target->m_mutex, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    lock.lock();
+    ++target->m_contended;
+  }
+  ++target->m_operations;
+  return lock;
+}
+
+}  // namespace esr
+
+#endif  // ESR_SHARDEDHASHTABLE_FLYMAKE_HPP_
@@ -0,0 +1,653 @@
+// Copyright 2016
+#ifndef ESR_STATICHASHTABLE_FLYMAKE_HPP_
+#define ESR_STATICHASHTABLE_FLYMAKE_HPP_
+////////////////////////////////////////////////////////////////////////////////
+// StaticHashtable <K, V>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <ostream>    // operator<<().
+#include <iomanip>    // operator<<().
+#include <cassert>    // assert().
+#include <cstdint>    // uint64_t, uint32_t.
+#include <cstring>    // std::memcpy().
+#include <algorithm>  // std::swap(), std::copy().
+#include <iterator>   // std::distance().
+#include <memory>     // std::unique_ptr.
+#include <utility>    // std::move().
+
+#include <esr/bitmap.hpp>      // Collisions of a level.
+#include <esr/hasher.hpp>      // Basic hash functions.
+#include <esr/hashtable.hpp>   // Keys no level places.
+#include <esr/hashexcept.hpp>  // Hashtable's specific exceptions.
+
+namespace esr {
+
+template <typename K, typename V, typename H>
+class StaticHashtable;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class staticentry.
+///
+/// @brief Element of StaticHashtable.
+/// Element contains key and value.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V>
+class staticentry {
+  template <typename KK, typename VV, typename HH>
+  friend class StaticHashtable;
+ public:
+  /// @brief Gets key.
+  /// Returns reference to key.
+  const K& key() const { return m_key; }
+
+  /// @brief Gets mutable value.
+  /// Returns reference to value.
+  V& value() { return m_value; }
+
+  /// @brief Gets immutable value.
+  /// Returns reference to value.
+  const V& value() const { return m_value; }
+
+  /// @brief Sets the value.
+  void set(const V& value) { m_value = value; }
+
+  /// @brief Printout element.
+  friend std::ostream & operator<<(std::ostream & os,
+                                  const staticentry<K, V>& entry) {
+    return os << entry.m_key <<"=>"<< entry.m_value;
+  }
+
+ private:
+  K m_key;
+  V m_value;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class StaticHashtable.
+///
+/// @brief Hashtable of a fixed key set built once by a minimal perfect
+/// hash function.
+/// Function maps n keys to distinct numbers 0..n-1 of element array,
+/// BBHash style: level 0 is an array of n bits, every key hashes to a
+/// bit, keys of bits hit once are placed and their bits set. Keys of
+/// colliding bits go to level 1 of as many bits as there are such
+/// keys, and so on. Number of a key is the number of set bits before
+/// it's bit, counted by 96 bit rank samples of every 512 bits. About
+/// 3.2 bits per key, lookup of a key reads bits of a level or two,
+/// then it's element: one probe and one key comparison. Keys no level
+/// places, e.g. of equal hash codes, are kept by a small Hashtable.
+/// Values may be set, keys can't be added or removed. Up to 2^32 keys.
+/// @tparam K type of hash key, must be default constructible.
+/// @tparam V type of hash value, must be default constructible.
+/// @tparam H type of hash function, see Hashtable.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V, typename H = hash_function<K>>
+class StaticHashtable {
+ public:
+  class iterator;
+
+  /// Default constructor, creates empty StaticHashtable.
+  StaticHashtable();
+
+  /// Constructor, builds StaticHashtable of a range of key, value pairs.
+  template <typename ForwardIt>
+  StaticHashtable(ForwardIt first, ForwardIt last);
+
+  /// Copy constructor, creates copy of StaticHashtable.
+  StaticHashtable(const StaticHashtable& other);
+
+  /// Destructor, deletes StaticHashtable.
+  virtual ~StaticHashtable();
+
+  /// Assignment operator.
+  StaticHashtable& operator=(StaticHashtable other);
+
+  /// Sets the value by key.
+  bool set(const K& key, const V& value);
+
+  /// Gets constant pointer to value by key.
+  const V* get(const K& key) const;
+
+  /// Checks if key is in table.
+  bool contains(const K& key) const { return lookup(key) != m_size; }
+
+  /// Finds a value by key.
+  iterator find(const K& key) { return iterator(this, lookup(key)); }
+
+  /// Gets a number of elements in table.
+  size_t size() const { return m_size; }
+
+  /// Gets a number of bits of hash function: levels and rank samples.
+  size_t metadata_bits() const {
+    return m_bit_count + m_rank_count*sizeof(uint32_t)*8;
+  }
+
+  /// Gets a number of levels.
+  size_t levels() const { return m_levels; }
+
+  /// Hashtable's printer.
+  template <typename KK, typename VV, typename HH>
+  friend std::ostream & operator<<(std::ostream & os,
+                                   const StaticHashtable<KK, VV, HH> & ht);
+
+  /// Forward iterator.
+  class iterator {
+   public:
+    /// @brief Creates StaticHashtable's iterator.
+    /// @param owner is a StaticHashtable object, owner of the iterator.
+    /// @param current_idx is a number of the current element.
+    explicit iterator(StaticHashtable* owner, size_t current_idx) :
+        m_owner(owner),
+        m_current_idx(current_idx) {}
+
+    /// Advances the iterator to the next element.
+    iterator& operator++() {
+      ++m_current_idx;
+      return *this;
+    }
+
+    /// Dereferenses an iterator.
+    staticentry<K, V>& operator*();
+
+    /// Dereferenses an iterator.
+    staticentry<K, V>* operator->() { return &**this; }
+
+    /// Inequality comparison of iterators.
+    bool operator!=(const iterator& rhs) {
+      return m_current_idx != rhs.m_current_idx;
+    }
+
+    /// Equality comparison of iterators.
+    bool operator==(const iterator& rhs) {
+      return m_current_idx == rhs.m_current_idx;
+    }
+
+   private:
+    /// Owner of the iterator.
+    StaticHashtable* m_owner;
+
+    /// Number of the current element, size of table for end iterator.
+    size_t m_current_idx;
+  };
+
+  /// Gets the beginning of StaticHashtable.
+  iterator begin() { return iterator(this, 0); }
+
+  /// Gets the end of StaticHashtable.
+  iterator end() { return iterator(this, m_size); }
+
+ private:
+  /// Maximal number of levels.
+  static const size_t m_MaxLevels = 32;
+
+  /// Number of words per rank sample.
+  static const size_t m_RankWords = 8;
+
+  /// Number of bits of a word.
+  static const size_t m_WordBits = 64;
+
+  /// Number of bits of a count of set bits of a rank sample.
+  static const size_t m_CountBits = 9;
+
+  /// Multiplier of level number which makes hash codes of levels differ.
+  static const uint64_t m_LevelSalt = 0x9e3779b97f4a7c15ULL;
+
+  /// Number of elements.
+  size_t m_size;
+
+  /// Hash function to get hash code of key.
+  H hash;
+
+  /// Element array, placed elements by their numbers, then the rest.
+  staticentry<K, V>* m_entries;
+
+  /// Number of levels.
+  size_t m_levels;
+
+  /// Numbers of the first bits of levels and the end of the last one.
+  uint64_t m_offsets[m_MaxLevels + 1];
+
+  /// Number of bits of all levels, a multiple of word size.
+  size_t m_bit_count;
+
+  /// Bits of all levels, set for placed keys.
+  uint64_t* m_words;
+
+  /// Number of 32 bit words of rank samples.
+  size_t m_rank_count;
+
+  /// Rank samples, three 32 bit words per m_RankWords words of bits:
+  /// number of set bits before them, then numbers of set bits of the
+  /// first one, two and up to seven of them, m_CountBits each.
+  uint32_t* m_ranks;
+
+  /// Keys no level places to their element numbers.
+  Hashtable<K, size_t, H> m_rest;
+
+  /// Gets bit of hash code of a level: high half of mixed code scaled
+  /// to the number of bits by multiplication rather than division.
+  static uint64_t position(uint64_t code, size_t level, uint64_t bit_count) {
+    return ((mix(code ^ (m_LevelSalt*level)) >> 32)*bit_count) >> 32;
+  }
+
+  /// Gets number of bit of hash code of a level among bits of all levels.
+  uint64_t bit_of(uint64_t code, size_t level) const {
+    return m_offsets[level] +
+        position(code, level, m_offsets[level + 1] - m_offsets[level]);
+  }
+
+  /// Checks if bit is set.
+  bool test(uint64_t bit_idx) const {
+    return (m_words[bit_idx/m_WordBits] >> (bit_idx % m_WordBits)) & 1;
+  }
+
+  /// Gets a number of set bits before a bit.
+  size_t rank(uint64_t bit_idx) const;
+
+  /// Gets a number of set bits of a word. Without popcnt instruction
+  /// counts bits by halves, nibbles and bytes rather than calls the
+  /// library.
+  static size_t ones(uint64_t word) {
+#ifdef __POPCNT__
+    return __builtin_popcountll(word);
+#else
+    word -= (word >> 1) & 0x5555555555555555ULL;
+    word = (word & 0x3333333333333333ULL) +
+        ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return (word*0x0101010101010101ULL) >> 56;
+#endif
+  }
+
+  /// Gets element number of key or size of table if no such key.
+  size_t lookup(const K& key) const;
+
+  /// Builds hash function and element array of a range.
+  template <typename ForwardIt>
+  void build(ForwardIt first, ForwardIt last);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V, typename H>
+const size_t StaticHashtable<K, V, H>::m_MaxLevels;
+template <typename K, typename V, typename H>
+const size_t StaticHashtable<K, V, H>::m_RankWords;
+template <typename K, typename V, typename H>
+const size_t StaticHashtable<K, V, H>::m_WordBits;
+template <typename K, typename V, typename H>
+const size_t StaticHashtable<K, V, H>::m_CountBits;
+template <typename K, typename V, typename H>
+const uint64_t StaticHashtable<K, V, H>::m_LevelSalt;
+
+////////////////////////////////////////////////////////////////////////////////
+// Constructors, Destructor and Assignment.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Default constructor for StaticHashtable.
+/// Creates StaticHashtable without elements.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @return nothing.
+template <typename K, typename V, typename H>
+StaticHashtable<K, V, H>::StaticHashtable() :
+    m_size(0),
+    hash(),
+    m_entries(nullptr),
+    m_levels(0),
+    m_offsets(),
+    m_bit_count(0),
+    m_words(nullptr),
+    m_rank_count(0),
+    m_ranks(nullptr),
+    m_rest() {}
+
+/// @brief Constructor for StaticHashtable of a range.
+/// Builds hash function of the keys of range, see build().
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam ForwardIt type of forward iterator to std::pair of key,
+/// value or alike.
+/// @param first is the beginning of the range.
+/// @param last is the end of the range.
+/// @return nothing.
+template <typename K, typename V, typename H>
+template <typename ForwardIt>
+StaticHashtable<K, V, H>::StaticHashtable(ForwardIt first, ForwardIt last) :
+    StaticHashtable() {
+  build(first, last);
+}
+
+/// @brief Copy constructor for StaticHashtable.
+/// Creates copy of existing StaticHashtable instance.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param other is an existing source StaticHashtable
+/// instance to be copied to target.
+/// @return nothing.
+template <typename K, typename V, typename H>
+StaticHashtable<K, V, H>::StaticHashtable(const StaticHashtable& other) :
+    StaticHashtable() {
+  std::unique_ptr<staticentry<K, V>[]> entries(
+      new staticentry<K, V>[other.m_size]);
+  std::copy(other.m_entries, other.m_entries + other.m_size, entries.get());
+  std::unique_ptr<uint64_t[]> words(
+      new uint64_t[other.m_bit_count/m_WordBits]);
+  std::copy(other.m_words, other.m_words + other.m_bit_count/m_WordBits,
+            words.get());
+  std::unique_ptr<uint32_t[]> ranks(new uint32_t[other.m_rank_count]);
+  std::copy(other.m_ranks, other.m_ranks + other.m_rank_count, ranks.get());
+  m_rest = other.m_rest;
+  hash = other.hash;
+  m_size = other.m_size;
+  m_levels = other.m_levels;
+  std::copy(other.m_offsets, other.m_offsets + m_MaxLevels + 1, m_offsets);
+  m_bit_count = other.m_bit_count;
+  m_rank_count = other.m_rank_count;
+  m_entries = entries.release();
+  m_words = words.release();
+  m_ranks = ranks.release();
+}
+
+/// @brief Assignment operator for StaticHashtable.
+/// Creates copy of existing StaticHashtable instance,
+/// cleaning up left-hand target.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param other is an existing source StaticHashtable
+/// instance to be copied to target.
+/// @return nothing.
+template <typename K, typename V, typename H>
+StaticHashtable<K, V, H>&
+StaticHashtable<K, V, H>::operator=(StaticHashtable other) {
+  std::swap(m_size, other.m_size);
+  std::swap(hash, other.hash);
+  std::swap(m_entries, other.m_entries);
+  std::swap(m_levels, other.m_levels);
+  std::swap(m_offsets, other.m_offsets);
+  std::swap(m_bit_count, other.m_bit_count);
+  std::swap(m_words, other.m_words);
+  std::swap(m_rank_count, other.m_rank_count);
+  std::swap(m_ranks, other.m_ranks);
+  m_rest.swap(other.m_rest);
+  return *this;
+}
+
+/// @brief Destructor for StaticHashtable.
+/// Removes content of StaticHashtable instance,
+/// deleting element array and bits of hash function.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @return nothing.
+template <typename K, typename V, typename H>
+StaticHashtable<K, V, H>::~StaticHashtable() {
+  delete [] m_entries;
+  delete [] m_words;
+  delete [] m_ranks;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Iterator.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Dereferenses an iterator.
+/// Provides access to StaticHashtable's element by it's reference.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @return reference to StaticHashtable's element.
+/// @throw end_iterator exception in attempt to dereferencing an
+/// end iterator.
+template <typename K, typename V, typename H>
+staticentry<K, V>& StaticHashtable<K, V, H>::iterator::operator*() {
+  if (m_current_idx >= m_owner->m_size)
+    throw exception::end_iterator(m_current_idx, __ESR_PRETTY_FUNCTION__);
+  return m_owner->m_entries[m_current_idx];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Accessors and Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Gets a number of set bits before a bit.
+/// Adds set bits of the words of rank sample before the bit's word,
+/// counted by the sample, and of the bit's word to the sample.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param bit_idx is a number of bit of all levels.
+/// @return number of set bits before the bit.
+template <typename K, typename V, typename H>
+size_t StaticHashtable<K, V, H>::rank(uint64_t bit_idx) const {
+  size_t word_idx = bit_idx/m_WordBits;
+  size_t word_in_sample = word_idx % m_RankWords;
+  const uint32_t* sample = m_ranks + 3*(word_idx/m_RankWords);
+  uint64_t counts;
+  std::memcpy(&counts, sample + 1, sizeof(counts));
+  size_t count = sample[0];
+  if (word_in_sample != 0) {
+    count += (counts >> (m_CountBits*(word_in_sample - 1))) &
+        ((uint64_t(1) << m_CountBits) - 1);
+  }
+  uint64_t below = (uint64_t(1) << (bit_idx % m_WordBits)) - 1;
+  return count + ones(m_words[word_idx] & below);
+}
+
+/// @brief Gets element number of key.
+/// Checks bit of key at every level until a set one, it's rank is
+/// the number of the only element to compare with the key. Keys of
+/// no set bit are looked up by the rest of keys, if any. Levels 0
+/// and 1 place most of keys, bits of both are checked without a
+/// branch between them, which would go either way at random.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param key is a key of element.
+/// @return element number or size of table if no such key.
+template <typename K, typename V, typename H>
+size_t StaticHashtable<K, V, H>::lookup(const K& key) const {
+  uint64_t code = hash(key);
+  uint64_t bit_idx = 0;
+  bool found = false;
+  size_t level = 0;
+  if (m_levels >= 2) {
+    uint64_t first_idx = bit_of(code, 0);
+    uint64_t second_idx = bit_of(code, 1);
+    bit_idx = test(first_idx) ? first_idx : second_idx;
+    found = test(bit_idx);
+    level = 2;
+  }
+  for (; !found && level < m_levels; ++level) {
+    bit_idx = bit_of(code, level);
+    found = test(bit_idx);
+  }
+  if (found) {
+    size_t idx = rank(bit_idx);
+    return m_entries[idx].m_key == key ? idx : m_size;
+  }
+  if (m_rest.size() == 0)
+    return m_size;
+  const size_t* idx = m_rest.get(key);
+  return idx == nullptr ? m_size : *idx;
+}
+
+/// @brief Set value.
+/// Provides write access to StaticHashtable's element by it's key.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param key is a key of element.
+/// @param value is a value of element.
+/// @return result of setting a value.
+/// @retval true on success.
+/// @retval false if no element with such key found in StaticHashtable.
+template <typename K, typename V, typename H>
+bool StaticHashtable<K, V, H>::set(const K& key, const V& value) {
+  size_t idx = lookup(key);
+  if (idx == m_size)
+    return false;
+  m_entries[idx].set(value);
+  return true;
+}
+
+/// @brief Gets value by it's key.
+/// Provides read access to StaticHashtable's element by it's key
+/// using pointer.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param key is a key of element in StaticHashtable.
+/// @return valid constant pointer to element in StaticHashtable or
+/// nullptr if no element with such key found in StaticHashtable.
+template <typename K, typename V, typename H>
+const V* StaticHashtable<K, V, H>::get(const K& key) const {
+  size_t idx = lookup(key);
+  return idx == m_size ? nullptr : &m_entries[idx].value();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Build.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Builds hash function and element array of a range.
+/// Hashes every key once. Every level hashes the remaining keys to
+/// as many bits, rounded up to a word, and marks the bits hit twice
+/// or more by a bitmap; keys of other bits are placed. Keys of
+/// m_MaxLevels levels of collisions go to the rest, the first of
+/// duplicate keys is kept. Then moves placed elements to the numbers
+/// of their bits and the rest after them.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @tparam ForwardIt type of forward iterator to std::pair of key,
+/// value or alike.
+/// @param first is the beginning of the range.
+/// @param last is the end of the range.
+/// @return nothing.
+template <typename K, typename V, typename H>
+template <typename ForwardIt>
+void StaticHashtable<K, V, H>::build(ForwardIt first, ForwardIt last) {
+  assert(m_size == 0);
+  size_t count = std::distance(first, last);
+  if (count == 0)
+    return;
+
+  std::unique_ptr<staticentry<K, V>[]> input(new staticentry<K, V>[count]);
+  std::unique_ptr<uint64_t[]> codes(new uint64_t[count]);
+  std::unique_ptr<uint64_t[]> bits(new uint64_t[count]);
+  std::unique_ptr<size_t[]> remaining(new size_t[count]);
+  size_t i = 0;
+  for (ForwardIt it = first; it != last; ++it, ++i) {
+    input[i].m_key = (*it).first;
+    input[i].m_value = (*it).second;
+    codes[i] = hash(input[i].m_key);
+    bits[i] = UINT64_MAX;  // not placed
+    remaining[i] = i;
+  }
+
+  // Places keys level by level
+  size_t left = count;
+  uint64_t bit_count = 0;
+  size_t levels = 0;
+  for (; left > 0 && levels < m_MaxLevels; ++levels) {
+    uint64_t level_bits = (left + m_WordBits - 1)/m_WordBits*m_WordBits;
+    bitmap hit(level_bits);
+    bitmap collided(level_bits);
+    for (size_t j = 0; j < left; ++j) {
+      uint64_t bit_idx = position(codes[remaining[j]], levels, level_bits);
+      if (hit.test(bit_idx))
+        collided.set(bit_idx);
+      else
+        hit.set(bit_idx);
+    }
+    size_t kept = 0;
+    for (size_t j = 0; j < left; ++j) {
+      size_t k = remaining[j];
+      uint64_t bit_idx = position(codes[k], levels, level_bits);
+      if (collided.test(bit_idx))
+        remaining[kept++] = k;
+      else
+        bits[k] = bit_count + bit_idx;
+    }
+    m_offsets[levels] = bit_count;
+    bit_count += level_bits;
+    left = kept;
+  }
+  m_offsets[levels] = bit_count;
+
+  // Sets bits of placed keys and counts rank samples
+  size_t word_count = bit_count/m_WordBits;
+  size_t sample_count = (word_count + m_RankWords - 1)/m_RankWords;
+  size_t rank_count = 3*sample_count;
+  std::unique_ptr<uint64_t[]> words(new uint64_t[word_count]());
+  std::unique_ptr<uint32_t[]> ranks(new uint32_t[rank_count]());
+  for (size_t k = 0; k < count; ++k)
+    if (bits[k] != UINT64_MAX)
+      words[bits[k]/m_WordBits] |= uint64_t(1) << (bits[k] % m_WordBits);
+  uint32_t total = 0;
+  for (size_t j = 0; j < sample_count; ++j) {
+    uint64_t counts = 0;
+    uint64_t in_sample = 0;
+    for (size_t w = 0; w < m_RankWords; ++w) {
+      if (w != 0)
+        counts |= in_sample << (m_CountBits*(w - 1));
+      if (j*m_RankWords + w < word_count)
+        in_sample += ones(words[j*m_RankWords + w]);
+    }
+    ranks[3*j] = total;
+    std::memcpy(&ranks[3*j + 1], &counts, sizeof(counts));
+    total += in_sample;
+  }
+  m_words = words.release();
+  m_ranks = ranks.release();
+  m_bit_count = bit_count;
+  m_rank_count = rank_count;
+  m_levels = levels;
+
+  // Moves elements to their numbers
+  std::unique_ptr<staticentry<K, V>[]> entries(new staticentry<K, V>[count]);
+  size_t placed = count - left;
+  for (size_t k = 0; k < count; ++k)
+    if (bits[k] != UINT64_MAX)
+      entries[rank(bits[k])] = std::move(input[k]);
+  size_t size = placed;
+  for (size_t j = 0; j < left; ++j) {
+    size_t k = remaining[j];
+    if (m_rest.add(input[k].m_key, size))
+      entries[size++] = std::move(input[k]);
+  }
+  m_entries = entries.release();
+  m_size = size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Printout.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Prints to output stream.
+/// Outputs the StaticHashtable's elements by their numbers.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @tparam H type of hash function.
+/// @param os is an output stream.
+/// @param htable is an StaticHashtable instance.
+/// @return reference to output stream.
+template <typename K, typename V, typename H>
+std::ostream & operator<<(std::ostream & os,
+                          const StaticHashtable<K, V, H> & htable) {
+  for (size_t i = 0; i < htable.m_size; ++i)
+    os << std::setw(3) << i << ": {(" << htable.m_entries[i] << ")}\n";
+  return os;
+}
+
+}  // namespace esr
+
+#endif  // ESR_STATICHASHTABLE_FLYMAKE_HPP_
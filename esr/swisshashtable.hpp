@@ -0,0 +1,704 @@
+// Copyright 2016
+#ifndef ESR_SWISSHASHTABLE_FLYMAKE_HPP_
+#define ESR_SWISSHASHTABLE_FLYMAKE_HPP_
+////////////////////////////////////////////////////////////////////////////////
+// SwissHashtable <K, V>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <ostream>    // operator<<().
+#include <iomanip>    // operator<<().
+#include <cassert>    // assert().
+#include <cstring>    // std::memset().
+#include <algorithm>  // std::swap().
+#include <memory>     // std::unique_ptr.
+#include <utility>    // std::move().
+
+#ifdef __SSE2__
+#include <emmintrin.h>  // _mm_cmpeq_epi8(), _mm_movemask_epi8().
+#endif
+
+#include <esr/hasher.hpp>      // Basic hash functions.
+#include <esr/hashexcept.hpp>  // Hashtable's specific exceptions.
+
+namespace esr {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class swissgroup.
+///
+/// @brief Group of control bytes.
+/// Control byte of a slot is either m_Empty, m_Deleted or 7 low bits
+/// of hash code of the key stored in the slot. Group answers which
+/// of it's 16 slots match a control byte with one vector compare.
+////////////////////////////////////////////////////////////////////////////////
+class swissgroup {
+ public:
+  /// Number of slots in a group.
+  static const size_t m_Width = 16;
+
+  /// Control byte of an empty slot.
+  static const int8_t m_Empty = -128;  // 0b10000000
+
+  /// Control byte of a slot which element has been removed.
+  static const int8_t m_Deleted = -2;  // 0b11111110
+
+  /// @brief Creates group.
+  /// @param ctrl is a pointer to the first of 16 control bytes.
+  explicit swissgroup(const int8_t* ctrl) {
+#ifdef __SSE2__
+    m_ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+    std::memcpy(m_ctrl, ctrl, m_Width);
+#endif
+  }
+
+  /// @brief Matches slots by hash tag.
+  /// @param h2 is 7 bits of hash code.
+  /// @return bit mask of slots with the control byte equal to h2.
+  uint32_t match(int8_t h2) const {
+#ifdef __SSE2__
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < m_Width; ++i)
+      mask |= static_cast<uint32_t>(m_ctrl[i] == h2) << i;
+    return mask;
+#endif
+  }
+
+  /// @brief Matches empty slots.
+  /// @return bit mask of empty slots.
+  uint32_t match_empty() const { return match(m_Empty); }
+
+  /// @brief Matches empty and deleted slots.
+  /// Both m_Empty and m_Deleted have the sign bit set, hash tags don't.
+  /// @return bit mask of slots available for insertion.
+  uint32_t match_empty_or_deleted() const {
+#ifdef __SSE2__
+    return _mm_movemask_epi8(m_ctrl);
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < m_Width; ++i)
+      mask |= static_cast<uint32_t>(m_ctrl[i] < 0) << i;
+    return mask;
+#endif
+  }
+
+  /// @brief Gets index of the lowest set bit.
+  /// @param mask is a not zero bit mask.
+  /// @return index of the lowest set bit.
+  static size_t lowest(uint32_t mask) {
+    assert(mask != 0);
+#ifdef __GNUC__
+    return __builtin_ctz(mask);
+#else
+    size_t idx = 0;
+    while ((mask & 1) == 0) {
+      mask >>= 1;
+      ++idx;
+    }
+    return idx;
+#endif
+  }
+
+ private:
+#ifdef __SSE2__
+  __m128i m_ctrl;
+#else
+  int8_t m_ctrl[m_Width];
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class swissentry.
+///
+/// @brief Slot of SwissHashtable.
+/// Slot contains key and value.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V>
+class swissentry {
+  template <typename KK, typename VV>
+  friend class SwissHashtable;
+ public:
+  /// @brief Gets key.
+  /// Returns reference to key.
+  const K& key() const { return m_key; }
+
+  /// @brief Gets mutable value.
+  /// Returns reference to value.
+  V& value() { return m_value; }
+
+  /// @brief Gets immutable value.
+  /// Returns reference to value.
+  const V& value() const { return m_value; }
+
+  /// @brief Sets the value.
+  void set(const V& value) { m_value = value; }
+
+  /// @brief Printout slot.
+  friend std::ostream & operator<<(std::ostream & os,
+                                  const swissentry<K, V>& entry) {
+    return os << entry.m_key <<"=>"<< entry.m_value;
+  }
+
+ private:
+  K m_key;
+  V m_value;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class SwissHashtable.
+///
+/// @brief Open addressing Hashtable with control bytes.
+/// Every slot has a control byte holding 7 bits of the key's hash
+/// code or empty/deleted state. Lookups probe groups of 16 control
+/// bytes at a time (SSE2 compare and movemask when available), so
+/// keys are compared only for slots with matching hash tag and a miss
+/// is usually answered by the first group containing an empty slot.
+/// Has the same interface as Hashtable.
+/// @tparam K type of hash key, must be default constructible.
+/// @tparam V type of hash value, must be default constructible.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V>
+class SwissHashtable {
+ public:
+  class iterator;
+
+  /// Default constructor, creates SwissHashtable.
+  SwissHashtable();
+
+  /// Copy constructor, creates copy of SwissHashtable.
+  SwissHashtable(const SwissHashtable& other);
+
+  /// Destructor, deletes SwissHashtable.
+  virtual ~SwissHashtable();
+
+  /// Assignment operator.
+  SwissHashtable& operator=(SwissHashtable other);
+
+  /// Adds key, value to hashtable.
+  bool add(const K& key, const V& value);
+
+  /// Removes key from hashtable.
+  void remove(const K& key);
+
+  /// Sets the value by key.
+  bool set(const K& key, const V& value);
+
+  /// Gets constant pointer to value by key.
+  const V* get(const K& key) const;
+
+  /// Finds a value by key.
+  iterator find(const K& key);
+
+  /// Gets a number of elements in hashtable.
+  size_t size() const { return m_size; }
+
+  /// Gets a number of occupied slots in percents.
+  size_t load_factor() const {
+    return (
+        (m_capacity == 0) ?
+        0 : (m_LoadFactor100Percents*m_size)/m_capacity);
+  }
+
+  /// Hashtable's printer.
+  template <typename KK, typename VV>
+  friend std::ostream & operator<<(std::ostream & os,
+                                   const SwissHashtable<KK, VV> & ht);
+
+  /// Forward iterator.
+  class iterator {
+   public:
+    /// @brief Creates SwissHashtable's iterator.
+    /// @param owner is a SwissHashtable object, owner of the iterator.
+    /// @param current_slot_idx is a number of the current slot
+    /// in slot array.
+    explicit iterator(SwissHashtable* owner, size_t current_slot_idx) :
+        m_owner(owner),
+        m_current_slot_idx(current_slot_idx) {}
+
+    /// Advances the iterator to the next element.
+    iterator& operator++();
+
+    /// Dereferenses an iterator.
+    swissentry<K, V>& operator*();
+
+    /// Dereferenses an iterator.
+    swissentry<K, V>* operator->();
+
+    /// Inequality comparison of iterators.
+    bool operator!=(const iterator& rhs) {
+      return m_current_slot_idx != rhs.m_current_slot_idx;
+    }
+
+    /// Equality comparison of iterators.
+    bool operator==(const iterator& rhs) {
+      return m_current_slot_idx == rhs.m_current_slot_idx;
+    }
+
+   private:
+    /// Owner of the iterator.
+    SwissHashtable* m_owner;
+
+    /// Number of the current slot in the slot array,
+    /// capacity for the end iterator.
+    size_t m_current_slot_idx;
+  };
+
+  /// Gets the beginning of SwissHashtable.
+  iterator begin();
+
+  /// Gets the end of SwissHashtable.
+  iterator end() { return iterator(this, m_capacity); }
+
+ private:
+  /// Number of elements in SwissHashtable.
+  uint64_t m_size;
+
+  /// Number of slots marked as deleted.
+  size_t m_deleted;
+
+  /// Hash function to get hash code of key.
+  hash_function<K> hash;
+
+  /// Number of slots, a power of two multiple of group width.
+  size_t m_capacity;
+
+  /// Control bytes, one per slot.
+  int8_t* m_ctrl;
+
+  /// Slot array.
+  swissentry<K, V>* m_slots;
+
+  /// Gets 7 bits of mixed hash code stored in control byte.
+  static int8_t h2(uint64_t code) { return code & 0x7F; }
+
+  /// Gets group where the probe sequence of mixed hash code starts.
+  size_t h1(uint64_t code) const {
+    return (code >> 7) & (m_capacity/swissgroup::m_Width - 1);
+  }
+
+  /// Gets index of the slot holding the key or capacity if none.
+  size_t lookup(const K& key) const {
+    return m_size == 0 ? m_capacity : lookup(key, mix(hash.code(key)));
+  }
+
+  /// Gets index of the slot holding the key of mixed hash code.
+  size_t lookup(const K& key, uint64_t code) const;
+
+  /// Gets index of the first available slot in probe sequence.
+  size_t find_available(uint64_t code) const;
+
+  /// Resizes slot array, to new size.
+  /// @param capacity is a size of resized slot array.
+  void resize(size_t capacity);
+
+  /// Load factor 100%.
+  static const size_t m_LoadFactor100Percents = 100;  // size == slots, 100%.
+
+  /// Maximum load factor, numerator of 7/8.
+  static const size_t m_MaxLoadNumerator = 7;
+
+  /// Maximum load factor, denominator of 7/8.
+  static const size_t m_MaxLoadDenominator = 8;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+template <typename K, typename V>
+const size_t SwissHashtable<K, V>::m_LoadFactor100Percents;
+template <typename K, typename V>
+const size_t SwissHashtable<K, V>::m_MaxLoadNumerator;
+template <typename K, typename V>
+const size_t SwissHashtable<K, V>::m_MaxLoadDenominator;
+
+////////////////////////////////////////////////////////////////////////////////
+// Constructors, Destructor and Assignment.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Default constructor for SwissHashtable.
+/// Creates empty SwissHashtable. No slot array is allocated
+/// until the first element is added.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @return nothing.
+template <typename K, typename V>
+SwissHashtable<K, V>::SwissHashtable() :
+    m_size(0),
+    m_deleted(0),
+    hash(),
+    m_capacity(0),
+    m_ctrl(nullptr),
+    m_slots(nullptr) {}
+
+/// @brief Copy constructor for SwissHashtable.
+/// Creates copy of existing SwissHashtable instance.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param other is an existing source SwissHashtable
+/// instance to be copied to target.
+/// @return nothing.
+template <typename K, typename V>
+SwissHashtable<K, V>::SwissHashtable(const SwissHashtable& other) :
+    m_size(other.m_size),
+    m_deleted(other.m_deleted),
+    hash(other.hash),
+    m_capacity(other.m_capacity),
+    m_ctrl(nullptr),
+    m_slots(nullptr) {
+  if (m_capacity == 0)
+    return;
+  std::unique_ptr<int8_t[]> ctrl(new int8_t[m_capacity]);
+  m_slots = new swissentry<K, V>[m_capacity];
+  m_ctrl = ctrl.release();
+  std::memcpy(m_ctrl, other.m_ctrl, m_capacity);
+  for (size_t i = 0; i < m_capacity; ++i)
+    if (m_ctrl[i] >= 0)
+      m_slots[i] = other.m_slots[i];
+}
+
+/// @brief Assignment operator for SwissHashtable.
+/// Creates copy of existing SwissHashtable instance,
+/// cleaning up left-hand target.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param other is an existing source SwissHashtable
+/// instance to be copied to target.
+/// @return nothing.
+template <typename K, typename V>
+SwissHashtable<K, V>& SwissHashtable<K, V>::operator=(SwissHashtable other) {
+  std::swap(m_size, other.m_size);
+  std::swap(m_deleted, other.m_deleted);
+  std::swap(hash, other.hash);
+  std::swap(m_capacity, other.m_capacity);
+  std::swap(m_ctrl, other.m_ctrl);
+  std::swap(m_slots, other.m_slots);
+  return *this;
+}
+
+/// @brief Destructor for SwissHashtable.
+/// Removes content of SwissHashtable instance,
+/// deleting control bytes and the slot array.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @return nothing.
+template <typename K, typename V>
+SwissHashtable<K, V>::~SwissHashtable() {
+  delete [] m_ctrl;
+  delete [] m_slots;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Iterator.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Advances the iterator to the next element.
+/// Searches for the next full slot in the slot array.
+/// Sets current slot index to capacity if SwissHashtable
+/// don't have full slots any more.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @return reference to iterator.
+template <typename K, typename V>
+typename SwissHashtable<K, V>::iterator&
+SwissHashtable<K, V>::iterator::operator++() {
+  size_t capacity = m_owner->m_capacity;
+  do {
+    ++m_current_slot_idx;
+  } while (m_current_slot_idx < capacity &&
+           m_owner->m_ctrl[m_current_slot_idx] < 0);
+  return *this;
+}
+
+/// @brief Dereferenses an iterator.
+/// Provides access to SwissHashtable's element by it's reference.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @return reference to SwissHashtable's element.
+/// @throw end_iterator exception in attempt to dereferencing an
+/// end iterator.
+template <typename K, typename V>
+swissentry<K, V>& SwissHashtable<K, V>::iterator::operator*() {
+  if (m_current_slot_idx >= m_owner->m_capacity)
+    throw exception::end_iterator(m_current_slot_idx,
+                                  __ESR_PRETTY_FUNCTION__);
+  return m_owner->m_slots[m_current_slot_idx];
+}
+
+/// @brief Dereferenses an iterator.
+/// Provides access to SwissHashtable's element by it's pointer.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @return pointer to SwissHashtable's element.
+/// @throw end_iterator exception in attempt to dereferencing an
+/// end iterator.
+template <typename K, typename V>
+swissentry<K, V>* SwissHashtable<K, V>::iterator::operator->() {
+  if (m_current_slot_idx >= m_owner->m_capacity)
+    throw exception::end_iterator(m_current_slot_idx,
+                                  __ESR_PRETTY_FUNCTION__);
+  return &m_owner->m_slots[m_current_slot_idx];
+}
+
+/// @brief Gets the beginning of SwissHashtable.
+/// Searches for the first full slot in the slot array.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @return iterator standing at the first element or end() iterator
+/// if SwissHashtable is empty.
+template <typename K, typename V>
+typename SwissHashtable<K, V>::iterator SwissHashtable<K, V>::begin() {
+  size_t first_full_slot_idx = 0;
+  while (first_full_slot_idx < m_capacity &&
+         m_ctrl[first_full_slot_idx] < 0)
+    ++first_full_slot_idx;
+  return iterator(this, first_full_slot_idx);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Accessors and Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Looks up a slot.
+/// Probes groups of slots starting from the group selected by
+/// hash code. Compares keys only in slots which control byte
+/// matches the hash tag. Stops at the first group having an
+/// empty slot.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param key is a key of element.
+/// @param code is a mixed hash code of the key.
+/// @return index of slot holding the key or capacity if no such key.
+template <typename K, typename V>
+size_t SwissHashtable<K, V>::lookup(const K& key, uint64_t code) const {
+  if (m_size == 0)
+    return m_capacity;
+
+  int8_t tag = h2(code);
+  size_t group_mask = m_capacity/swissgroup::m_Width - 1;
+  size_t group_idx = h1(code);
+  for (size_t step = 1; ; ++step) {
+    size_t first_slot_idx = group_idx*swissgroup::m_Width;
+    swissgroup group(m_ctrl + first_slot_idx);
+    for (uint32_t mask = group.match(tag); mask != 0; mask &= mask - 1) {
+      size_t slot_idx = first_slot_idx + swissgroup::lowest(mask);
+      if (m_slots[slot_idx].m_key == key)  // likely
+        return slot_idx;
+    }
+    if (group.match_empty() != 0)
+      return m_capacity;
+    assert(step <= group_mask + 1);
+    group_idx = (group_idx + step) & group_mask;  // triangular probing
+  }
+}
+
+/// @brief Finds an available slot.
+/// Probes groups of slots starting from the group selected by
+/// hash code, returns the first empty or deleted slot.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param code is a mixed hash code of a key.
+/// @return index of available slot.
+template <typename K, typename V>
+size_t SwissHashtable<K, V>::find_available(uint64_t code) const {
+  size_t group_mask = m_capacity/swissgroup::m_Width - 1;
+  size_t group_idx = h1(code);
+  for (size_t step = 1; ; ++step) {
+    size_t first_slot_idx = group_idx*swissgroup::m_Width;
+    uint32_t mask =
+        swissgroup(m_ctrl + first_slot_idx).match_empty_or_deleted();
+    if (mask != 0)
+      return first_slot_idx + swissgroup::lowest(mask);
+    assert(step <= group_mask + 1);
+    group_idx = (group_idx + step) & group_mask;
+  }
+}
+
+/// @brief Set value.
+/// Provides write access to SwissHashtable's element by it's key.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param key is a key of element.
+/// @param value is a value of element.
+/// @return result of setting a value.
+/// @retval true on success.
+/// @retval false if no element with such key found in SwissHashtable.
+template <typename K, typename V>
+bool SwissHashtable<K, V>::set(const K& key, const V& value) {
+  size_t slot_idx = lookup(key);
+  if (slot_idx == m_capacity)
+    return false;
+
+  m_slots[slot_idx].set(value);
+  return true;
+}
+
+/// @brief Gets value by it's key.
+/// Provides read access to SwissHashtable's element by it's key
+/// using pointer.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param key is a key of element in SwissHashtable.
+/// @return valid constant pointer to element in SwissHashtable or
+/// nullptr if no element with such key found in SwissHashtable.
+/// Pointer is invalidated by resize.
+template <typename K, typename V>
+const V* SwissHashtable<K, V>::get(const K& key) const {
+  size_t slot_idx = lookup(key);
+  if (slot_idx == m_capacity)
+    return nullptr;
+
+  return &m_slots[slot_idx].value();
+}
+
+/// @brief Gets value by it's key.
+/// Provides read access to SwissHashtable's element by it's key
+/// using iterator.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param key is a key to SwissHashtable's element.
+/// @return iterator to element if found, otherwise it returns
+/// an iterator to SwissHashtable::end.
+template <typename K, typename V>
+typename SwissHashtable<K, V>::iterator
+SwissHashtable<K, V>::find(const K& key) {
+  return iterator(this, lookup(key));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Isertion, Deletion; private: Resize.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Adds an element.
+/// Inserts an element to SwissHashtable. When full and deleted
+/// slots would exceed 7/8 of capacity, doubles the slot array,
+/// or rehashes it in place if most of them are deleted ones.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param key is a key to SwissHashtable's element.
+/// @param value is a value of SwissHashtable's element.
+/// @return result of insertion.
+/// @retval true if an element has been successfully inserted.
+/// @retval false if an element with such key is already in a
+/// SwissHashtable.
+template <typename K, typename V>
+bool SwissHashtable<K, V>::add(const K& key, const V& value) {
+  uint64_t code = mix(hash.code(key));
+  if (lookup(key, code) != m_capacity)
+    return false;  // dublicate keys
+
+  // first element
+  if (m_capacity == 0)
+    resize(swissgroup::m_Width);
+
+  // expand or drop deleted slots
+  if (m_MaxLoadDenominator*(m_size + m_deleted + 1) >
+      m_MaxLoadNumerator*m_capacity)  // unlikely
+    resize(2*m_size < m_capacity ? m_capacity : 2*m_capacity);
+
+  size_t slot_idx = find_available(code);
+  if (m_ctrl[slot_idx] == swissgroup::m_Deleted)
+    --m_deleted;
+  m_ctrl[slot_idx] = h2(code);
+  m_slots[slot_idx].m_key = key;
+  m_slots[slot_idx].m_value = value;
+  ++m_size;
+  return true;
+}
+
+/// @brief Removes an element.
+/// Removes an element from SwissHashtable. Marks the slot as empty
+/// if it's group has an empty slot, since no probe sequence went
+/// past that group; otherwise marks it as deleted. Deletes the slot
+/// array when SwissHashtable becomes empty.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param key is a key to SwissHashtable's element.
+/// @return nothing.
+template <typename K, typename V>
+void SwissHashtable<K, V>::remove(const K& key) {
+  size_t slot_idx = lookup(key);
+  if (slot_idx == m_capacity) return;  // no such key
+
+  size_t first_slot_idx = slot_idx - slot_idx % swissgroup::m_Width;
+  if (swissgroup(m_ctrl + first_slot_idx).match_empty() != 0) {
+    m_ctrl[slot_idx] = swissgroup::m_Empty;
+  } else {
+    m_ctrl[slot_idx] = swissgroup::m_Deleted;
+    ++m_deleted;
+  }
+  m_slots[slot_idx] = swissentry<K, V>();
+  --m_size;
+
+  if (m_size == 0)
+    resize(0);
+}
+
+/// @brief Resizes slot array.
+/// Creates new control bytes and slot array. Moves every element
+/// from source slot array to new slot array without duplicate
+/// checks. Deletes source arrays.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param capacity is a slot array size.
+/// @return nothing.
+template <typename K, typename V>
+void SwissHashtable<K, V>::resize(size_t capacity) {
+  assert(capacity % swissgroup::m_Width == 0);
+  int8_t* old_ctrl = m_ctrl;
+  swissentry<K, V>* old_slots = m_slots;
+  size_t old_capacity = m_capacity;
+  if (capacity != 0) {
+    std::unique_ptr<int8_t[]> ctrl(new int8_t[capacity]);
+    std::unique_ptr<swissentry<K, V>[]> slots(
+        new swissentry<K, V>[capacity]);
+    std::memset(ctrl.get(), swissgroup::m_Empty, capacity);
+    m_ctrl = ctrl.release();
+    m_slots = slots.release();
+  } else {
+    m_ctrl = nullptr;
+    m_slots = nullptr;
+  }
+  m_capacity = capacity;
+  m_deleted = 0;
+
+  for (size_t i = 0; i < old_capacity; ++i) {
+    if (old_ctrl[i] < 0)
+      continue;
+    uint64_t code = mix(hash.code(old_slots[i].m_key));
+    size_t slot_idx = find_available(code);
+    m_ctrl[slot_idx] = h2(code);
+    m_slots[slot_idx] = std::move(old_slots[i]);
+  }
+  delete [] old_ctrl;
+  delete [] old_slots;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Printout.
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Prints to output stream.
+/// Outputs the SwissHashtable's contents to output stream.
+/// @tparam K type of hash key.
+/// @tparam V type of hash value.
+/// @param os is an output stream.
+/// @param htable is an SwissHashtable instance.
+/// @return reference to output stream.
+template <typename K, typename V>
+std::ostream & operator<<(std::ostream & os,
+                          const SwissHashtable<K, V> & htable) {
+  for (size_t i = 0; i < htable.m_capacity; ++i) {
+    os << std::setw(3) << i << ": {";
+    if (htable.m_ctrl[i] >= 0)
+      os << '(' << htable.m_slots[i] << ')';
+    os << "}\n";
+  }
+  return os;
+}
+
+}  // namespace esr
+
+#endif  // ESR_SWISSHASHTABLE_FLYMAKE_HPP_
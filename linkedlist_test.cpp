@@ -1,5 +1,6 @@
 // Copyright 2016
 #include <iostream>
+#include <string>
 #include <esr/linkedlist.hpp>
 ////////////////////////////////////////////////////////////////////////////////
 // Linked List Tests
@@ -455,6 +456,118 @@ bool linkedlist_deletion_test(size_t size, bool verbose) {
   return true;
 }
 
+bool linkedlist_pool_test(size_t size, bool verbose) {
+  std::cout << "Pool test: " << std::flush;
+
+  esr::nodepool<esr::listnode<int, std::string>> pool;
+  {
+    esr::linkedlist<int, std::string> ll(&pool);
+    int key;
+
+    // Add
+    for (key = 0; key < size; ++key)
+      ll.push_back(key, std::to_string(key));
+    size_t block_count = pool.block_count();
+
+    if (verbose) {
+      std::cout << "\nlist<int, string> = { " << ll << "}\n"
+                << "blocks = " << block_count << '\n' << std::flush;
+    }
+
+    // Delete every other, then add them back: storage is reused
+    for (key = 0; key < size; key += 2)
+      ll.erase(key);
+    for (key = 0; key < size; key += 2)
+      ll.push_back(key, std::to_string(key));
+
+    if (pool.block_count() != block_count) {
+      std::cout << "<int,string> pool grew from " << block_count
+                << " to " << pool.block_count() << " blocks. "
+                << std::flush;
+      return false;
+    }
+
+    // Find and check
+    for (key = 0; key < size; ++key) {
+      const esr::listnode<int, std::string>* found = ll.find(key);
+      if (found == nullptr || found->value() != std::to_string(key)) {
+        std::cout << "<int,string> no value found for key = " << key
+                  << '\n' << std::flush;
+        return false;
+      }
+    }
+
+    // Copy takes nodes from heap and outlives the pool
+    esr::linkedlist<int, std::string> ll_copy(ll);
+    if (ll_copy.size() != ll.size()) {
+      std::cout << "<int,string> copy size = " << ll_copy.size()
+                << " doesn't match expected " << ll.size() << ". "
+                << std::flush;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool linkedlist_relink_test(size_t size, bool verbose) {
+  std::cout << "Relink test: " << std::flush;
+
+  esr::nodepool<esr::listnode<int, std::string>> pool;
+  esr::linkedlist<int, std::string> source(&pool);
+  esr::linkedlist<int, std::string> target(&pool);
+  int key;
+
+  for (key = 0; key < size; ++key)
+    source.push_back(key, std::to_string(key));
+  const esr::listnode<int, std::string>* first = source.find(0);
+
+  // Moves every node, node addresses are kept
+  while (esr::listnode<int, std::string>* node = source.unlink_front())
+    target.link_front(node);
+
+  if (verbose)
+    std::cout << "\nlist<int, string> = { " << target << "}\n" << std::flush;
+
+  if (!source.empty() || source.size() != 0 || target.size() != size) {
+    std::cout << "<int,string> sizes " << source.size() << ", "
+              << target.size() << " don't match expected 0, " << size
+              << ". " << std::flush;
+    return false;
+  }
+  if (target.find(0) != first) {
+    std::cout << "<int,string> node of key = 0 moved. " << std::flush;
+    return false;
+  }
+  for (key = 0; key < size; ++key) {
+    const esr::listnode<int, std::string>* found = target.find(key);
+    if (found == nullptr || found->value() != std::to_string(key)) {
+      std::cout << "<int,string> no value found for key = " << key
+                << '\n' << std::flush;
+      return false;
+    }
+  }
+
+  // Moves every node back to the back, order is kept
+  const esr::listnode<int, std::string>* last = target.front();
+  while (esr::listnode<int, std::string>* node = target.unlink_front())
+    source.link_back(node);
+  if (!target.empty() || source.size() != size || source.front() != last) {
+    std::cout << "<int,string> order of nodes linked to back changed. "
+              << std::flush;
+    return false;
+  }
+  while (esr::listnode<int, std::string>* node = source.unlink_front())
+    target.link_front(node);
+
+  // Emptied List is usable again
+  source.push_back(size, std::to_string(size));
+  if (source.size() != 1 || source.front()->key() != size) {
+    std::cout << "<int,string> emptied list is broken. " << std::flush;
+    return false;
+  }
+  return true;
+}
+
 bool fake_object_test() {
   std::cout << "Fake object test: " << std::flush;
 
@@ -487,6 +600,106 @@ bool fake_object_test() {
   return true;
 }
 
+bool linkedlist_code_test(size_t size, bool verbose) {
+  std::cout << "Hash code test: " << std::flush;
+
+  esr::hash_function<std::string> hash;
+  esr::linkedlist<std::string, int> ll;
+  int key;
+
+  for (key = 0; key < size; ++key)
+    ll.push_back(std::to_string(key), key, hash(std::to_string(key)));
+
+  if (verbose)
+    std::cout << "\nlist<string, int> = { " << ll << "}\n" << std::flush;
+
+  for (key = 0; key < size; ++key) {
+    std::string skey = std::to_string(key);
+    uint64_t code = hash(skey);
+    const esr::listnode<std::string, int>* found = ll.find(skey, code);
+    if (found == nullptr || found->value() != key ||
+        found->hash_code() != code) {
+      std::cout << "<string,int> no value found for key = " << key
+                << '\n' << std::flush;
+      return false;
+    }
+    // Node with different code is not compared by key
+    if (ll.find(skey, code + 1) != nullptr) {
+      std::cout << "<string,int> key = " << key
+                << " found by wrong code. " << std::flush;
+      return false;
+    }
+  }
+
+  // Copy keeps codes
+  esr::linkedlist<std::string, int> copy(ll);
+  for (key = 0; key < size; ++key) {
+    std::string skey = std::to_string(key);
+    if (copy.find(skey, hash(skey)) == nullptr) {
+      std::cout << "<string,int> copy lost code of key = " << key
+                << '\n' << std::flush;
+      return false;
+    }
+  }
+
+  // Erase checks code too
+  if (ll.erase("0", hash("0") + 1) || !ll.erase("0", hash("0")) ||
+      ll.size() != size - 1) {
+    std::cout << "<string,int> erase by code is broken. " << std::flush;
+    return false;
+  }
+  return true;
+}
+
+bool linkedlist_move_test(size_t size, bool verbose) {
+  std::cout << "Move test: " << std::flush;
+
+  esr::linkedlist<std::string, std::string> ll;
+  int key;
+
+  for (key = 0; key < size; ++key) {
+    std::string skey = std::to_string(key);
+    std::string value = std::to_string(-key);
+    if (key % 2 == 0) {
+      ll.push_back(std::move(skey), std::move(value));
+    } else if (ll.emplace_back(0, skey, size_t(key), '-') == nullptr) {
+      std::cout << "<string,string> failed to emplace key = " << key
+                << '\n' << std::flush;
+      return false;
+    }
+  }
+
+  if (verbose)
+    std::cout << "\nlist<string, string> = { " << ll << "}\n" << std::flush;
+
+  // Duplicate key is not moved
+  std::string skey = "0";
+  if (ll.emplace_back(0, std::move(skey), "0") != nullptr || skey != "0") {
+    std::cout << "<string,string> duplicate key moved. " << std::flush;
+    return false;
+  }
+
+  // Move steals nodes, source is left empty
+  esr::linkedlist<std::string, std::string> moved(std::move(ll));
+  if (ll.size() != 0 || ll.front() != nullptr || moved.size() != size) {
+    std::cout << "<string,string> move constructor copied. " << std::flush;
+    return false;
+  }
+  for (key = 0; key < size; ++key) {
+    const esr::listnode<std::string, std::string>* found =
+        moved.find(std::to_string(key));
+    std::string expect = key % 2 == 0 ? std::to_string(-key) :
+                         std::string(key, '-');
+    if (found == nullptr || found->value() != expect) {
+      std::cout << "<string,string> no value found for key = " << key
+                << '\n' << std::flush;
+      return false;
+    }
+  }
+  ll.push_back("0", "0");
+  return ll.size() == 1;
+}
+
 const int kLinkeListSize = 1024;
 
 int main(int argc, const char * argv[]) {
@@ -511,5 +724,21 @@ int main(int argc, const char * argv[]) {
     std::cout << "[FAILED]\n" << std::flush;
   else
     std::cout << "[PASSED]\n" << std::flush;
+  if (!linkedlist_pool_test(kLinkeListSize, false))
+    std::cout << "[FAILED]\n" << std::flush;
+  else
+    std::cout << "[PASSED]\n" << std::flush;
+  if (!linkedlist_relink_test(kLinkeListSize, false))
+    std::cout << "[FAILED]\n" << std::flush;
+  else
+    std::cout << "[PASSED]\n" << std::flush;
+  if (!linkedlist_code_test(kLinkeListSize, false))
+    std::cout << "[FAILED]\n" << std::flush;
+  else
+    std::cout << "[PASSED]\n" << std::flush;
+  if (!linkedlist_move_test(kLinkeListSize, false))
+    std::cout << "[FAILED]\n" << std::flush;
+  else
+    std::cout << "[PASSED]\n" << std::flush;
   return 0;
 }
@@ -1,17 +1,35 @@
 // Copyright 2016
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
 #include <ctime>
 #include <iostream>
 #include <fstream>
+#include <mutex>
+#include <random>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include <unordered_map>
 #include <esr/hashtable.hpp>
+#include <esr/concurrenthashtable.hpp>
+#include <esr/epochhashtable.hpp>
+#include <esr/shardedhashtable.hpp>
+#include <esr/flathashtable.hpp>
+#include <esr/swisshashtable.hpp>
+#include <esr/compacthashtable.hpp>
+#include <esr/mappedhashtable.hpp>
+#include <esr/statichashtable.hpp>
+#include <esr/literalhashtable.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Integer Keys Iserions and Retrievals
 ////////////////////////////////////////////////////////////////////////////////
-void insertion_to_Hashtable(esr::Hashtable<int, int>* table,
-                            size_t number_of_entries) {
+template <typename Table>
+void insertion_to_Hashtable(Table* table, size_t number_of_entries) {
   for (int i = 0; i < number_of_entries; ++i)
     table->add(i, i);
 }
@@ -22,8 +40,8 @@ void insertion_to_unordered_map(std::unordered_map<int, int>* map,
     map->insert(std::make_pair(i, i));
 }
 
-void retrieval_from_Hashtable(esr::Hashtable<int, int>* table,
-                              size_t number_of_entries) {
+template <typename Table>
+void retrieval_from_Hashtable(Table* table, size_t number_of_entries) {
   for (int i = 0; i < number_of_entries; ++i) {
     auto found = table->find(i);
     if (found == table->end())
@@ -40,10 +58,217 @@ void retrieval_from_unordered_map(std::unordered_map<int, int>* map,
   }
 }
 
+// Looks keys up one by one, in order of keys.
+template <typename Table>
+void retrieval_from_Hashtable(Table* table, const std::vector<int>& keys) {
+  for (int key : keys) {
+    auto found = table->find(key);
+    if (found == table->end())
+      std::cerr << "fail\n";
+  }
+}
+
+// Looks keys up by find_batch() of batch keys, in order of keys.
+template <typename Table>
+void batch_retrieval_from_Hashtable(Table* table, const std::vector<int>& keys,
+                                    size_t batch) {
+  std::vector<typename Table::iterator> found(batch, table->end());
+  for (size_t first = 0; first < keys.size(); first += batch) {
+    size_t count = std::min(batch, keys.size() - first);
+    table->find_batch(&keys[first], count, found.data());
+    for (int i = 0; i < count; ++i)
+      if (found[i] == table->end())
+        std::cerr << "fail\n";
+  }
+}
+
+// Keys [0, number_of_entries) are in table, looks up the next as many.
+template <typename Table>
+void failed_retrieval_from_Hashtable(Table* table, size_t number_of_entries) {
+  for (int i = number_of_entries; i < 2*number_of_entries; ++i) {
+    auto found = table->find(i);
+    if (found != table->end())
+      std::cerr << "fail\n";
+  }
+}
+
+void failed_retrieval_from_unordered_map(std::unordered_map<int, int>* map,
+                                         size_t number_of_entries) {
+  for (int i = number_of_entries; i < 2*number_of_entries; ++i) {
+    auto found = map->find(i);
+    if (found != map->end())
+      std::cerr << "fail\n";
+  }
+}
+
+// Keys are multiples of stride.
+template <typename Table>
+void strided_insertion_to_Hashtable(Table* table, size_t number_of_entries,
+                                    int stride) {
+  for (int i = 0; i < number_of_entries; ++i)
+    table->add(i*stride, i);
+}
+
+// Returns the longest single insertion, milliseconds of wall time.
+template <typename Table>
+double worst_insertion_to_Hashtable(Table* table, size_t number_of_entries) {
+  double worst = 0;
+  for (int i = 0; i < number_of_entries; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    table->add(i, i);
+    std::chrono::duration<double, std::milli> time =
+        std::chrono::steady_clock::now() - start;
+    worst = std::max(worst, time.count());
+  }
+  return worst;
+}
+
+// Keys [0, number_of_entries) are in table, removes and adds back
+// the last amplitude keys, rounds times.
+template <typename Table>
+void oscillation_in_Hashtable(Table* table, size_t number_of_entries,
+                              size_t amplitude, size_t rounds) {
+  for (int round = 0; round < rounds; ++round) {
+    for (int i = number_of_entries - amplitude; i < number_of_entries; ++i)
+      table->remove(i);
+    for (int i = number_of_entries - amplitude; i < number_of_entries; ++i)
+      table->add(i, i);
+  }
+}
+
+// Keys [0, number_of_entries) are in table, grows the bucket array to
+// fit size elements. Returns milliseconds of wall time: clock() adds
+// up time of resize threads.
+template <typename Table>
+double reserving_Hashtable(Table* table, size_t size) {
+  auto start = std::chrono::steady_clock::now();
+  table->reserve(size);
+  std::chrono::duration<double, std::milli> time =
+      std::chrono::steady_clock::now() - start;
+  return time.count();
+}
+
+// Iterates table rounds times, returns sum of values.
+template <typename Table>
+uint64_t iteration_over_Hashtable(Table* table, size_t rounds) {
+  uint64_t sum = 0;
+  for (size_t round = 0; round < rounds; ++round)
+    for (auto& element : *table)
+      sum += element.value();
+  return sum;
+}
+
+// Sums values of table by iterator, or by parallel_reduce() of all
+// hardware threads. Returns milliseconds of wall time.
+template <typename Table>
+double summing_Hashtable(Table* table, bool parallel, uint64_t* sum) {
+  auto start = std::chrono::steady_clock::now();
+  if (parallel) {
+    *sum = table->parallel_reduce(
+        uint64_t(0),
+        [](int, int value) { return uint64_t(value); },
+        [](uint64_t sum, uint64_t value) { return sum + value; });
+  } else {
+    *sum = 0;
+    for (auto& element : *table)
+      *sum += element.value();
+  }
+  std::chrono::duration<double, std::milli> time =
+      std::chrono::steady_clock::now() - start;
+  return time.count();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Integer Keys Shared by Threads
+////////////////////////////////////////////////////////////////////////////////
+
+// Hashtable behind one mutex, used as ConcurrentHashtable is.
+class locked_Hashtable {
+ public:
+  bool add(int key, int value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_table.add(key, value);
+  }
+  bool get(int key, int* value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const int* found = m_table.get(key);
+    if (found != nullptr)
+      *value = *found;
+    return found != nullptr;
+  }
+ private:
+  std::mutex m_mutex;
+  esr::Hashtable<int, int> m_table;
+};
+
+// Threads add their shares of keys [0, number_of_entries), every add
+// is followed by lookups of 4 keys of any thread. Returns milliseconds
+// of wall time: clock() adds up time of all threads.
+template <typename Table>
+double threaded_access_to_Hashtable(Table* table, size_t number_of_entries,
+                                    size_t threads) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([table, number_of_entries, threads, t]() {
+        int value;
+        for (size_t i = t; i < number_of_entries; i += threads) {
+          table->add(i, i);
+          for (size_t j = 1; j <= 4; ++j)
+            table->get((i*j*7919) % number_of_entries, &value);
+        }
+      });
+  }
+  for (auto& worker : workers)
+    worker.join();
+  std::chrono::duration<double, std::milli> time =
+      std::chrono::steady_clock::now() - start;
+  return time.count();
+}
+
+// Threads look up keys [0, number_of_entries) in random order while one
+// more thread adds keys from number_of_entries on, growing the table.
+// Returns milliseconds of wall time per lookup.
+template <typename Table>
+double reading_while_writing_to_Hashtable(Table* table,
+                                          size_t number_of_entries,
+                                          size_t readers) {
+  for (size_t i = 0; i < number_of_entries; ++i)
+    table->add(i, i);
+  std::vector<int> keys;
+  for (size_t key = 0; key < number_of_entries; ++key)
+    keys.push_back(key);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(number_of_entries));
+
+  std::atomic<size_t> reading(readers);
+  auto start = std::chrono::steady_clock::now();
+  std::thread writer([table, number_of_entries, &reading]() {
+      for (size_t i = number_of_entries; reading != 0; ++i)
+        table->add(i, i);
+    });
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < readers; ++t) {
+    workers.emplace_back([table, &keys, &reading]() {
+        int value;
+        for (int key : keys)
+          if (!table->get(key, &value))
+            std::cerr << "fail\n";
+        --reading;
+      });
+  }
+  for (auto& worker : workers)
+    worker.join();
+  std::chrono::duration<double, std::milli> time =
+      std::chrono::steady_clock::now() - start;
+  writer.join();
+  return time.count()/(readers*number_of_entries);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // String Keys Iserions and Retrievals
 ////////////////////////////////////////////////////////////////////////////////
-void insertion_to_Hashtable(esr::Hashtable<std::string, int>* table,
+template <typename Table>
+void insertion_to_Hashtable(Table* table,
                             const std::vector<std::string>& keys,
                             size_t number_of_entries) {
   for (int i = 0; i < number_of_entries; ++i)
@@ -57,7 +282,8 @@ void insertion_to_unordered_map(std::unordered_map<std::string, int>* map,
     map->insert(std::make_pair(keys[i], i));
 }
 
-void retrieval_from_Hashtable(esr::Hashtable<std::string, int>* table,
+template <typename Table>
+void retrieval_from_Hashtable(Table* table,
                               const std::vector<std::string>& keys,
                               size_t number_of_entries) {
   for (int i = 0; i < number_of_entries; ++i) {
@@ -102,9 +328,13 @@ int main(int argc, char *argv[]) {
   int n = 2;
 
   std::cout << "Integer Keys\n";
+  std::cout << "n HT_ADD UM_ADD HT_FIND UM_FIND FH_ADD FH_FIND "
+               "ST_ADD ST_FIND\n";
   for (int i = 0; i < 20; ++i, n += n) {
     esr::Hashtable<int, int>* table = new  esr::Hashtable<int, int>();
     std::unordered_map<int, int>* map = new std::unordered_map<int, int>();
+    auto* flat = new esr::FlatHashtable<int, int>();
+    auto* swiss = new esr::SwissHashtable<int, int>();
 
     std::cout << n << ' ';
 
@@ -130,13 +360,493 @@ int main(int argc, char *argv[]) {
     stopwatch.stop();
     std::cout << std::setw(8) << stopwatch.time()/n << ' ';
 
+    // Open addressing
+    stopwatch.start();
+    insertion_to_Hashtable(flat, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    retrieval_from_Hashtable(flat, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    // Control bytes
+    stopwatch.start();
+    insertion_to_Hashtable(swiss, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    retrieval_from_Hashtable(swiss, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    delete swiss;
+    delete flat;
     delete map;
     delete table;
 
     std::cout << '\n' << std::flush;
   }
 
+  std::cout << "Integer Keys, Failed Lookups\n";
+  std::cout << "n HT_MISS UM_MISS FH_MISS ST_MISS\n";
+  n = 2;
+  for (int i = 0; i < 20; ++i, n += n) {
+    esr::Hashtable<int, int> table;
+    std::unordered_map<int, int> map;
+    esr::FlatHashtable<int, int> flat;
+    esr::SwissHashtable<int, int> swiss;
+    insertion_to_Hashtable(&table, n);
+    insertion_to_unordered_map(&map, n);
+    insertion_to_Hashtable(&flat, n);
+    insertion_to_Hashtable(&swiss, n);
+
+    std::cout << n << ' ';
+
+    stopwatch.start();
+    failed_retrieval_from_Hashtable(&table, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << std::fixed << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    failed_retrieval_from_unordered_map(&map, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    failed_retrieval_from_Hashtable(&flat, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    failed_retrieval_from_Hashtable(&swiss, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    std::cout << '\n' << std::flush;
+  }
+
+  std::cout << "Integer Keys, Batched Lookups\n";
+  std::cout << "n HT_FIND HT_BATCH_32 HT_BATCH_256\n";
+  n = 2;
+  for (int i = 0; i < 23; ++i, n += n) {
+    esr::Hashtable<int, int> table;
+    insertion_to_Hashtable(&table, n);
+    std::vector<int> keys;  // random order, as requests come
+    for (int key = 0; key < n; ++key)
+      keys.push_back(key);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(n));
+
+    std::cout << n << ' ';
+
+    stopwatch.start();
+    retrieval_from_Hashtable(&table, keys);
+    stopwatch.stop();
+    std::cout << std::setw(8) << std::fixed << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    batch_retrieval_from_Hashtable(&table, keys, 32);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    batch_retrieval_from_Hashtable(&table, keys, 256);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    std::cout << '\n' << std::flush;
+  }
+
+  std::cout << "Integer Keys, Bucket Mapping\n";
+  std::cout << "n HT_ADD HT_FIND HT_MOD_ADD HT_MOD_FIND\n";
+  n = 2;
+  for (int i = 0; i < 20; ++i, n += n) {
+    esr::Hashtable<int, int> table;
+    esr::Hashtable<int, int, esr::hash_function<int>,
+                   esr::modulo_mapping> modulo;
+
+    std::cout << n << ' ';
+
+    stopwatch.start();
+    insertion_to_Hashtable(&table, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << std::fixed << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    retrieval_from_Hashtable(&table, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    insertion_to_Hashtable(&modulo, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    retrieval_from_Hashtable(&modulo, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    std::cout << '\n' << std::flush;
+  }
+
+  std::cout << "Integer Keys, Stride 1024\n";
+  std::cout << "n HT_ADD HT_MOD_ADD\n";
+  n = 2;
+  for (int i = 0; i < 15; ++i, n += n) {
+    esr::Hashtable<int, int> table;
+    esr::Hashtable<int, int, esr::hash_function<int>,
+                   esr::modulo_mapping> modulo;
+
+    std::cout << n << ' ';
+
+    stopwatch.start();
+    strided_insertion_to_Hashtable(&table, n, 1024);
+    stopwatch.stop();
+    std::cout << std::setw(8) << std::fixed << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    strided_insertion_to_Hashtable(&modulo, n, 1024);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    std::cout << '\n' << std::flush;
+  }
+
+  std::cout << "Integer Keys, Incremental Resize\n";
+  std::cout << "n HT_ADD HT_INC_ADD HT_WORST HT_INC_WORST\n";
+  n = 2;
+  for (int i = 0; i < 20; ++i, n += n) {
+    esr::Hashtable<int, int> table;
+    esr::Hashtable<int, int> incremental;
+    incremental.set_incremental_resize(true);
+
+    std::cout << n << ' ';
+
+    stopwatch.start();
+    insertion_to_Hashtable(&table, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << std::fixed << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    insertion_to_Hashtable(&incremental, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    esr::Hashtable<int, int> worst;
+    esr::Hashtable<int, int> incremental_worst;
+    incremental_worst.set_incremental_resize(true);
+    std::cout << std::setw(8) << worst_insertion_to_Hashtable(&worst, n) << ' ';
+    std::cout << std::setw(8)
+              << worst_insertion_to_Hashtable(&incremental_worst, n) << ' ';
+
+    std::cout << '\n' << std::flush;
+  }
+
+  std::cout << "Integer Keys, Bulk Load\n";
+  std::cout << "n HT_ADD HT_BULK HT_BULK_UNIQUE\n";
+  n = 2;
+  for (int i = 0; i < 20; ++i, n += n) {
+    std::vector<std::pair<int, int>> range;
+    for (int key = 0; key < n; ++key)
+      range.push_back(std::make_pair(key, key));
+
+    std::cout << n << ' ';
+
+    stopwatch.start();
+    esr::Hashtable<int, int> table;
+    for (auto& key_value : range)
+      table.add(key_value.first, key_value.second);
+    stopwatch.stop();
+    std::cout << std::setw(8) << std::fixed << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    esr::Hashtable<int, int> bulk(range.begin(), range.end());
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    esr::Hashtable<int, int> unique(range.begin(), range.end(), true);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    std::cout << '\n' << std::flush;
+  }
+
+  std::cout << "Integer Keys, Resize Thrash\n";
+  std::cout << "n HT_OSC HT_RES_OSC\n";
+  n = 2;
+  for (int i = 0; i < 20; ++i, n += n) {
+    // Table has just expanded, n/16 keys oscillate across the thresholds
+    size_t size = n + 1;
+    size_t amplitude = std::max(n/16, 1);
+    size_t rounds = 1024*1024/(2*amplitude);
+    esr::capacity_hint capacity(size);
+    esr::Hashtable<int, int> table;
+    esr::Hashtable<int, int> reserved(capacity);
+    insertion_to_Hashtable(&table, size);
+    insertion_to_Hashtable(&reserved, size);
+
+    std::cout << n << ' ';
+
+    stopwatch.start();
+    oscillation_in_Hashtable(&table, size, amplitude, rounds);
+    stopwatch.stop();
+    std::cout << std::setw(8) << std::fixed
+              << stopwatch.time()/(2*amplitude*rounds) << ' ';
+
+    stopwatch.start();
+    oscillation_in_Hashtable(&reserved, size, amplitude, rounds);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/(2*amplitude*rounds) << ' ';
+
+    std::cout << '\n' << std::flush;
+  }
+
+  std::cout << "Integer Keys, Threads\n";
+  std::cout << "threads HT_MUTEX CH SH\n";
+  n = 1 << 20;
+  size_t max_threads = std::max(std::thread::hardware_concurrency(), 2u);
+  for (size_t threads = 1; threads <= max_threads; threads += threads) {
+    locked_Hashtable locked;
+    esr::ConcurrentHashtable<int, int> concurrent;
+    esr::ShardedHashtable<int, int> sharded;
+
+    std::cout << threads << ' ';
+    std::cout << std::setw(8) << std::fixed
+              << threaded_access_to_Hashtable(&locked, n, threads)/n << ' ';
+    std::cout << std::setw(8)
+              << threaded_access_to_Hashtable(&concurrent, n, threads)/n
+              << ' ';
+    std::cout << std::setw(8)
+              << threaded_access_to_Hashtable(&sharded, n, threads)/n << ' ';
+
+    std::cout << '\n' << std::flush;
+  }
+
+  std::cout << "Integer Keys, Reads While Writing\n";
+  std::cout << "threads HT_MUTEX CH EH SH\n";
+  n = 1 << 18;
+  for (size_t threads = 1; threads <= max_threads; threads += threads) {
+    locked_Hashtable locked;
+    esr::ConcurrentHashtable<int, int> concurrent;
+    esr::EpochHashtable<int, int> epoch;
+    esr::ShardedHashtable<int, int> sharded;
+
+    std::cout << threads << ' ';
+    std::cout << std::setw(8) << std::fixed
+              << reading_while_writing_to_Hashtable(&locked, n, threads)
+              << ' ';
+    std::cout << std::setw(8)
+              << reading_while_writing_to_Hashtable(&concurrent, n, threads)
+              << ' ';
+    std::cout << std::setw(8)
+              << reading_while_writing_to_Hashtable(&epoch, n, threads)
+              << ' ';
+    std::cout << std::setw(8)
+              << reading_while_writing_to_Hashtable(&sharded, n, threads)
+              << ' ';
+
+    std::cout << '\n' << std::flush;
+  }
+
+  std::cout << "Integer Keys, Sparse Iteration\n";
+  std::cout << "n HT_ITER HT_SPARSE_ITER\n";
+  n = 1 << 10;
+  for (int i = 0; i < 11; ++i, n += n) {
+    // Reserved buckets stay when all but one of 64 keys are removed
+    esr::capacity_hint capacity(n);
+    esr::Hashtable<int, int> table(capacity);
+    insertion_to_Hashtable(&table, n);
+    size_t rounds = std::max((1 << 22)/n, 1);
+    uint64_t sum = 0;
+
+    std::cout << n << ' ';
+
+    stopwatch.start();
+    sum += iteration_over_Hashtable(&table, rounds);
+    stopwatch.stop();
+    std::cout << std::setw(8) << std::fixed
+              << stopwatch.time()/(n*rounds) << ' ';
+
+    for (int key = 0; key < n; ++key)
+      if (key % 64 != 0)
+        table.remove(key);
+    stopwatch.start();
+    sum += iteration_over_Hashtable(&table, rounds);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/(table.size()*rounds) << ' ';
+    if (sum == 0)
+      std::cerr << "fail\n";
+
+    std::cout << '\n' << std::flush;
+  }
+
+  std::cout << "Integer Keys, Compact Dict\n";
+  std::cout << "n HT_ADD CD_ADD HT_FIND CD_FIND HT_ITER CD_ITER\n";
+  n = 2;
+  for (int i = 0; i < 20; ++i, n += n) {
+    auto* table = new esr::Hashtable<int, int>();
+    auto* compact = new esr::CompactHashtable<int, int>();
+    size_t rounds = std::max((1 << 20)/n, 1);
+    uint64_t sum = 0;
+
+    std::cout << n << ' ';
+
+    stopwatch.start();
+    insertion_to_Hashtable(table, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << std::fixed << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    insertion_to_Hashtable(compact, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    retrieval_from_Hashtable(table, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    retrieval_from_Hashtable(compact, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    sum += iteration_over_Hashtable(table, rounds);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/(n*rounds) << ' ';
+
+    stopwatch.start();
+    sum += iteration_over_Hashtable(compact, rounds);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/(n*rounds) << ' ';
+    if (sum == 0)
+      std::cerr << "fail\n";
+
+    delete compact;
+    delete table;
+
+    std::cout << '\n' << std::flush;
+  }
+
+  std::cout << "Integer Keys, Snapshot\n";
+  std::cout << "n HT_ADD HT_SAVE HT_LOAD\n";
+  n = 2;
+  for (int i = 0; i < 20; ++i, n += n) {
+    esr::Hashtable<int, int> table;
+    esr::Hashtable<int, int> loaded;
+    std::stringstream snapshot;
+
+    std::cout << n << ' ';
+
+    stopwatch.start();
+    insertion_to_Hashtable(&table, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << std::fixed << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    table.save(snapshot);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    loaded.load(snapshot);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+    if (loaded.size() != table.size())
+      std::cerr << "fail\n";
+
+    std::cout << '\n' << std::flush;
+  }
+
+  std::cout << "Integer Keys, Static Table\n";
+  std::cout << "n HT_ADD PH_BUILD HT_FIND PH_FIND PH_BITS\n";
+  n = 2;
+  for (int i = 0; i < 20; ++i, n += n) {
+    esr::Hashtable<int, int> table;
+    std::vector<std::pair<int, int>> range;
+    std::vector<int> keys;  // random order, as requests come
+    for (int key = 0; key < n; ++key) {
+      range.push_back(std::make_pair(key, key));
+      keys.push_back(key);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(n));
+
+    std::cout << n << ' ';
+
+    stopwatch.start();
+    insertion_to_Hashtable(&table, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << std::fixed << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    esr::StaticHashtable<int, int> perfect(range.begin(), range.end());
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    retrieval_from_Hashtable(&table, keys);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    retrieval_from_Hashtable(&perfect, keys);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+    std::cout << std::setw(8)
+              << static_cast<double>(perfect.metadata_bits())/n << ' ';
+
+    std::cout << '\n' << std::flush;
+  }
+
+  std::cout << "Integer Keys, Parallel Resize\n";
+  std::cout << "n HT_RESIZE HT_PAR_RESIZE\n";
+  n = 1 << 16;
+  for (int i = 0; i < 7; ++i, n += n) {
+    // Both tables resize to 4 times as many buckets, one of them on the
+    // calling thread only
+    esr::Hashtable<int, int> table;
+    esr::Hashtable<int, int> parallel;
+    table.set_parallel_resize(SIZE_MAX);
+    parallel.set_parallel_resize(0, max_threads);
+    insertion_to_Hashtable(&table, n);
+    insertion_to_Hashtable(&parallel, n);
+
+    std::cout << n << ' ';
+    std::cout << std::setw(8) << std::fixed
+              << reserving_Hashtable(&table, 4*n)/n << ' ';
+    std::cout << std::setw(8) << reserving_Hashtable(&parallel, 4*n)/n << ' ';
+
+    std::cout << '\n' << std::flush;
+  }
+
+  std::cout << "Integer Keys, Parallel Scan\n";
+  std::cout << "n HT_SUM HT_PAR_SUM\n";
+  n = 1 << 16;
+  for (int i = 0; i < 7; ++i, n += n) {
+    esr::Hashtable<int, int> table;
+    insertion_to_Hashtable(&table, n);
+    uint64_t sum = 0;
+    uint64_t parallel_sum = 0;
+
+    std::cout << n << ' ';
+    std::cout << std::setw(8) << std::fixed
+              << summing_Hashtable(&table, false, &sum)/n << ' ';
+    std::cout << std::setw(8)
+              << summing_Hashtable(&table, true, &parallel_sum)/n << ' ';
+    if (sum != parallel_sum)
+      std::cerr << "fail\n";
+
+    std::cout << '\n' << std::flush;
+  }
+
   std::cout << "Fixed Length String Keys\n";
+  std::cout << "n HT_ADD UM_ADD HT_FIND UM_FIND FH_ADD FH_FIND "
+               "ST_ADD ST_FIND\n";
 
   std::ifstream file("./data/unique_strings.txt");
   if (!file.is_open()) {
@@ -157,6 +867,8 @@ int main(int argc, char *argv[]) {
 
     auto* table = new  esr::Hashtable<std::string, int>();
     auto* map = new std::unordered_map<std::string, int>();
+    auto* flat = new esr::FlatHashtable<std::string, int>();
+    auto* swiss = new esr::SwissHashtable<std::string, int>();
 
     std::cout << n << ' ';
 
@@ -182,13 +894,123 @@ int main(int argc, char *argv[]) {
     stopwatch.stop();
     std::cout << std::setw(8) << stopwatch.time()/n << ' ';
 
+    // Open addressing
+    stopwatch.start();
+    insertion_to_Hashtable(flat, keys, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    retrieval_from_Hashtable(flat, keys, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    // Control bytes
+    stopwatch.start();
+    insertion_to_Hashtable(swiss, keys, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    retrieval_from_Hashtable(swiss, keys, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    delete swiss;
+    delete flat;
     delete map;
     delete table;
 
     std::cout << '\n' << std::flush;
   }
 
+  std::cout << "String Keys, Mapped Table\n";
+  std::cout << "n HT_ADD MT_WRITE MT_OPEN HT_FIND MT_FIND\n";
+  n = 2;
+  for (int i = 0; i < 25 ; ++i, n += n) {
+    if (n > keys.size())
+      break;
+
+    const char* path = "./performance_test.table";
+    auto* table = new esr::Hashtable<std::string, int>();
+
+    std::cout << n << ' ';
+
+    stopwatch.start();
+    insertion_to_Hashtable(table, keys, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << std::fixed << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    esr::MappedHashtable<int>::write(*table, path);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    // Warm start: file is in page cache
+    stopwatch.start();
+    auto* mapped = new esr::MappedHashtable<int>(path);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    retrieval_from_Hashtable(table, keys, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    retrieval_from_Hashtable(mapped, keys, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    delete mapped;
+    delete table;
+    std::remove(path);
+
+    std::cout << '\n' << std::flush;
+  }
+
+  std::cout << "String Keys, Literal Table\n";
+  std::cout << "keys HT_FIND LT_FIND\n";
+  {
+    static constexpr auto literal = esr::make_literal_table<int>(
+        {{"auto", 0}, {"break", 1}, {"case", 2}, {"char", 3},
+         {"const", 4}, {"continue", 5}, {"default", 6}, {"do", 7},
+         {"double", 8}, {"else", 9}, {"enum", 10}, {"extern", 11},
+         {"float", 12}, {"for", 13}, {"goto", 14}, {"if", 15}});
+    std::vector<std::string> words;  // run time keys, nothing folds
+    esr::Hashtable<std::string, int> table;
+    for (size_t j = 0; j < literal.size(); ++j) {
+      words.push_back(std::string(literal.key(j)));
+      table.add(words.back(), literal.value(j));
+    }
+    size_t rounds = 1 << 16;
+    n = rounds*words.size();
+    int sum = 0;
+
+    std::cout << literal.size() << ' ';
+
+    stopwatch.start();
+    for (size_t r = 0; r < rounds; ++r)
+      for (auto& word : words)
+        sum += *table.get(word);
+    stopwatch.stop();
+    std::cout << std::setw(8) << std::fixed << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    for (size_t r = 0; r < rounds; ++r)
+      for (auto& word : words)
+        sum -= *literal.get(word);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+    if (sum != 0)
+      std::cerr << "fail\n";
+
+    std::cout << '\n' << std::flush;
+  }
+
   std::cout << "Variable Length String Keys\n";
+  std::cout << "key_size HT_ADD UM_ADD HT_FIND UM_FIND FH_ADD FH_FIND "
+               "ST_ADD ST_FIND\n";
 
   n = 2;
   for (int i = 0; i < 10; ++i) {
@@ -196,6 +1018,8 @@ int main(int argc, char *argv[]) {
 
     auto* table = new  esr::Hashtable<std::string, int>();
     auto* map = new std::unordered_map<std::string, int>();
+    auto* flat = new esr::FlatHashtable<std::string, int>();
+    auto* swiss = new esr::SwissHashtable<std::string, int>();
 
     size_t key_size = keys[0].size();
     std::cout << key_size << ' ';
@@ -222,6 +1046,30 @@ int main(int argc, char *argv[]) {
     stopwatch.stop();
     std::cout << std::setw(8) << stopwatch.time()/n << ' ';
 
+    // Open addressing
+    stopwatch.start();
+    insertion_to_Hashtable(flat, keys, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    retrieval_from_Hashtable(flat, keys, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    // Control bytes
+    stopwatch.start();
+    insertion_to_Hashtable(swiss, keys, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    stopwatch.start();
+    retrieval_from_Hashtable(swiss, keys, n);
+    stopwatch.stop();
+    std::cout << std::setw(8) << stopwatch.time()/n << ' ';
+
+    delete swiss;
+    delete flat;
     delete map;
     delete table;
 